@@ -253,6 +253,34 @@ def addCommonOptions(parser):
         help="restore from a simpoint checkpoint taken with " +
              "--take-simpoint-checkpoints")
 
+    # SMARTS sampling options
+    parser.add_option("--smarts-period", action="store", type="int",
+        default=None,
+        help="""Sample one detailed window every <N> instructions, warming
+                caches functionally with the atomic CPU in between (needs
+                --caches, or --ruby with --functional-warming)""")
+    parser.add_option("--smarts-warmup", action="store", type="int",
+        default=2000,
+        help="Detailed warmup instructions before each SMARTS window")
+    parser.add_option("--smarts-window", action="store", type="int",
+        default=1000,
+        help="Detailed instructions measured in each SMARTS window")
+    parser.add_option("--smarts-samples", action="store", type="int",
+        default=0,
+        help="Stop after <N> SMARTS windows (0: run to completion)")
+
+    # Fork sweep options
+    parser.add_option("--fork-sweep", action="append", type="string",
+        default=[],
+        help="""Sweep a network option in forked children sharing the
+                warmed state, as <option>=<v1>,<v2>,... (e.g.
+                interposer_link_width=32,64). Repeat for a cross product""")
+    parser.add_option("--fork-at", action="store", type="int", default=None,
+        help="Absolute tick to fork the sweep at (default: after the "
+             "CPU switch, or immediately)")
+    parser.add_option("--fork-jobs", action="store", type="int", default=1,
+        help="Number of sweep children running concurrently")
+
     # Checkpointing options
     ###Note that performing checkpointing via python script files will override
     ###checkpoint instructions built into binaries.
@@ -81,13 +81,15 @@ def setCPUClass(options):
         if options.restore_with_cpu != options.cpu_type:
             CPUClass = TmpClass
             TmpClass, test_mem_mode = getCPUClass(options.restore_with_cpu)
-    elif options.fast_forward:
+    elif options.fast_forward or options.smarts_period:
         CPUClass = TmpClass
         TmpClass = AtomicSimpleCPU
         test_mem_mode = 'atomic'
 
-    # Ruby only supports atomic accesses in noncaching mode
-    if test_mem_mode == 'atomic' and options.ruby:
+    # Ruby only supports atomic accesses in noncaching mode, unless its
+    # caches are warmed functionally
+    if test_mem_mode == 'atomic' and options.ruby and \
+            not getattr(options, 'functional_warming', False):
         warn("Memory mode will be changed to atomic_noncaching")
         test_mem_mode = 'atomic_noncaching'
 
@@ -178,7 +180,7 @@ def findCptDir(options, cptdir, testsys):
         simpoint_start_insts.append(warmup_length)
         simpoint_start_insts.append(warmup_length + interval_length)
         testsys.cpu[0].simpoint_start_insts = simpoint_start_insts
-        if testsys.switch_cpus != None:
+        if getattr(testsys, "switch_cpus", None) != None:
             testsys.switch_cpus[0].simpoint_start_insts = simpoint_start_insts
 
         print("Resuming from SimPoint", end=' ')
@@ -429,6 +431,146 @@ def repeatSwitch(testsys, repeat_switch_cpu_list, maxtick, switch_freq):
             exit_event = m5.simulate(maxtick - m5.curTick())
             return exit_event
 
+def smartsSample(options, testsys, switch_cpu_list, maxtick):
+    """SMARTS-style sampling: the atomic CPUs run between windows and keep
+    the caches warm, then every --smarts-period instructions the detailed
+    CPUs take over for --smarts-warmup instructions of pipeline warmup and
+    --smarts-window measured instructions. Instruction counts refer to the
+    first CPU. Each window gets its own stats dump, and the CPI (and the
+    Garnet packet latency, when present) is reported with a 95% confidence
+    interval over all windows."""
+
+    period = options.smarts_period
+    warmup = options.smarts_warmup
+    window = options.smarts_window
+    if warmup + window >= period:
+        fatal("--smarts-period must be larger than warmup plus window")
+
+    to_detailed = switch_cpu_list
+    to_atomic = [(new_cpu, old_cpu) for old_cpu, new_cpu in switch_cpu_list]
+    detailed_cpus = [new_cpu for old_cpu, new_cpu in switch_cpu_list]
+    clock = detailed_cpus[0].clk_domain.clock[0].getValue()
+
+    network = None
+    if hasattr(testsys, 'ruby') and \
+            isinstance(testsys.ruby.network, GarnetNetwork):
+        network = testsys.ruby.network
+
+    def runInsts(cpu, insts, cause):
+        cpu.scheduleInstStop(0, insts, cause)
+        exit_event = m5.simulate(maxtick - m5.curTick())
+        return exit_event, exit_event.getCause() == cause
+
+    cpi = []
+    latency = []
+    while True:
+        exit_event, ok = runInsts(to_detailed[0][0],
+                                  period - warmup - window, "smarts warming")
+        if not ok:
+            break
+
+        m5.switchCpus(testsys, to_detailed, verbose=False)
+        exit_event, ok = runInsts(detailed_cpus[0], warmup, "smarts warmup")
+        if not ok:
+            break
+
+        m5.stats.reset()
+        start_tick = m5.curTick()
+        start_insts = sum(cpu.totalInsts() for cpu in detailed_cpus)
+        if network:
+            start_pkts = network.getPacketsReceived()
+            start_lat = network.getPacketLatency()
+
+        exit_event, ok = runInsts(detailed_cpus[0], window, "smarts window")
+        if not ok:
+            break
+        m5.stats.dump()
+
+        insts = sum(cpu.totalInsts() for cpu in detailed_cpus) - start_insts
+        cycles = float(m5.curTick() - start_tick) / clock * \
+            len(detailed_cpus)
+        cpi.append(cycles / max(insts, 1))
+        if network:
+            pkts = network.getPacketsReceived() - start_pkts
+            if pkts:
+                lat = network.getPacketLatency() - start_lat
+                latency.append(lat / pkts / clock)
+
+        print("SMARTS window %d @ tick %d: CPI %.4f" %
+              (len(cpi), m5.curTick(), cpi[-1]))
+        m5.switchCpus(testsys, to_atomic, verbose=False)
+
+        if options.smarts_samples and len(cpi) >= options.smarts_samples:
+            break
+
+    def report(name, samples):
+        n = len(samples)
+        if n == 0:
+            return
+        mean = sum(samples) / n
+        if n > 1:
+            var = sum((x - mean) ** 2 for x in samples) / (n - 1)
+            half = 1.96 * (var / n) ** 0.5
+        else:
+            half = float('inf')
+        print("SMARTS %s: %.4f +/- %.4f (95%% confidence, %d windows)" %
+              (name, mean, half, n))
+
+    if len(cpi) < 30:
+        warn("Only %d SMARTS windows, the confidence intervals assume a "
+             "normal sample mean and may be optimistic" % len(cpi))
+    report("CPI", cpi)
+    report("network latency (cycles)", latency)
+    return exit_event
+
+def parseForkSweep(options):
+    from itertools import product
+    from network import Network
+
+    keys = []
+    values = []
+    for spec in options.fork_sweep:
+        key, sep, vals = spec.partition("=")
+        key = key.strip().replace("-", "_")
+        if not sep or not vals:
+            fatal("Bad --fork-sweep '%s', expected <option>=<v1>,<v2>,...",
+                  spec)
+        if key not in Network.runtime_overrides:
+            fatal("--fork-sweep: %s is not one of %s", key,
+                  ", ".join(Network.runtime_overrides))
+        keys.append(key)
+        values.append([int(v) for v in vals.split(",")])
+
+    points = []
+    for combo in product(*values):
+        name = ".".join("%s-%d" % (k, v) for k, v in zip(keys, combo))
+        points.append((name, dict(zip(keys, combo))))
+    return points
+
+def forkSweep(options, testsys, points):
+    from network import Network
+
+    if options.fork_at:
+        if options.fork_at < m5.curTick():
+            fatal("--fork-at %d is in the past (now %d)", options.fork_at,
+                  m5.curTick())
+        exit_event = m5.simulate(options.fork_at - m5.curTick())
+        if exit_event.getCause() != "simulate() limit reached":
+            fatal("Simulation ended before the sweep could fork: %s",
+                  exit_event.getCause())
+
+    print("Forking %d sweep points @ tick %d" % (len(points), m5.curTick()))
+    name, overrides = m5.forkSweep(points, options.fork_jobs)
+    if name is None:
+        failed = [n for n, code in sorted(overrides.items()) if code != 0]
+        for n in failed:
+            print("Sweep point %s failed" % n)
+        sys.exit(1 if failed else 0)
+
+    print("Sweep point %s" % name)
+    Network.apply_overrides(options, testsys.ruby.network, overrides)
+    m5.stats.reset()
+
 def run(options, root, testsys, cpu_class):
     if options.checkpoint_dir:
         cptdir = options.checkpoint_dir
@@ -449,6 +591,14 @@ def run(options, root, testsys, cpu_class):
     if options.repeat_switch and options.take_checkpoints:
         fatal("Can't specify both --repeat-switch and --take-checkpoints")
 
+    if options.smarts_period:
+        if options.fast_forward or options.standard_switch or \
+                options.repeat_switch or options.take_checkpoints:
+            fatal("--smarts-period can't be combined with other fast "
+                  "forwarding, switching or checkpointing options")
+        if options.ruby and not options.functional_warming:
+            fatal("--smarts-period with --ruby needs --functional-warming")
+
     np = options.num_cpus
     switch_cpus = None
 
@@ -598,6 +748,14 @@ def run(options, root, testsys, cpu_class):
     if options.take_simpoint_checkpoints != None:
         simpoints, interval_length = parseSimpointAnalysisFile(options, testsys)
 
+    sweep_points = None
+    if options.fork_sweep:
+        if not options.ruby:
+            fatal("--fork-sweep needs --ruby")
+        sweep_points = parseForkSweep(options)
+        # Forking requires that no sockets are listening
+        m5.disableAllListeners()
+
     checkpoint_dir = None
     if options.checkpoint_restore:
         cpt_starttick, checkpoint_dir = findCptDir(options, cptdir, testsys)
@@ -646,7 +804,7 @@ def run(options, root, testsys, cpu_class):
         fatal("Bad maxtick (%d) specified: " \
               "Checkpoint starts starts from tick: %d", maxtick, cpt_starttick)
 
-    if options.standard_switch or cpu_class:
+    if (options.standard_switch or cpu_class) and not options.smarts_period:
         if options.standard_switch:
             print("Switch at instruction count:%s" %
                     str(testsys.cpu[0].max_insts_any_thread))
@@ -676,6 +834,10 @@ def run(options, root, testsys, cpu_class):
                     (testsys.switch_cpus_1[0].max_insts_any_thread))
             m5.switchCpus(testsys, switch_cpu_list1)
 
+    # All children of a sweep share the state up to here
+    if sweep_points:
+        forkSweep(options, testsys, sweep_points)
+
     # If we're taking and restoring checkpoints, use checkpoint_dir
     # option only for finding the checkpoints to restore from.  This
     # lets us test checkpointing by restoring from one set of
@@ -703,6 +865,10 @@ def run(options, root, testsys, cpu_class):
     elif options.restore_simpoint_checkpoint != None:
         restoreSimpointCheckpoint()
 
+    # Sampled simulation with functionally warmed caches
+    elif options.smarts_period:
+        exit_event = smartsSample(options, testsys, switch_cpu_list, maxtick)
+
     else:
         if options.fast_forward:
             m5.stats.reset()
@@ -0,0 +1,134 @@
+# Copyright (c) 2019 Georgia Institute of Technology
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Benchmark for parallel (multi-eventq) simulation. Every partition is a
+# traffic generator and its own memory on a separate event queue, and
+# the partitions alternate between bursts of requests and idle periods,
+# staggered so that the load is uneven across threads at any time. Run
+# it with a range of partition counts, with and without
+# --adaptive-quantum, and compare host_seconds and the eventq barrier
+# wait stats of Root, or let util/eventq_scaling.py do the sweep.
+
+from __future__ import print_function
+
+import optparse
+import os
+import sys
+
+import m5
+from m5.objects import *
+from m5.util import convert, fatal
+
+parser = optparse.OptionParser()
+
+parser.add_option("-n", "--partitions", type="int", default=4,
+                  help="Number of partitions, one event queue each")
+parser.add_option("--quantum", type="string", default="100ns",
+                  help="Quantum, or lookahead with --adaptive-quantum")
+parser.add_option("--adaptive-quantum", action="store_true",
+                  help="Synchronize in adaptive windows")
+parser.add_option("--period", type="string", default="20us",
+                  help="Length of one burst plus idle cycle")
+parser.add_option("--duty", type="float", default=0.25,
+                  help="Fraction of each period a partition is busy")
+parser.add_option("--itt", type="string", default="2ns",
+                  help="Time between requests within a burst")
+parser.add_option("--mem-latency", type="string", default="30ns",
+                  help="Latency of each partition's memory")
+parser.add_option("--sim-time", type="string", default="1ms",
+                  help="Simulated time to run for")
+
+(options, args) = parser.parse_args()
+
+if args:
+    print("Error: script doesn't take any positional arguments")
+    sys.exit(1)
+
+if options.partitions < 1:
+    fatal("Need at least one partition")
+if not 0 < options.duty <= 1:
+    fatal("--duty must be in (0, 1]")
+
+m5.ticks.fixGlobalFrequency()
+ticks = lambda t: int(m5.ticks.fromSeconds(convert.toLatency(t)))
+
+period = ticks(options.period)
+busy = max(1, int(period * options.duty))
+idle = max(1, period - busy)
+itt = ticks(options.itt)
+
+part_size = 0x4000000 # 64MB per partition
+
+system = System()
+system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                   voltage_domain =
+                                   VoltageDomain(voltage = '1V'))
+system.mem_ranges = [AddrRange(part_size * options.partitions)]
+system.mmap_using_noreserve = True
+
+def tgen_config(part):
+    # Stagger the bursts of the partitions over the period. Transitions,
+    # periods and the read/write mix are all fixed, since the traffic
+    # generators of all threads share one random number generator.
+    base = part * part_size
+    path = os.path.join(m5.options.outdir, "tgen%d.cfg" % part)
+    with open(path, "w") as cfg:
+        print("STATE 0 %d IDLE" % (1 + period * part // options.partitions),
+              file=cfg)
+        print("STATE 1 %d LINEAR 100 %d %d 64 %d %d 0" %
+              (busy, base, base + part_size - 1, itt, itt), file=cfg)
+        print("STATE 2 %d IDLE" % idle, file=cfg)
+        print("INIT 0", file=cfg)
+        print("TRANSITION 0 1 1", file=cfg)
+        print("TRANSITION 1 2 1", file=cfg)
+        print("TRANSITION 2 1 1", file=cfg)
+    return path
+
+tgens = []
+mems = []
+for part in range(options.partitions):
+    tgen = TrafficGen(config_file = tgen_config(part), eventq_index = part)
+    mem = SimpleMemory(range = AddrRange(part * part_size,
+                                         size = part_size),
+                       latency = options.mem_latency,
+                       null = True, eventq_index = part)
+    tgen.port = mem.port
+    tgens.append(tgen)
+    mems.append(mem)
+
+system.tgens = tgens
+system.mems = mems
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+if options.partitions > 1:
+    root.sim_quantum = ticks(options.quantum)
+    root.sim_quantum_adaptive = bool(options.adaptive_quantum)
+
+m5.instantiate()
+
+exit_event = m5.simulate(ticks(options.sim_time))
+print("Exiting @ tick %i because %s" % (m5.curTick(), exit_event.getCause()))
@@ -31,8 +31,8 @@ from __future__ import print_function
 import m5
 from m5.objects import *
 from m5.defines import buildEnv
-from m5.util import addToPath
-import os, optparse, sys
+from m5.util import addToPath, convert
+import csv, os, optparse, sys
 
 addToPath('../')
 
@@ -82,6 +82,29 @@ parser.add_option("--inj-vnet", type="int", default=-1,
                         0 and 1 are 1-flit, 2 is 5-flit.\
                         Set to -1 to inject randomly in all vnets.")
 
+parser.add_option("--geometric-interarrival", action="store_true",
+                  default=False,
+                  help="Draw the cycles between injections from a geometric\
+                        distribution instead of a trial every cycle")
+
+parser.add_option("--sweep", type="string", default=None,
+                  metavar="START:STOP:STEP",
+                  help="Sweep the injection rate from START to STOP in one\
+                        run, stopping at saturation, and write the\
+                        latency-throughput curve to --sweep-csv")
+parser.add_option("--sweep-warmup-cycles", type="int", default=1000,
+                  help="Cycles before measuring each sweep point")
+parser.add_option("--sweep-measure-cycles", type="int", default=10000,
+                  help="Cycles measured per sweep point")
+parser.add_option("--sweep-drain-cycles", type="int", default=100000,
+                  help="Maximum cycles to drain the network after a point")
+parser.add_option("--saturation-factor", type="float", default=3.0,
+                  help="A point is saturated if its average latency exceeds\
+                        this multiple of the zero-load latency, or if less\
+                        than 90% of the offered load is accepted")
+parser.add_option("--sweep-csv", type="string", default="sweep.csv",
+                  help="Sweep output, in the output directory")
+
 #
 # Add the ruby specific and protocol specific options
 #
@@ -96,6 +119,19 @@ if args:
      sys.exit(1)
 
 
+if options.sweep:
+    try:
+        sweep = [float(x) for x in options.sweep.split(":")]
+        assert len(sweep) == 3 and sweep[2] > 0
+    except (ValueError, AssertionError):
+        print("Error: --sweep takes START:STOP:STEP")
+        sys.exit(1)
+    if options.network != "garnet2.0":
+        print("Error: --sweep needs --network=garnet2.0")
+        sys.exit(1)
+    # the sweep decides when to stop
+    options.sim_cycles = 2**31 - 1
+
 if options.inj_vnet > 2:
     print("Error: Injection vnet %d should be 0 (1-flit), 1 (1-flit) "
           "or 2 (5-flit) or -1 (random)" % (options.inj_vnet))
@@ -111,6 +147,7 @@ cpus = [ GarnetSyntheticTraffic(
                      inj_rate=options.injectionrate,
                      inj_vnet=options.inj_vnet,
                      precision=options.precision,
+                     geometric_interarrival=options.geometric_interarrival,
                      num_dest=options.num_dirs) \
          for i in xrange(options.num_cpus) ]
 
@@ -151,7 +188,101 @@ m5.ticks.setGlobalFrequency('1ns')
 # instantiate configuration
 m5.instantiate()
 
-# simulate until program terminates
-exit_event = m5.simulate(options.abs_max_tick)
-
-print('Exiting @ tick', m5.curTick(), 'because', exit_event.getCause())
+def run_sweep(options, testers, network, start, stop, step):
+    """Step the injection rate of all testers, measuring each point after
+    a warmup and draining the network before the next one."""
+    tester_period = m5.ticks.fromSeconds(
+        1.0 / convert.toFrequency(options.sys_clock))
+    network_period = m5.ticks.fromSeconds(
+        1.0 / convert.toFrequency(options.ruby_clock))
+
+    def run(cycles):
+        event = m5.simulate(cycles * tester_period)
+        if event.getCause() != "simulate() limit reached":
+            print("Sweep stopped @ tick", m5.curTick(), "because",
+                  event.getCause())
+            sys.exit(1)
+
+    def set_rate(rate):
+        for tester in testers:
+            tester.setInjectionRate(rate)
+
+    def drain():
+        set_rate(0)
+        cycles = 0
+        received = -1
+        while cycles < options.sweep_drain_cycles:
+            run(100)
+            cycles += 100
+            # packets may still wait in the controllers, so wait until
+            # nothing arrived for a while. The packet counts are reset
+            # with the stats, while packets injected before the reset
+            # were still in flight, so ask the network directly.
+            if network.getPacketsInFlight() == 0 and \
+               network.getPacketsReceived() == received:
+                return True
+            received = network.getPacketsReceived()
+        return False
+
+    csv_name = os.path.join(m5.options.outdir, options.sweep_csv)
+    with open(csv_name, "w") as f:
+        out = csv.writer(f)
+        out.writerow(["offered", "injected", "accepted", "avg_latency",
+                      "p50_latency", "p90_latency", "p99_latency",
+                      "p999_latency", "saturated"])
+
+        zero_load = None
+        nodes = len(testers)
+        rate = start
+        while rate <= stop + step / 2:
+            set_rate(rate)
+            run(options.sweep_warmup_cycles)
+
+            m5.stats.reset()
+            network.resetPacketLatencySamples()
+            injected = network.getPacketsInjected()
+            received = network.getPacketsReceived()
+            latency = network.getPacketLatency()
+
+            run(options.sweep_measure_cycles)
+
+            window = float(nodes * options.sweep_measure_cycles)
+            injected = (network.getPacketsInjected() - injected) / window
+            pkts = network.getPacketsReceived() - received
+            accepted = pkts / window
+            avg = 0.0
+            if pkts:
+                avg = (network.getPacketLatency() - latency) / pkts / \
+                    network_period
+            pcts = [ network.getPacketLatencyPercentile(p)
+                     for p in (50, 90, 99, 99.9) ]
+
+            if zero_load is None and pkts:
+                zero_load = avg
+            saturated = accepted < 0.9 * rate or \
+                (zero_load is not None and
+                 avg > options.saturation_factor * zero_load)
+
+            drained = drain()
+            saturated = saturated or not drained
+
+            out.writerow(["%g" % rate, "%.6f" % injected, "%.6f" % accepted,
+                          "%.2f" % avg] + [ "%d" % p for p in pcts ] +
+                         [int(saturated)])
+            f.flush()
+            print("Sweep: offered %g accepted %.4f latency %.2f%s" %
+                  (rate, accepted, avg, " (saturated)" if saturated else ""))
+
+            if saturated:
+                break
+            rate += step
+
+    print("Sweep written to", csv_name)
+
+if options.sweep:
+    run_sweep(options, cpus, system.ruby.network, *sweep)
+else:
+    # simulate until program terminates
+    exit_event = m5.simulate(options.abs_max_tick)
+
+    print('Exiting @ tick', m5.curTick(), 'because', exit_event.getCause())
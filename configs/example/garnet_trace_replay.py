@@ -0,0 +1,107 @@
+# Copyright (c) 2019 Georgia Institute of Technology
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Network-only replay of a trace recorded with --network-trace-capture.
+# The Ruby system is built from the same options as the captured run, so
+# the network interfaces match, but no CPUs are attached: a
+# GarnetTraceReplay tester injects the recorded messages straight into
+# the network interfaces, holding back each dependent message until the
+# message it depends on has been delivered.
+#
+# Example:
+#   build/RISCV/gem5.opt configs/example/se.py --ruby --network=garnet2.0 \
+#       --topology=CHIPS_Multicore_MemCtrlChiplet4 --num-cpus=16 ... \
+#       --network-trace-capture=net.trace
+#   build/RISCV/gem5.opt configs/example/garnet_trace_replay.py \
+#       --network=garnet2.0 --topology=CHIPS_Multicore_MemCtrlChiplet4 \
+#       --num-cpus=16 ... --trace=m5out/net.trace --link-latency=2
+
+from __future__ import print_function
+
+import m5
+from m5.objects import *
+from m5.util import addToPath
+import os, optparse, sys
+
+addToPath('../')
+
+from common import Options
+from ruby import Ruby
+
+config_path = os.path.dirname(os.path.abspath(__file__))
+config_root = os.path.dirname(config_path)
+
+parser = optparse.OptionParser()
+Options.addNoISAOptions(parser)
+
+parser.add_option("--trace", type="string", default=None,
+                  help="Network trace to replay")
+parser.add_option("--no-dependencies", action="store_true", default=False,
+                  help="Inject every message at its recorded cycle")
+
+Ruby.define_options(parser)
+
+execfile(os.path.join(config_root, "common", "Options.py"))
+
+(options, args) = parser.parse_args()
+
+if args:
+    print("Error: script doesn't take any positional arguments")
+    sys.exit(1)
+
+if not options.trace:
+    print("Error: --trace is required")
+    sys.exit(1)
+
+if options.network != "garnet2.0":
+    print("Error: trace replay needs --network=garnet2.0")
+    sys.exit(1)
+
+system = System(mem_ranges = [AddrRange(options.mem_size)])
+
+system.voltage_domain = VoltageDomain(voltage = options.sys_voltage)
+system.clk_domain = SrcClockDomain(clock = options.sys_clock,
+                                   voltage_domain = system.voltage_domain)
+
+Ruby.create_system(options, False, system)
+
+system.ruby.clk_domain = SrcClockDomain(clock = options.ruby_clock,
+                                        voltage_domain = system.voltage_domain)
+
+# Count cycles in the clock of the network, like the capture did
+system.replay = GarnetTraceReplay(trace_file = options.trace,
+                                  network = system.ruby.network,
+                                  dependencies = not options.no_dependencies,
+                                  clk_domain = system.ruby.clk_domain)
+
+root = Root(full_system = False, system = system)
+root.system.mem_mode = 'timing'
+
+m5.instantiate()
+
+exit_event = m5.simulate(options.abs_max_tick)
+
+print('Exiting @ tick', m5.curTick(), 'because', exit_event.getCause())
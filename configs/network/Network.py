@@ -30,6 +30,7 @@ import math
 import m5
 from m5.objects import *
 from m5.defines import buildEnv
+from m5.proxy import isproxy
 from m5.util import addToPath, fatal
 
 def define_options(parser):
@@ -74,6 +75,23 @@ def define_options(parser):
                       help="delay due to chiplet logical protocol interface")
     parser.add_option("--clip-phys-ifc-delay", action="store", type="int", default=1,
                       help="delay due to chiplet physical interface")
+    parser.add_option("--chiplet-clock", action="store", type="string",
+                      default="",
+                      help="""clock of the routers of each chiplet, one
+                            clock or a comma separated list by chiplet.
+                            Can be over-ridden on a per router basis
+                            in the topology file.""")
+    parser.add_option("--interposer-clock", action="store", type="string",
+                      default="",
+                      help="clock of the links with CLIP at both ends")
+    parser.add_option("--cdc-sync-latency", action="store", type="int",
+                      default=2,
+                      help="""synchronizer latency of the clock domain
+                            crossing FIFOs, in cycles of the receiving
+                            clock""")
+    parser.add_option("--cdc-fifo-depth", action="store", type="int",
+                      default=8,
+                      help="entries in the clock domain crossing FIFOs")
     parser.add_option("--vcs-per-vnet", action="store", type="int", default=4,
                       help="""number of virtual channels per virtual network
                             inside garnet network.""")
@@ -81,6 +99,20 @@ def define_options(parser):
                       help="number of buffers in each ctrl VC.")
     parser.add_option("--buffers-per-data-vc", action="store", type="int", default=32,
                       help="number of buffers in each data VC.")
+    parser.add_option("--router-bypass", action="store_true",
+                      default=False,
+                      help="""let flits arriving at an idle input port skip
+                            the router pipeline. Needs a --router-latency
+                            above the bypass, 1 cycle with lookahead
+                            routing and 2 without""")
+    parser.add_option("--no-lookahead-routing", action="store_false",
+                      dest="lookahead_routing", default=True,
+                      help="""compute routes in their own pipeline stage,
+                            so bypassing flits take two cycles""")
+    parser.add_option("--express-link-hops", action="store", type="int",
+                      default=0,
+                      help="""routers spanned by the express links of
+                            topologies that support them, 0 disables""")
     parser.add_option("--routing-algorithm", action="store", type="int",
                       default=0,
                       help="""routing algorithm in network.
@@ -94,6 +126,28 @@ def define_options(parser):
     parser.add_option("--garnet-deadlock-threshold", action="store",
                       type="int", default=50000,
                       help="network-level deadlock threshold.")
+    parser.add_option("--network-trace-capture", action="store",
+                      type="string", default="",
+                      help="""record the injected messages in this file of
+                            the output directory, for replay with
+                            configs/example/garnet_trace_replay.py""")
+    parser.add_option("--network-trace-dep-window", action="store",
+                      type="int", default=1000,
+                      help="""cycles after receiving a message for a line
+                            in which messages a node sends for it are
+                            recorded as depending on it""")
+    parser.add_option("--network-telemetry", action="store",
+                      type="string", default="",
+                      help="""sample router and link activity into this
+                            file of the output directory, for
+                            util/garnet_heatmap.py""")
+    parser.add_option("--network-telemetry-interval", action="store",
+                      type="int", default=1000,
+                      help="cycles between network telemetry samples")
+    parser.add_option("--network-energy", type="choice", default=None,
+                      choices=['45nm', '22nm', '14nm'],
+                      help="""estimate router, link and CLIP energy with
+                            the model for this technology""")
 
 
 def create_network(options, ruby):
@@ -120,6 +174,108 @@ def create_network(options, ruby):
 
     return (network, IntLinkClass, ExtLinkClass, RouterClass, InterfaceClass)
 
+def chiplets_of(network):
+    # Routers connected by links without CLIP at both ends are on the same
+    # chiplet, number the chiplets in the order of their lowest router
+    chiplet = [r.router_id for r in network.routers]
+
+    def find(r):
+        while chiplet[r] != r:
+            chiplet[r] = chiplet[chiplet[r]]
+            r = chiplet[r]
+        return r
+
+    for intLink in network.int_links:
+        if intLink.tx_clip and intLink.rx_clip:
+            continue
+        src = find(intLink.src_node.router_id)
+        dst = find(intLink.dst_node.router_id)
+        chiplet[max(src, dst)] = min(src, dst)
+
+    ids = {}
+    for r in range(len(chiplet)):
+        ids.setdefault(find(r), len(ids))
+    return [ids[find(r)] for r in range(len(chiplet))]
+
+def clock_domain_of(obj):
+    # None for objects clocked by the network
+    domain = obj.clk_domain
+    return None if isproxy(domain) else domain
+
+def clock_period_of(domain):
+    # Period of a domain with a single source clock, as (ticks, value)
+    # of the clock, None if it is not known before instantiation
+    if not isinstance(domain, SrcClockDomain) or len(domain.clock) != 1:
+        return None
+    clock = domain.clock[0]
+    return clock.ticks, clock.value
+
+def same_clock(a, b):
+    # Domains known to run at the same clock period
+    if a is b:
+        return True
+    pa = clock_period_of(a)
+    pb = clock_period_of(b)
+    if pa is None or pb is None or pa[0] != pb[0]:
+        return False
+    return abs(pa[1] - pb[1]) <= 1e-9 * max(pa[1], pb[1])
+
+def init_clock_domains(options, network, chiplets):
+    if options.chiplet_clock or options.interposer_clock:
+        network.noc_voltage_domain = VoltageDomain()
+
+    # Each chiplet runs in its own domain even at the same clock
+    if options.chiplet_clock:
+        clocks = options.chiplet_clock.split(',')
+        num_chiplets = max(chiplets) + 1
+        if len(clocks) != 1 and len(clocks) != num_chiplets:
+            fatal("--chiplet-clock needs one clock or %d", num_chiplets)
+        network.chiplet_clk_domains = [SrcClockDomain(
+            clock = clocks[c % len(clocks)],
+            voltage_domain = network.noc_voltage_domain)
+            for c in range(num_chiplets)]
+        for router in network.routers:
+            if clock_domain_of(router) is None:
+                router.clk_domain = \
+                    network.chiplet_clk_domains[chiplets[router.router_id]]
+
+    interposer = None
+    if options.interposer_clock:
+        network.interposer_clk_domain = SrcClockDomain(
+            clock = options.interposer_clock,
+            voltage_domain = network.noc_voltage_domain)
+        interposer = network.interposer_clk_domain
+
+    # Links run in the clock of their source router, or of the interposer,
+    # and cross into another domain through the CLIP FIFOs
+    for intLink in network.int_links:
+        src = clock_domain_of(intLink.src_node)
+        dst = clock_domain_of(intLink.dst_node)
+        domain = src
+        if interposer is not None and intLink.tx_clip and intLink.rx_clip:
+            domain = interposer
+        if domain is not None:
+            intLink.network_link.clk_domain = domain
+            intLink.credit_link.clk_domain = domain
+        intLink.tx_cdc = intLink.tx_cdc or domain is not src
+        intLink.rx_cdc = intLink.rx_cdc or domain is not dst
+
+    # External links of routers in their own domain run in the clock of
+    # the router. The NIs run in the clock of their controllers, e.g. an
+    # L1 in the CPU clock, and cross into the link clock where the
+    # periods differ. Links of routers in the network clock keep the
+    # timing of the NIs as they are.
+    for extLink in network.ext_links:
+        domain = clock_domain_of(extLink.int_node)
+        if domain is None:
+            continue
+        for link in extLink.network_links:
+            link.clk_domain = domain
+        for link in extLink.credit_links:
+            link.clk_domain = domain
+        nic = clock_domain_of(extLink.ext_node) or clock_domain_of(network)
+        extLink.nic_cdc = extLink.nic_cdc or not same_clock(nic, domain)
+
 def init_network(options, network, InterfaceClass):
 
     if options.network == "garnet2.0":
@@ -130,6 +286,28 @@ def init_network(options, network, InterfaceClass):
         network.ni_flit_size = options.chiplet_link_width
         network.routing_algorithm = options.routing_algorithm
         network.garnet_deadlock_threshold = options.garnet_deadlock_threshold
+        network.trace_capture = options.network_trace_capture
+        network.trace_dep_window = options.network_trace_dep_window
+        network.telemetry_file = options.network_telemetry
+        network.telemetry_interval = options.network_telemetry_interval
+        if options.network_energy:
+            network.energy_model = {
+                '45nm': GarnetEnergy45nm,
+                '22nm': GarnetEnergy22nm,
+                '14nm': GarnetEnergy14nm,
+            }[options.network_energy]()
+        chiplets = chiplets_of(network)
+        network.router_chiplets = chiplets
+        network.cdc_sync_latency = options.cdc_sync_latency
+        network.cdc_fifo_depth = options.cdc_fifo_depth
+        bypass_stages = 1 if options.lookahead_routing else 2
+        if options.router_bypass and \
+           options.router_latency <= bypass_stages:
+            fatal("--router-bypass needs a --router-latency above %d",
+                  bypass_stages)
+        network.router_bypass = options.router_bypass
+        network.lookahead_routing = options.lookahead_routing
+        init_clock_domains(options, network, chiplets)
 
         # Create bridge and connect them to the corresponding links
         for intLink in network.int_links:
@@ -205,3 +383,40 @@ def init_network(options, network, InterfaceClass):
         assert(options.network == "garnet2.0")
         network.enable_fault_model = True
         network.fault_model = FaultModel()
+
+# Network options that can be changed on an instantiated, drained garnet
+# network, e.g. in the children of a fork sweep
+runtime_overrides = ["chiplet_link_latency", "interposer_link_latency",
+                     "interposer_link_width", "clip_logic_ifc_delay",
+                     "clip_phys_ifc_delay"]
+
+def apply_overrides(options, network, overrides):
+    for key in overrides:
+        if key not in runtime_overrides:
+            fatal("Network option %s can not be changed at runtime", key)
+
+    if not overrides:
+        return
+
+    if options.network != "garnet2.0":
+        fatal("Runtime network overrides need the garnet2.0 network")
+
+    logic = int(overrides.get("clip_logic_ifc_delay",
+                              options.clip_logic_ifc_delay))
+    phys = int(overrides.get("clip_phys_ifc_delay",
+                             options.clip_phys_ifc_delay))
+
+    for intLink in network.int_links:
+        link = intLink.getCCObject()
+        # Interposer links are the ones with CLIP at both ends
+        interposer = intLink.tx_clip and intLink.rx_clip
+        if interposer:
+            if "interposer_link_latency" in overrides:
+                link.setLatency(int(overrides["interposer_link_latency"]))
+            if "interposer_link_width" in overrides:
+                link.setWidth(int(overrides["interposer_link_width"]))
+        elif "chiplet_link_latency" in overrides:
+            link.setLatency(int(overrides["chiplet_link_latency"]))
+        if "clip_logic_ifc_delay" in overrides or \
+           "clip_phys_ifc_delay" in overrides:
+            link.setInterfaceLatency(logic, phys)
@@ -172,6 +172,7 @@ def create_system(options, full_system, system, dma_ports, bootmem,
             l2_cntrl = L2Cache_Controller(
                         version = i * num_l2caches_per_cluster + j,
                         L2cache = l2_cache, cluster_id = i,
+                        prefetcher = RubyPrefetcher.Prefetcher(),
                         transitions_per_cycle = options.ports,
                         ruby_system = ruby_system)
 
@@ -194,6 +195,8 @@ def create_system(options, full_system, system, dma_ports, bootmem,
             l2_cntrl.responseToL2Cache = MessageBuffer()
             l2_cntrl.responseToL2Cache.slave = ruby_system.network.master
 
+            l2_cntrl.optionalQueue = MessageBuffer()
+
     # Run each of the ruby memory controllers at a ratio of the frequency of
     # the ruby system
     # clk_divider value is a fix to pass regression.
@@ -41,7 +41,27 @@ class L1Cache(RubyCache): pass
 class L2Cache(RubyCache): pass
 
 def define_options(parser):
-    return
+    parser.add_option("--l1-prefetcher", type="choice", default="none",
+                      choices=["none", "stream", "stride", "delta",
+                               "indirect"],
+                      help="Prefetcher of the L1 data caches. 'stride' "
+                      "and 'delta' train with the PC of the loads, "
+                      "'indirect' adds indirect (A[B[i]]) prefetching on "
+                      "top of the stream buffers.")
+    parser.add_option("--l2-prefetcher", type="choice", default="none",
+                      choices=["none", "stream", "stride", "delta"],
+                      help="Prefetcher of the L2 caches, trained with the "
+                      "misses of each page.")
+
+def create_prefetcher(kind, pc_indexed):
+    if kind == "indirect":
+        return RubyIndirectPrefetcher()
+    elif kind == "stride":
+        return RubyStridePrefetcher(pc_indexed = pc_indexed)
+    elif kind == "delta":
+        return RubyDeltaPrefetcher(pc_indexed = pc_indexed)
+    else:
+        return RubyPrefetcher.Prefetcher()
 
 def create_system(options, full_system, system, dma_ports, bootmem,
                   ruby_system):
@@ -80,7 +100,7 @@ def create_system(options, full_system, system, dma_ports, bootmem,
                             start_index_bit = block_size_bits,
                             is_icache = False)
 
-        prefetcher = RubyPrefetcher.Prefetcher()
+        prefetcher = create_prefetcher(options.l1_prefetcher, True)
 
         # the ruby random tester reuses num_cpus to specify the
         # number of cpu ports connected to the tester object, which
@@ -102,7 +122,8 @@ def create_system(options, full_system, system, dma_ports, bootmem,
                                       ruby_system = ruby_system,
                                       clk_domain = clk_domain,
                                       transitions_per_cycle = options.ports,
-                                      enable_prefetch = False)
+                                      enable_prefetch = \
+                                        options.l1_prefetcher != "none")
 
         cpu_seq = RubySequencer(version = i, icache = l1i_cache,
                                 dcache = l1d_cache, clk_domain = clk_domain,
@@ -126,6 +147,8 @@ def create_system(options, full_system, system, dma_ports, bootmem,
         l1_cntrl.unblockFromL1Cache.master = ruby_system.network.slave
 
         l1_cntrl.optionalQueue = MessageBuffer()
+        # Hold back the prefetches while the request network is busy
+        prefetcher.throttle_buffer = l1_cntrl.requestFromL1Cache
 
         l1_cntrl.requestToL1Cache = MessageBuffer()
         l1_cntrl.requestToL1Cache.slave = ruby_system.network.master
@@ -144,10 +167,15 @@ def create_system(options, full_system, system, dma_ports, bootmem,
                            assoc = options.l2_assoc,
                            start_index_bit = l2_index_start)
 
+        prefetcher = create_prefetcher(options.l2_prefetcher, False)
+
         l2_cntrl = L2Cache_Controller(version = i,
                                       L2cache = l2_cache,
+                                      prefetcher = prefetcher,
                                       transitions_per_cycle = options.ports,
-                                      ruby_system = ruby_system)
+                                      ruby_system = ruby_system,
+                                      enable_prefetch = \
+                                        options.l2_prefetcher != "none")
 
         exec("ruby_system.l2_cntrl%d = l2_cntrl" % i)
         l2_cntrl_nodes.append(l2_cntrl)
@@ -167,6 +195,10 @@ def create_system(options, full_system, system, dma_ports, bootmem,
         l2_cntrl.responseToL2Cache = MessageBuffer()
         l2_cntrl.responseToL2Cache.slave = ruby_system.network.master
 
+        l2_cntrl.optionalQueue = MessageBuffer()
+        # Hold back the prefetches while the memory requests are backed up
+        prefetcher.throttle_buffer = l2_cntrl.DirRequestFromL2Cache
+
 
     # Run each of the ruby memory controllers at a ratio of the frequency of
     # the ruby system
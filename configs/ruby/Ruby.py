@@ -65,6 +65,13 @@ def define_options(parser):
     parser.add_option("--access-backing-store", action="store_true", default=False,
                       help="Should ruby maintain a second copy of memory")
 
+    parser.add_option("--functional-warming", action="store_true",
+                      default=False,
+                      help="""Let atomic CPUs warm the ruby caches: accesses
+                              are performed on the backing store and replayed
+                              through the sequencers (implies
+                              --access-backing-store)""")
+
     # Options related to cache structure
     parser.add_option("--ports", action="store", type="int", default=4,
                       help="used of transitions per cycle which is a proxy \
@@ -154,6 +161,12 @@ def create_system(options, full_system, system, piobus = None, dma_ports = [],
     system.ruby = RubySystem()
     ruby = system.ruby
 
+    # Functional warming reads and writes data outside the protocol, so
+    # it relies on the backing store holding the official copy of memory
+    if options.functional_warming:
+        ruby.functional_warming = True
+        options.access_backing_store = True
+
     # Create the network object
     (network, IntLinkClass, ExtLinkClass, RouterClass, InterfaceClass) = \
         Network.create_network(options, ruby)
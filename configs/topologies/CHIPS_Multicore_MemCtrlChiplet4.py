@@ -273,6 +273,67 @@ class CHIPS_Multicore_MemCtrlChiplet4(SimpleTopology):
                     link_count += 1
 
 
+        # Express links skipping express_hops - 1 routers, with the same
+        # weights as the mesh links so routes stay XY ordered. Flits
+        # still cross every hop of wire but none of the routers.
+        express_hops = options.express_link_hops
+        if express_hops > 0:
+            # The XY routing unit only knows the mesh port names
+            assert(options.routing_algorithm == 0)
+            assert(express_hops > 1)
+            express_latency = express_hops * chiplet_link_latency
+
+            # East/West express links (weight = 1)
+            for row in xrange(num_rows):
+                for col in xrange(num_columns - express_hops):
+                    west = col + (row * num_columns)
+                    east = west + express_hops
+                    for (src, dst, outport, inport) in \
+                        [(west, east, "EastExpress", "WestExpress"),
+                         (east, west, "WestExpress", "EastExpress")]:
+                        int_links.append(IntLink(link_id=link_count,
+                                                 src_node=routers[src],
+                                                 dst_node=routers[dst],
+                                                 src_outport=outport,
+                                                 dst_inport=inport,
+                                                 latency = express_latency,
+                                                 width = chiplet_link_width,
+                                                 express = True,
+                                                 weight=1))
+
+                        print_connection("Router", get_router_id(routers[src]),
+                                         "Router", get_router_id(routers[dst]),
+                                          link_count,
+                                          express_latency, chiplet_link_width)
+
+                        link_count += 1
+
+            # North/South express links (weight = 2)
+            for col in xrange(num_columns):
+                for row in xrange(num_rows - express_hops):
+                    north = col + (row * num_columns)
+                    south = north + (express_hops * num_columns)
+                    for (src, dst, outport, inport) in \
+                        [(north, south, "NorthExpress", "SouthExpress"),
+                         (south, north, "SouthExpress", "NorthExpress")]:
+                        int_links.append(IntLink(link_id=link_count,
+                                                 src_node=routers[src],
+                                                 dst_node=routers[dst],
+                                                 src_outport=outport,
+                                                 dst_inport=inport,
+                                                 latency = express_latency,
+                                                 width = chiplet_link_width,
+                                                 express = True,
+                                                 weight=2))
+
+                        print_connection("Router", get_router_id(routers[src]),
+                                         "Router", get_router_id(routers[dst]),
+                                          link_count,
+                                          express_latency, chiplet_link_width)
+
+                        link_count += 1
+
+
         ## Connect MC routers to Mesh routers
         # MC 0 to Rtr
         int_links.append(IntLink(link_id=link_count,
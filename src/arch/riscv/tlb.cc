@@ -310,7 +310,7 @@ TLB::translateInst(const RequestPtr &req, ThreadContext *tc)
     } else {
         Process * p = tc->getProcessPtr();
 
-        Fault fault = p->pTable->translate(req);
+        Fault fault = p->pTable->translate(req, &seCache);
         if (fault != NoFault)
             return fault;
 
@@ -356,7 +356,7 @@ TLB::translateData(const RequestPtr &req, ThreadContext *tc, bool write)
 
         Process * p = tc->getProcessPtr();
 
-        Fault fault = p->pTable->translate(req);
+        Fault fault = p->pTable->translate(req, &seCache);
         if (fault != NoFault)
             return fault;
 
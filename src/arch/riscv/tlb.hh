@@ -43,6 +43,7 @@
 #include "arch/riscv/utility.hh"
 #include "arch/riscv/vtophys.hh"
 #include "base/statistics.hh"
+#include "mem/page_table.hh"
 #include "mem/request.hh"
 #include "params/RiscvTLB.hh"
 #include "sim/sim_object.hh"
@@ -74,6 +75,9 @@ class TLB : public BaseTLB
     mutable Stats::Scalar write_misses;
     mutable Stats::Scalar write_acv;
     mutable Stats::Scalar write_accesses;
+
+    // Recent SE-mode translations from the process page table
+    EmulationPageTable::TranslationCache seCache;
     Stats::Formula hits;
     Stats::Formula misses;
     Stats::Formula accesses;
@@ -75,7 +75,8 @@ OutputStream::~OutputStream()
 }
 
 void
-OutputStream::relocate(const OutputDirectory &dir)
+OutputStream::relocate(const std::string &old_path,
+                       const OutputDirectory &dir)
 {
 }
 
@@ -102,12 +103,27 @@ OutputFile<StreamType>::~OutputFile()
 
 template<class StreamType>
 void
-OutputFile<StreamType>::relocate(const OutputDirectory &dir)
+OutputFile<StreamType>::relocate(const std::string &old_path,
+                                 const OutputDirectory &dir)
 {
-    if (_recreateable) {
-        _fstream->close();
-        _fstream->open(dir.resolve(_name).c_str(), _mode);
+    if (!_recreateable)
+        return;
+
+    const std::string path(dir.resolve(_name));
+    _fstream->close();
+
+    {
+        ifstream in(old_path.c_str(), ios::binary);
+        ofstream out(path.c_str(), ios::binary | ios::trunc);
+        if (in.peek() != ifstream::traits_type::eof())
+            out << in.rdbuf();
+        if (!out)
+            fatal("Failed to copy output file '%s' to '%s'\n",
+                  old_path, path);
     }
+
+    _fstream->open(path.c_str(), (_mode & ~ios::trunc) | ios::app);
+    assert(_fstream->is_open());
 }
 
 OutputStream OutputDirectory::stdout("stdout", &cout);
@@ -176,7 +192,7 @@ OutputDirectory::setDirectory(const string &d)
     if (!old_dir.empty()) {
         // Recreate output files
         for (file_map_t::iterator i = files.begin(); i != files.end(); ++i) {
-            i->second->relocate(*this);
+            i->second->relocate(old_dir + i->first, *this);
         }
 
         // Relocate sub-directories
@@ -187,6 +203,16 @@ OutputDirectory::setDirectory(const string &d)
 
 }
 
+void
+OutputDirectory::flush()
+{
+    for (auto &f : files)
+        f.second->stream()->flush();
+
+    for (auto &d : dirs)
+        d.second->flush();
+}
+
 const string &
 OutputDirectory::directory() const
 {
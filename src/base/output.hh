@@ -84,8 +84,14 @@ class OutputStream
     /* Prevent copying */
     OutputStream(const OutputStream &f);
 
-    /** Re-create the in a new location if recreateable. */
-    virtual void relocate(const OutputDirectory &dir);
+    /**
+     * Re-create the in a new location if recreateable.
+     *
+     * @param old_path Path of the file before the move
+     * @param dir Directory the file moves to
+     */
+    virtual void relocate(const std::string &old_path,
+                          const OutputDirectory &dir);
 
     /** Name in output directory */
     const std::string _name;
@@ -122,8 +128,13 @@ class OutputFile
     /* Prevent copying */
     OutputFile(const OutputFile<StreamType> &f);
 
-    /** Re-create the file in a new location if it is relocatable. */
-    void relocate(const OutputDirectory &dir) override;
+    /**
+     * Re-create the file in a new location if it is relocatable. What
+     * was written to the old file, e.g. a header, is copied over, and
+     * the new file is appended to.
+     */
+    void relocate(const std::string &old_path,
+                  const OutputDirectory &dir) override;
 
     /** File mode when opened */
     const std::ios_base::openmode _mode;
@@ -197,6 +208,9 @@ class OutputDirectory
      */
     void setDirectory(const std::string &dir);
 
+    /** Write out what is buffered in the open files */
+    void flush();
+
     /**
      * Gets name of this directory.
      * @return name of this directory
@@ -376,6 +376,40 @@ HistStor::add(HistStor *hs)
         cvec[i] += hs->cvec[i];
 }
 
+LogHistStor::Params *
+LogHistStor::makeParams(unsigned precision, Counter max)
+{
+    // Keep the bucket of the largest value within a size_type index
+    fatal_if(precision > 16, "Log-linear histogram precision %d is more "
+             "than 16 bits", precision);
+    fatal_if(max < 0 || max >= (Counter)(ULL(1) << 62),
+             "Log-linear histogram maximum %f is out of range", max);
+
+    Params *params = new Params;
+    params->precision = precision;
+    params->max = max;
+    return params;
+}
+
+void
+LogHistStor::add(LogHistStor *hs)
+{
+    assert(precision == hs->precision);
+
+    if (cvec.size() < hs->cvec.size())
+        cvec.resize(hs->cvec.size());
+    for (off_type i = 0; i < hs->cvec.size(); ++i)
+        cvec[i] += hs->cvec[i];
+
+    min_val = std::min(min_val, hs->min_val);
+    max_val = std::max(max_val, hs->max_val);
+    underflow += hs->underflow;
+    overflow += hs->overflow;
+    sum += hs->sum;
+    squares += hs->squares;
+    samples += hs->samples;
+}
+
 Formula::Formula()
 {
 }
@@ -1657,6 +1657,157 @@ class HistStor
     }
 };
 
+/**
+ * Templatized storage for a log-linear (HDR style) histogram. Small values
+ * get exact buckets and every power of two above them is split into a fixed
+ * number of buckets, so the relative error of a bucket is bounded while the
+ * number of buckets only grows with the log of the largest value. Buckets
+ * are allocated as samples reach them, up to the one holding the maximum.
+ */
+class LogHistStor
+{
+  public:
+    /** The parameters for a log-linear histogram stat. */
+    struct Params : public DistParams
+    {
+        /** log2 of the number of buckets per power of two. */
+        unsigned precision;
+        /** The largest value to track, larger ones are overflows. */
+        Counter max;
+
+        Params() : DistParams(LogLinear), precision(0), max(0) {}
+    };
+
+  private:
+    /** log2 of the number of buckets per power of two. */
+    unsigned precision;
+    /** The largest value to track. */
+    Counter max_track;
+
+    /** The smallest value sampled. */
+    Counter min_val;
+    /** The largest value sampled. */
+    Counter max_val;
+    /** The number of values sampled less than zero. */
+    Counter underflow;
+    /** The number of values sampled more than max. */
+    Counter overflow;
+    /** The current sum. */
+    Counter sum;
+    /** The sum of squares. */
+    Counter squares;
+    /** The number of samples. */
+    Counter samples;
+    /** Counter for each bucket, grown on demand. */
+    VCounter cvec;
+
+  public:
+    LogHistStor(Info *info)
+    {
+        reset(info);
+    }
+
+    void add(LogHistStor *);
+
+    /** Check and build the parameters of a log-linear histogram. */
+    static Params *makeParams(unsigned precision, Counter max);
+
+    /**
+     * Add a value to the distribution for the given number of times.
+     * @param val The value to add.
+     * @param number The number of times to add the value.
+     */
+    void
+    sample(Counter val, int number)
+    {
+        if (val < 0) {
+            underflow += number;
+        } else if (val > max_track) {
+            overflow += number;
+        } else {
+            size_type index = logLinearIndex((uint64_t)val, precision);
+            if (index >= cvec.size())
+                cvec.resize(index + 1);
+            cvec[index] += number;
+        }
+
+        if (val < min_val)
+            min_val = val;
+        if (val > max_val)
+            max_val = val;
+
+        sum += val * number;
+        squares += val * val * number;
+        samples += number;
+    }
+
+    /**
+     * Return the number of buckets in use.
+     * @return the number of buckets.
+     */
+    size_type size() const { return cvec.size(); }
+
+    /**
+     * Returns true if any calls to sample have been made.
+     * @return True if any values have been sampled.
+     */
+    bool
+    zero() const
+    {
+        return samples == Counter();
+    }
+
+    void
+    prepare(Info *info, DistData &data)
+    {
+        const Params *params = safe_cast<const Params *>(info->storageParams);
+
+        assert(params->type == LogLinear);
+        data.type = params->type;
+        data.min = 0;
+        data.max = params->max;
+        // The bucket boundaries follow from the precision alone
+        data.bucket_size = params->precision;
+
+        data.min_val = (min_val == CounterLimits::max()) ? 0 : min_val;
+        data.max_val = (max_val == CounterLimits::lowest()) ? 0 : max_val;
+        data.underflow = underflow;
+        data.overflow = overflow;
+
+        data.cvec = cvec;
+
+        data.sum = sum;
+        data.squares = squares;
+        data.logs = 0;
+        data.samples = samples;
+    }
+
+    /**
+     * Reset stat value to default
+     */
+    void
+    reset(Info *info)
+    {
+        const Params *params = safe_cast<const Params *>(info->storageParams);
+        precision = params->precision;
+        max_track = params->max;
+
+        min_val = CounterLimits::max();
+        max_val = CounterLimits::lowest();
+        underflow = Counter();
+        overflow = Counter();
+
+        // Keep the buckets allocated so far, a reset is usually followed by
+        // samples of the same magnitude
+        for (auto &c : cvec)
+            c = Counter();
+
+        sum = Counter();
+        squares = Counter();
+        samples = Counter();
+    }
+};
+
 /**
  * Templatized storage and interface for a distribution that calculates mean
  * and variance.
@@ -2569,6 +2720,30 @@ class Histogram : public DistBase<Histogram, HistStor>
     }
 };
 
+/**
+ * A log-linear histogram with bounded relative error, for latencies
+ * and other long tailed distributions whose percentiles matter.
+ * @sa Stat, DistBase, LogHistStor
+ */
+class LogHistogram : public DistBase<LogHistogram, LogHistStor>
+{
+  public:
+    /**
+     * Set the parameters of this histogram. @sa LogHistStor::Params
+     * @param precision log2 of the number of buckets per power of two,
+     * the relative error of a bucket is at most 2^-precision.
+     * @param max The largest value to track.
+     * @return A reference to this histogram.
+     */
+    LogHistogram &
+    init(unsigned precision, Counter max)
+    {
+        this->setParams(LogHistStor::makeParams(precision, max));
+        this->doInit();
+        return this->self();
+    }
+};
+
 /**
  * Calculates the mean and variance of all the samples.
  * @sa DistBase, SampleStor
@@ -2634,6 +2809,30 @@ class VectorDistribution : public VectorDistBase<VectorDistribution, DistStor>
     }
 };
 
+/**
+ * A vector of log-linear histograms.
+ * @sa VectorDistBase, LogHistStor
+ */
+class VectorLogHistogram
+    : public VectorDistBase<VectorLogHistogram, LogHistStor>
+{
+  public:
+    /**
+     * Initialize storage and parameters for this histogram.
+     * @param size The size of the vector (the number of histograms).
+     * @param precision log2 of the number of buckets per power of two.
+     * @param max The largest value to track.
+     * @return A reference to this histogram.
+     */
+    VectorLogHistogram &
+    init(size_type size, unsigned precision, Counter max)
+    {
+        this->setParams(LogHistStor::makeParams(precision, max));
+        this->doInit(size);
+        return this->self();
+    }
+};
+
 /**
  * This is a vector of StandardDeviation stats.
  * @sa VectorDistBase, SampleStor
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/stats/binary.hh"
+
+#include <zlib.h>
+
+#include <cstring>
+#include <iostream>
+
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "base/stats/info.hh"
+#include "sim/core.hh"
+
+using namespace std;
+
+namespace Stats {
+
+namespace {
+
+const char binaryMagic[8] = { 'g', 'e', 'm', '5', 's', 't', 's', '1' };
+
+/** Record flags */
+const uint8_t compressedRecord = 0x1;
+
+template <class T>
+void
+put(string &buf, T val)
+{
+    buf.append(reinterpret_cast<const char *>(&val), sizeof(val));
+}
+
+void
+putString(string &buf, const string &str)
+{
+    put<uint32_t>(buf, str.size());
+    buf.append(str);
+}
+
+void
+putStrings(string &buf, const vector<string> &strs)
+{
+    put<uint32_t>(buf, strs.size());
+    for (const auto &str : strs)
+        putString(buf, str);
+}
+
+/** Flatten a prepared distribution, see binary.py for the layout */
+void
+putDist(vector<double> &values, const DistData &data)
+{
+    values.push_back(data.type);
+    values.push_back(data.min);
+    values.push_back(data.max);
+    values.push_back(data.bucket_size);
+    values.push_back(data.min_val);
+    values.push_back(data.max_val);
+    values.push_back(data.underflow);
+    values.push_back(data.overflow);
+    values.push_back(data.sum);
+    values.push_back(data.squares);
+    values.push_back(data.logs);
+    values.push_back(data.samples);
+    values.push_back(data.cvec.size());
+    values.insert(values.end(), data.cvec.begin(), data.cvec.end());
+}
+
+} // anonymous namespace
+
+Binary::Binary(ostream &stream, bool compress)
+    : stream(&stream), compress(compress), haveSchema(false), next(0),
+      fixedCount(0), varCount(0)
+{
+    stream.write(binaryMagic, sizeof(binaryMagic));
+    if (!valid())
+        fatal("Unable to open output stream for writing\n");
+}
+
+bool
+Binary::valid() const
+{
+    return stream != NULL && stream->good();
+}
+
+void
+Binary::begin()
+{
+    next = 0;
+    fixedValues.clear();
+    varValues.clear();
+}
+
+void
+Binary::addEntry(const Info &info, Kind kind, size_t count)
+{
+    if (haveSchema) {
+        panic_if(next >= entries.size() || entries[next].info != &info,
+                 "Stat %s was not in the first binary stats dump",
+                 info.name);
+        panic_if(entries[next].kind != kind || entries[next].count != count,
+                 "Stat %s changed its shape between dumps", info.name);
+    } else {
+        Entry entry;
+        entry.info = &info;
+        entry.kind = kind;
+        entry.count = count;
+        entry.offset = count ? fixedCount : varCount;
+        if (count)
+            fixedCount += count;
+        else
+            varCount++;
+        entries.push_back(entry);
+    }
+    next++;
+}
+
+void
+Binary::addFixed(const Info &info, Kind kind, const VResult &values)
+{
+    addEntry(info, kind, values.size());
+    fixedValues.insert(fixedValues.end(), values.begin(), values.end());
+}
+
+void
+Binary::addVariable(const Info &info, Kind kind,
+                    const vector<double> &values)
+{
+    addEntry(info, kind, 0);
+    put<uint32_t>(varValues, values.size());
+    varValues.append(reinterpret_cast<const char *>(values.data()),
+                     values.size() * sizeof(double));
+}
+
+void
+Binary::visit(const ScalarInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    addFixed(info, KindScalar, VResult(1, info.result()));
+}
+
+void
+Binary::visit(const VectorInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    addFixed(info, KindVector, info.result());
+}
+
+void
+Binary::visit(const Vector2dInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    addFixed(info, KindVector2d, info.cvec);
+}
+
+void
+Binary::visit(const FormulaInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    addFixed(info, KindFormula, info.result());
+}
+
+void
+Binary::visit(const DistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    vector<double> values;
+    putDist(values, info.data);
+    addVariable(info, KindDist, values);
+}
+
+void
+Binary::visit(const VectorDistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    vector<double> values;
+    for (const auto &data : info.data)
+        putDist(values, data);
+    addVariable(info, KindVectorDist, values);
+}
+
+void
+Binary::visit(const SparseHistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    vector<double> values;
+    values.push_back(info.data.samples);
+    for (const auto &bucket : info.data.cmap) {
+        values.push_back(bucket.first);
+        values.push_back(bucket.second);
+    }
+    addVariable(info, KindSparseHist, values);
+}
+
+string
+Binary::schema() const
+{
+    string buf;
+    put<uint32_t>(buf, entries.size());
+    put<uint32_t>(buf, fixedCount);
+    put<uint32_t>(buf, varCount);
+
+    for (const auto &entry : entries) {
+        const Info &info = *entry.info;
+        put<uint8_t>(buf, entry.kind);
+        put<uint8_t>(buf, 0);
+        put<uint16_t>(buf, info.flags);
+        put<int32_t>(buf, info.precision);
+        put<uint32_t>(buf, entry.offset);
+        put<uint32_t>(buf, entry.count);
+        putString(buf, info.name);
+        putString(buf, info.desc);
+
+        switch (entry.kind) {
+          case KindVector:
+          case KindFormula: {
+            auto &vinfo = static_cast<const VectorInfo &>(info);
+            putStrings(buf, vinfo.subnames);
+            putStrings(buf, vinfo.subdescs);
+            break;
+          }
+          case KindVectorDist: {
+            auto &vinfo = static_cast<const VectorDistInfo &>(info);
+            put<uint32_t>(buf, vinfo.data.size());
+            putStrings(buf, vinfo.subnames);
+            putStrings(buf, vinfo.subdescs);
+            break;
+          }
+          case KindVector2d: {
+            auto &vinfo = static_cast<const Vector2dInfo &>(info);
+            put<uint32_t>(buf, vinfo.x);
+            put<uint32_t>(buf, vinfo.y);
+            putStrings(buf, vinfo.subnames);
+            putStrings(buf, vinfo.subdescs);
+            putStrings(buf, vinfo.y_subnames);
+            break;
+          }
+          default:
+            break;
+        }
+    }
+    return buf;
+}
+
+void
+Binary::writeRecord(char type, const string &payload)
+{
+    uint8_t flags = 0;
+    string stored;
+    if (compress) {
+        uLongf size = compressBound(payload.size());
+        stored.resize(size);
+        int ret = compress2(reinterpret_cast<Bytef *>(&stored[0]), &size,
+                            reinterpret_cast<const Bytef *>(payload.data()),
+                            payload.size(), Z_BEST_SPEED);
+        fatal_if(ret != Z_OK, "Can't compress binary stats: %d", ret);
+        stored.resize(size);
+        flags |= compressedRecord;
+    }
+    const string &data = compress ? stored : payload;
+
+    string head;
+    put<uint8_t>(head, type);
+    put<uint8_t>(head, flags);
+    put<uint16_t>(head, 0);
+    put<uint32_t>(head, data.size());
+    put<uint32_t>(head, payload.size());
+
+    stream->write(head.data(), head.size());
+    stream->write(data.data(), data.size());
+}
+
+void
+Binary::end()
+{
+    panic_if(haveSchema && next != entries.size(),
+             "Binary stats dump visited %d of %d stats", next,
+             entries.size());
+
+    if (!haveSchema) {
+        writeRecord('S', schema());
+        haveSchema = true;
+    }
+
+    string payload;
+    payload.reserve(sizeof(uint64_t) + fixedValues.size() * sizeof(double) +
+                    varValues.size());
+    put<uint64_t>(payload, curTick());
+    payload.append(reinterpret_cast<const char *>(fixedValues.data()),
+                   fixedValues.size() * sizeof(double));
+    payload.append(varValues);
+    writeRecord('D', payload);
+
+    stream->flush();
+}
+
+Output *
+initBinary(const string &filename, bool compress)
+{
+    static Binary *binary = nullptr;
+
+    if (!binary) {
+        binary = new Binary(*simout.findOrCreate(filename, true)->stream(),
+                            compress);
+    }
+
+    return binary;
+}
+
+} // namespace Stats
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_STATS_BINARY_HH__
+#define __BASE_STATS_BINARY_HH__
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+namespace Stats {
+
+class Info;
+
+/**
+ * Binary columnar stats output. The names, descriptions and shapes of
+ * the stats are written once, in a schema record ahead of the first
+ * dump, and every dump then writes only the raw values. The values of
+ * stats with a fixed number of them (scalars, vectors, 2d vectors and
+ * formulas) sit at an offset given by the schema, so a reader can pull
+ * one stat out of every dump without parsing the others. Distributions
+ * and sparse histograms follow with a length each.
+ *
+ * File layout (host byte order): the magic "gem5sts1", then records. A
+ * record starts with a type byte ('S' schema, 'D' dump), a flags byte
+ * (bit 0: zlib compressed), two padding bytes, the uint32 stored and
+ * uncompressed payload sizes, then the payload. src/python/m5/stats/
+ * binary.py documents the payloads and reads them.
+ */
+class Binary : public Output
+{
+  public:
+    enum Kind {
+        KindScalar, KindVector, KindDist, KindVectorDist, KindVector2d,
+        KindFormula, KindSparseHist,
+    };
+
+  protected:
+    struct Entry
+    {
+        const Info *info;
+        Kind kind;
+        /** Offset into the fixed values, or index of a variable stat */
+        uint32_t offset;
+        /** Number of fixed values, 0 for variable stats */
+        uint32_t count;
+    };
+
+    std::ostream *stream;
+    bool compress;
+
+    /** Schema, known after the first dump */
+    std::vector<Entry> entries;
+    bool haveSchema;
+    /** Stats visited in the current dump */
+    size_t next;
+    uint32_t fixedCount;
+    uint32_t varCount;
+
+    /** Values of the current dump */
+    std::vector<double> fixedValues;
+    std::string varValues;
+
+    void addEntry(const Info &info, Kind kind, size_t count);
+    void addFixed(const Info &info, Kind kind, const VResult &values);
+    void addVariable(const Info &info, Kind kind,
+                     const std::vector<double> &values);
+    void writeRecord(char type, const std::string &payload);
+    std::string schema() const;
+
+  public:
+    Binary(std::ostream &stream, bool compress);
+
+    // Implement Visit
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+    // Implement Output
+    bool valid() const override;
+    void begin() override;
+    void end() override;
+};
+
+Output *initBinary(const std::string &filename, bool compress);
+
+} // namespace Stats
+
+#endif // __BASE_STATS_BINARY_HH__
@@ -31,8 +31,12 @@
 #ifndef __BASE_STATS_INFO_HH__
 #define __BASE_STATS_INFO_HH__
 
+#include <algorithm>
+#include <cmath>
+
 #include "base/stats/types.hh"
 #include "base/flags.hh"
+#include "base/intmath.hh"
 
 namespace Stats {
 
@@ -169,7 +173,7 @@ class VectorInfo : public Info
     virtual Result total() const = 0;
 };
 
-enum DistType { Deviation, Dist, Hist };
+enum DistType { Deviation, Dist, Hist, LogLinear };
 
 struct DistData
 {
@@ -189,6 +193,80 @@ struct DistData
     Counter samples;
 };
 
+/**
+ * Bucket of a log-linear histogram holding a value. Values below sub
+ * get a bucket of their own, every power of two above that is split
+ * into sub equal buckets, so a bucket is never wider than 1/sub of the
+ * values in it.
+ * @param val The value, must not be negative.
+ * @param precision log2 of the number of buckets per power of two (sub).
+ */
+inline size_type
+logLinearIndex(uint64_t val, unsigned precision)
+{
+    const uint64_t sub = ULL(1) << precision;
+    if (val < sub)
+        return val;
+    const unsigned shift = floorLog2(val) - precision;
+    return shift * sub + (val >> shift);
+}
+
+/**
+ * Smallest value that falls in a log-linear bucket.
+ * @sa logLinearIndex
+ */
+inline uint64_t
+logLinearLow(size_type index, unsigned precision)
+{
+    const uint64_t sub = ULL(1) << precision;
+    if (index < sub)
+        return index;
+    const unsigned shift = index / sub - 1;
+    return (index - shift * sub) << shift;
+}
+
+/**
+ * Largest value that falls in a log-linear bucket.
+ * @sa logLinearIndex
+ */
+inline uint64_t
+logLinearHigh(size_type index, unsigned precision)
+{
+    return logLinearLow(index + 1, precision) - 1;
+}
+
+/**
+ * Value below which pct percent of the samples of a LogLinear
+ * distribution fall. It is the upper bound of the bucket the percentile
+ * lands in, clamped to the largest sample seen.
+ * @param data A prepared distribution of type LogLinear.
+ * @param pct The percentile, between 0 and 100.
+ */
+inline Result
+logLinearPercentile(const DistData &data, double pct)
+{
+    if (data.samples == 0)
+        return NAN;
+
+    // bucket_size holds the precision for LogLinear distributions
+    const unsigned precision = data.bucket_size;
+    const Counter target =
+        std::max(1.0, std::ceil(pct / 100 * data.samples));
+
+    Counter seen = data.underflow;
+    if (seen >= target)
+        return data.min_val;
+
+    for (off_type i = 0; i < data.cvec.size(); ++i) {
+        seen += data.cvec[i];
+        if (seen >= target)
+            return std::min<Counter>(logLinearHigh(i, precision),
+                                     data.max_val);
+    }
+
+    return data.max_val;
+}
+
 class DistInfo : public Info
 {
   public:
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "base/stats/info.hh"
+
+using namespace Stats;
+
+TEST(LogLinearTest, ExactBelowSubBuckets)
+{
+    for (uint64_t v = 0; v < 64; v++) {
+        EXPECT_EQ(v, logLinearIndex(v, 5));
+        EXPECT_EQ(v, logLinearLow(v, 5));
+    }
+}
+
+TEST(LogLinearTest, BucketsCoverValues)
+{
+    // Every value falls between the bounds of its bucket and buckets are
+    // contiguous
+    for (unsigned precision = 0; precision < 8; precision++) {
+        uint64_t prev_index = 0;
+        for (uint64_t v = 1; v < 100000; v++) {
+            size_type index = logLinearIndex(v, precision);
+            EXPECT_LE(logLinearLow(index, precision), v);
+            EXPECT_GE(logLinearHigh(index, precision), v);
+            EXPECT_LE(index - prev_index, 1);
+            prev_index = index;
+        }
+    }
+}
+
+TEST(LogLinearTest, RelativeError)
+{
+    const unsigned precision = 5;
+    for (uint64_t v = 1; v < (ULL(1) << 40); v = v * 3 + 1) {
+        size_type index = logLinearIndex(v, precision);
+        uint64_t width = logLinearHigh(index, precision) -
+            logLinearLow(index, precision) + 1;
+        EXPECT_LE(width * (ULL(1) << precision), std::max<uint64_t>(v, 32));
+    }
+}
+
+TEST(LogLinearTest, Percentile)
+{
+    const unsigned precision = 3;
+
+    DistData data;
+    data.type = LogLinear;
+    data.bucket_size = precision;
+    data.underflow = 0;
+    data.overflow = 0;
+    data.sum = 0;
+    data.samples = 0;
+    data.min_val = 1;
+    data.max_val = 1000;
+
+    EXPECT_TRUE(std::isnan(logLinearPercentile(data, 50)));
+
+    // 1 .. 1000, once each
+    for (uint64_t v = 1; v <= 1000; v++) {
+        size_type index = logLinearIndex(v, precision);
+        if (index >= data.cvec.size())
+            data.cvec.resize(index + 1);
+        data.cvec[index]++;
+        data.samples++;
+    }
+
+    for (double pct : { 1.0, 50.0, 90.0, 99.0 }) {
+        Result p = logLinearPercentile(data, pct);
+        EXPECT_GE(p, pct * 10);
+        EXPECT_LE(p, pct * 10 * (1 + 1.0 / (1 << precision)) + 1);
+    }
+    EXPECT_EQ(1000, logLinearPercentile(data, 100));
+
+    data.overflow = 1000;
+    data.samples += 1000;
+    data.max_val = 5000;
+    EXPECT_EQ(5000, logLinearPercentile(data, 99));
+}
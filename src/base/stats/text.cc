@@ -429,14 +429,29 @@ DistPrint::operator()(ostream &stream) const
     if (data.type == Deviation)
         return;
 
+    // Log-linear histograms track under/overflows like a distribution
+    const bool bounded = data.type == Dist || data.type == LogLinear;
+
+    if (data.type == LogLinear) {
+        static const std::pair<const char *, double> percentiles[] = {
+            { "p50", 50 }, { "p90", 90 }, { "p99", 99 },
+            { "p99_9", 99.9 }, { "p99_99", 99.99 },
+        };
+        for (const auto &p : percentiles) {
+            print.name = base + p.first;
+            print.value = logLinearPercentile(data, p.second);
+            print(stream);
+        }
+    }
+
     size_t size = data.cvec.size();
 
     Result total = 0.0;
-    if (data.type == Dist && data.underflow != NAN)
+    if (bounded && data.underflow != NAN)
         total += data.underflow;
     for (off_type i = 0; i < size; ++i)
         total += data.cvec[i];
-    if (data.type == Dist && data.overflow != NAN)
+    if (bounded && data.overflow != NAN)
         total += data.overflow;
 
     if (total) {
@@ -444,7 +459,7 @@ DistPrint::operator()(ostream &stream) const
         print.cdf = 0.0;
     }
 
-    if (data.type == Dist && data.underflow != NAN) {
+    if (bounded && data.underflow != NAN) {
         print.name = base + "underflows";
         print.update(data.underflow, total);
         print(stream);
@@ -455,11 +470,20 @@ DistPrint::operator()(ostream &stream) const
     }
 
     for (off_type i = 0; i < size; ++i) {
+        Counter low, high;
+        if (data.type == LogLinear) {
+            // Most of the buckets are empty, only print the used ones
+            if (data.cvec[i] == 0)
+                continue;
+            low = logLinearLow(i, data.bucket_size);
+            high = logLinearHigh(i, data.bucket_size);
+        } else {
+            low = i * data.bucket_size + data.min;
+            high = ::min(low + data.bucket_size - 1.0, data.max);
+        }
+
         stringstream namestr;
         namestr << base;
-
-        Counter low = i * data.bucket_size + data.min;
-        Counter high = ::min(low + data.bucket_size - 1.0, data.max);
         namestr << low;
         if (low < high)
             namestr << "-" << high;
@@ -477,7 +501,7 @@ DistPrint::operator()(ostream &stream) const
         stream << endl;
     }
 
-    if (data.type == Dist && data.overflow != NAN) {
+    if (bounded && data.overflow != NAN) {
         print.name = base + "overflows";
         print.update(data.overflow, total);
         print(stream);
@@ -486,13 +510,13 @@ DistPrint::operator()(ostream &stream) const
     print.pdf = NAN;
     print.cdf = NAN;
 
-    if (data.type == Dist && data.min_val != NAN) {
+    if (bounded && data.min_val != NAN) {
         print.name = base + "min_value";
         print.value = data.min_val;
         print(stream);
     }
 
-    if (data.type == Dist && data.max_val != NAN) {
+    if (bounded && data.max_val != NAN) {
         print.name = base + "max_value";
         print.value = data.max_val;
         print(stream);
@@ -99,6 +99,13 @@ disable()
     Debug::SimpleFlag::disableAll();
 }
 
+std::string &
+argBuffer()
+{
+    static thread_local std::string buf;
+    return buf;
+}
+
 ObjectMatch ignore;
 
 void
@@ -36,7 +36,13 @@
 #ifndef __BASE_TRACE_HH__
 #define __BASE_TRACE_HH__
 
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <sstream>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include "base/cprintf.hh"
 #include "base/debug.hh"
@@ -46,6 +52,103 @@
 
 namespace Trace {
 
+/**
+ * @{
+ * Encoding of the raw arguments of a trace message, for loggers that
+ * store messages unformatted (see BinaryLogger). Every argument is a
+ * one byte tag followed by its value: 'i' int64, 'u' uint64, 'd'
+ * double, 'c' char, 'p' pointer as uint64, and 's' a uint32 length
+ * followed by the characters. Arguments without a native encoding are
+ * stored as the string their operator<< produces.
+ */
+template <typename T>
+inline void
+encodeScalar(std::string &buf, char tag, T value)
+{
+    buf.push_back(tag);
+    buf.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+inline void
+encodeString(std::string &buf, const char *str, size_t len)
+{
+    uint32_t len32 = len;
+    buf.push_back('s');
+    buf.append(reinterpret_cast<const char *>(&len32), sizeof(len32));
+    buf.append(str, len);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value>::type
+encodeArg(std::string &buf, const T &arg)
+{
+    if (std::is_same<T, char>::value)
+        encodeScalar(buf, 'c', static_cast<char>(arg));
+    else if (std::is_signed<T>::value)
+        encodeScalar(buf, 'i', static_cast<int64_t>(arg));
+    else
+        encodeScalar(buf, 'u', static_cast<uint64_t>(arg));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value>::type
+encodeArg(std::string &buf, const T &arg)
+{
+    encodeScalar(buf, 'd', static_cast<double>(arg));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_pointer<T>::value>::type
+encodeArg(std::string &buf, const T &arg)
+{
+    typedef typename std::remove_cv<
+        typename std::remove_pointer<T>::type>::type Pointee;
+    if (std::is_same<Pointee, char>::value && arg) {
+        const char *str = reinterpret_cast<const char *>(arg);
+        encodeString(buf, str, strlen(str));
+    } else {
+        encodeScalar(buf, 'p', reinterpret_cast<uintptr_t>(arg));
+    }
+}
+
+template <size_t N>
+inline void
+encodeArg(std::string &buf, const char (&arg)[N])
+{
+    encodeString(buf, arg, strlen(arg));
+}
+
+inline void
+encodeArg(std::string &buf, const std::string &arg)
+{
+    encodeString(buf, arg.data(), arg.size());
+}
+
+template <typename T>
+inline typename std::enable_if<!std::is_arithmetic<T>::value &&
+                               !std::is_pointer<T>::value &&
+                               !std::is_array<T>::value>::type
+encodeArg(std::string &buf, const T &arg)
+{
+    std::ostringstream os;
+    os << arg;
+    encodeArg(buf, os.str());
+}
+
+inline void encodeArgs(std::string &buf) {}
+
+template <typename T, typename ...Args>
+inline void
+encodeArgs(std::string &buf, const T &arg, const Args &...args)
+{
+    encodeArg(buf, arg);
+    encodeArgs(buf, args...);
+}
+
+/** Per-thread scratch buffer for encoded arguments */
+std::string &argBuffer();
+/** @} */
+
 /** Debug logging base class.  Handles formatting and outputting
  *  time/name/message messages */
 class Logger
@@ -54,15 +157,47 @@ class Logger
     /** Name match for objects to ignore */
     ObjectMatch ignore;
 
+    /**
+     * Pass messages to logRecord() with their arguments encoded
+     * instead of formatting them.
+     */
+    bool recordArgs;
+
+    /** Log an unformatted message, only used if recordArgs is set */
+    virtual void
+    logRecord(Tick when, const std::string &name, const char *flag,
+              const char *fmt, const std::string &args)
+    {
+    }
+
   public:
+    Logger() : recordArgs(false) { }
+
     /** Log a single message */
     template <typename ...Args>
     void dprintf(Tick when, const std::string &name, const char *fmt,
                  const Args &...args)
+    {
+        dprintf_flag(when, name, nullptr, fmt, args...);
+    }
+
+    /** Log a single message printed for a debug flag */
+    template <typename ...Args>
+    void dprintf_flag(Tick when, const std::string &name, const char *flag,
+                      const char *fmt, const Args &...args)
     {
         if (!name.empty() && ignore.match(name))
             return;
 
+        if (recordArgs) {
+            std::string &buf = argBuffer();
+            buf.clear();
+            buf.push_back(static_cast<char>(sizeof...(Args)));
+            encodeArgs(buf, args...);
+            logRecord(when, name, flag, fmt, buf);
+            return;
+        }
+
         std::ostringstream line;
         ccprintf(line, fmt, args...);
         logMessage(when, name, line.str());
@@ -86,6 +221,22 @@ class Logger
     /** Set objects to ignore */
     void setIgnore(ObjectMatch &ignore_) { ignore = ignore_; }
 
+    /** Write out anything buffered, e.g. before gem5 exits */
+    virtual void flush() { }
+
+    /**
+     * Write out records that are already encoded when gem5 aborts.
+     * Called from a signal handler, so only async-signal-safe calls
+     * may be used.
+     */
+    virtual void flushFromSignal() { }
+
+    /**
+     * Called in a forked child once its output directory is set up.
+     * The logger was flushed before forking.
+     */
+    virtual void notifyFork() { }
+
     virtual ~Logger() { }
 };
 
@@ -120,6 +271,43 @@ void setDebugLogger(Logger *logger);
 void enable();
 void disable();
 
+/**
+ * Trace argument that is only computed when it is printed.
+ *
+ * Arguments of DPRINTF are only evaluated when the flag is enabled,
+ * but code that builds them before the DPRINTF runs every time. Wrap
+ * such code in a lambda instead, e.g.
+ *
+ *   DPRINTF(Flag, "ports: %s\n", Trace::lazy([&] {
+ *       std::ostringstream oss;
+ *       for (auto &port : ports)
+ *           oss << port->name() << " ";
+ *       return oss.str();
+ *   }));
+ *
+ * util/style.py (--eagertrace) flags strings that are built only to be
+ * passed to a DPRINTF.
+ */
+template <typename F>
+struct LazyArg
+{
+    F func;
+};
+
+template <typename F>
+LazyArg<F>
+lazy(F &&func)
+{
+    return LazyArg<F>{std::forward<F>(func)};
+}
+
+template <typename F>
+std::ostream &
+operator<<(std::ostream &os, const LazyArg<F> &arg)
+{
+    return os << arg.func();
+}
+
 } // namespace Trace
 
 // This silly little class allows us to wrap a string in a functor
@@ -161,7 +349,9 @@ class Named
 
 #if TRACING_ON
 
-#define DTRACE(x) (Debug::x)
+// The Compiled constant is false for flags excluded from the build with
+// TRACING_EXCLUDE, which removes their trace statements entirely
+#define DTRACE(x) (Debug::Compiled::x && Debug::x)
 
 #define DDUMP(x, data, count) do {                                        \
     using namespace Debug;                                                \
@@ -172,7 +362,7 @@ class Named
 #define DPRINTF(x, ...) do {                                              \
     using namespace Debug;                                                \
     if (DTRACE(x)) {                                                      \
-        Trace::getDebugLogger()->dprintf(curTick(), name(),               \
+        Trace::getDebugLogger()->dprintf_flag(curTick(), name(), #x,      \
             __VA_ARGS__);                                                 \
     }                                                                     \
 } while (0)
@@ -180,7 +370,7 @@ class Named
 #define DPRINTFS(x, s, ...) do {                                          \
     using namespace Debug;                                                \
     if (DTRACE(x)) {                                                      \
-        Trace::getDebugLogger()->dprintf(curTick(), s->name(),            \
+        Trace::getDebugLogger()->dprintf_flag(curTick(), s->name(), #x,   \
             __VA_ARGS__);                                                 \
     }                                                                     \
 } while (0)
@@ -188,8 +378,8 @@ class Named
 #define DPRINTFR(x, ...) do {                                             \
     using namespace Debug;                                                \
     if (DTRACE(x)) {                                                      \
-        Trace::getDebugLogger()->dprintf((Tick)-1, std::string(),         \
-            __VA_ARGS__);                                                 \
+        Trace::getDebugLogger()->dprintf_flag((Tick)-1, std::string(),    \
+            #x, __VA_ARGS__);                                             \
     }                                                                     \
 } while (0)
 
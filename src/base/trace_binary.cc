@@ -0,0 +1,429 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/trace_binary.hh"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include "base/output.hh"
+
+namespace Trace {
+
+namespace {
+
+const char magic[] = "gem5trc1";
+
+template <typename T>
+void
+put(std::string &buf, T value)
+{
+    buf.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+void
+flushAtExit()
+{
+    getDebugLogger()->flush();
+}
+
+/** Write all of buf, only using async-signal-safe calls */
+void
+writeAll(int fd, const std::string &buf)
+{
+    const char *data = buf.data();
+    size_t left = buf.size();
+    while (left) {
+        ssize_t n = ::write(fd, data, left);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return;
+        data += n;
+        left -= n;
+    }
+}
+
+} // anonymous namespace
+
+BinaryLogger::BinaryLogger(std::ostream &stream, const std::string &name,
+                           size_t flight_records)
+    : stream(stream), name(name),
+      path(name.empty() ? "" : simout.resolve(name)),
+      flightRecords(flight_records),
+      writing(false), stopping(false), lineBuf(*this), lineStream(&lineBuf)
+{
+    recordArgs = true;
+
+    // Everything written through the stream is flushed right away, so
+    // flushFromSignal() can append to the file
+    stream.write(magic, sizeof(magic) - 1);
+    stream.flush();
+
+    if (!flightRecords)
+        writer.reset(new std::thread(&BinaryLogger::writerLoop, this));
+
+    // Buffered records must reach the output when gem5 exits, also
+    // through fatal(). Aborts are handled by the signal handlers,
+    // which call flushFromSignal().
+    static bool registered = false;
+    if (!registered) {
+        std::atexit(flushAtExit);
+        registered = true;
+    }
+}
+
+BinaryLogger::~BinaryLogger()
+{
+    flush();
+
+    if (writer) {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            stopping = true;
+        }
+        queueCond.notify_all();
+        writer->join();
+    }
+}
+
+BinaryLogger::ThreadBuffer &
+BinaryLogger::threadBuffer()
+{
+    static thread_local const BinaryLogger *owner = nullptr;
+    static thread_local ThreadBuffer *cached = nullptr;
+
+    if (owner != this) {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffers.emplace_back(new ThreadBuffer);
+        cached = buffers.back().get();
+        owner = this;
+        if (flightRecords)
+            cached->ring.resize(flightRecords);
+        else
+            cached->chunk.reserve(chunkSize * 2);
+    }
+
+    return *cached;
+}
+
+uint32_t
+BinaryLogger::stringId(const std::string &str)
+{
+    if (str.empty())
+        return 0;
+
+    std::lock_guard<std::mutex> lock(tableMutex);
+    auto it = stringIds.find(str);
+    if (it != stringIds.end())
+        return it->second;
+
+    uint32_t id = stringIds.size() + 1;
+    stringIds.emplace(str, id);
+
+    pendingStrings.push_back('S');
+    put<uint32_t>(pendingStrings, id);
+    put<uint32_t>(pendingStrings, str.size());
+    pendingStrings.append(str);
+
+    return id;
+}
+
+uint32_t
+BinaryLogger::literalId(ThreadBuffer &buf, const char *str)
+{
+    auto it = buf.literalIds.find(str);
+    if (it != buf.literalIds.end() && it->second.first == str)
+        return it->second.second;
+
+    uint32_t id = stringId(str);
+    buf.literalIds[str] = std::make_pair(std::string(str), id);
+    return id;
+}
+
+uint32_t
+BinaryLogger::nameId(ThreadBuffer &buf, const std::string &name)
+{
+    if (name.empty())
+        return 0;
+
+    auto it = buf.nameIds.find(name);
+    if (it != buf.nameIds.end())
+        return it->second;
+
+    uint32_t id = stringId(name);
+    buf.nameIds.emplace(name, id);
+    return id;
+}
+
+std::string &
+BinaryLogger::beginRecord(ThreadBuffer &buf)
+{
+    if (!flightRecords)
+        return buf.chunk;
+
+    std::string &slot = buf.ring[buf.ringNext];
+    slot.clear();
+    return slot;
+}
+
+void
+BinaryLogger::endRecord(ThreadBuffer &buf)
+{
+    if (flightRecords) {
+        buf.ringNext = (buf.ringNext + 1) % flightRecords;
+        buf.ringCount++;
+    } else if (buf.chunk.size() >= chunkSize) {
+        submit(buf);
+    }
+}
+
+void
+BinaryLogger::logRecord(Tick when, const std::string &name,
+                        const char *flag, const char *fmt,
+                        const std::string &args)
+{
+    ThreadBuffer &buf = threadBuffer();
+    uint32_t name_id = nameId(buf, name);
+    uint32_t flag_id = flag ? literalId(buf, flag) : 0;
+    uint32_t fmt_id = literalId(buf, fmt);
+
+    std::string &rec = beginRecord(buf);
+    rec.push_back('M');
+    put<uint64_t>(rec, when);
+    put<uint32_t>(rec, name_id);
+    put<uint32_t>(rec, flag_id);
+    put<uint32_t>(rec, fmt_id);
+    rec.append(args);
+    endRecord(buf);
+}
+
+void
+BinaryLogger::logMessage(Tick when, const std::string &name,
+                         const std::string &message)
+{
+    if (!name.empty() && ignore.match(name))
+        return;
+
+    ThreadBuffer &buf = threadBuffer();
+    uint32_t name_id = nameId(buf, name);
+
+    std::string &rec = beginRecord(buf);
+    rec.push_back('T');
+    put<uint64_t>(rec, when);
+    put<uint32_t>(rec, name_id);
+    put<uint32_t>(rec, message.size());
+    rec.append(message);
+    endRecord(buf);
+}
+
+void
+BinaryLogger::submit(ThreadBuffer &buf)
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.emplace_back(std::move(buf.chunk));
+        writing = true;
+    }
+    queueCond.notify_one();
+
+    buf.chunk.clear();
+    buf.chunk.reserve(chunkSize * 2);
+}
+
+void
+BinaryLogger::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (true) {
+        queueCond.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (queue.empty())
+            break;
+
+        std::deque<std::string> chunks;
+        chunks.swap(queue);
+        lock.unlock();
+
+        // All strings used by the chunks were registered before the
+        // chunks were submitted
+        std::string strings;
+        {
+            std::lock_guard<std::mutex> table_lock(tableMutex);
+            strings.swap(pendingStrings);
+        }
+
+        {
+            std::lock_guard<std::mutex> stream_lock(streamMutex);
+            stream.write(strings.data(), strings.size());
+            for (const auto &chunk : chunks)
+                stream.write(chunk.data(), chunk.size());
+            stream.flush();
+        }
+
+        lock.lock();
+        writing = !queue.empty();
+        idleCond.notify_all();
+    }
+}
+
+void
+BinaryLogger::writeFlightRecords()
+{
+    // Merge the rings of all threads in tick order
+    std::vector<const std::string *> records;
+    {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (auto &buf : buffers) {
+            size_t count = std::min<uint64_t>(buf->ringCount, flightRecords);
+            size_t first = (buf->ringNext + flightRecords - count) %
+                flightRecords;
+            for (size_t i = 0; i < count; ++i)
+                records.push_back(&buf->ring[(first + i) % flightRecords]);
+            buf->ringCount = 0;
+        }
+    }
+
+    auto tick = [](const std::string *rec) {
+        uint64_t when;
+        memcpy(&when, rec->data() + 1, sizeof(when));
+        return when;
+    };
+    std::stable_sort(records.begin(), records.end(),
+                     [&tick](const std::string *a, const std::string *b) {
+                         return tick(a) < tick(b);
+                     });
+
+    std::lock_guard<std::mutex> table_lock(tableMutex);
+    std::lock_guard<std::mutex> stream_lock(streamMutex);
+    stream.write(pendingStrings.data(), pendingStrings.size());
+    pendingStrings.clear();
+    for (auto rec : records)
+        stream.write(rec->data(), rec->size());
+}
+
+void
+BinaryLogger::flush()
+{
+    lineStream.flush();
+
+    if (flightRecords) {
+        writeFlightRecords();
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            for (auto &buf : buffers) {
+                if (!buf->chunk.empty())
+                    submit(*buf);
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(queueMutex);
+        idleCond.wait(lock, [this] { return queue.empty() && !writing; });
+    }
+
+    std::lock_guard<std::mutex> stream_lock(streamMutex);
+    stream.flush();
+}
+
+void
+BinaryLogger::flushFromSignal()
+{
+    // Appending while the writer thread writes chunks would corrupt
+    // the output, so those records are lost. The locks cannot be
+    // taken here either, so another thread logging at the same time
+    // may leave a partial record at the end.
+    if (path.empty() || writing)
+        return;
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_APPEND);
+    if (fd < 0)
+        return;
+
+    writeAll(fd, pendingStrings);
+    for (auto &buf : buffers) {
+        if (!flightRecords) {
+            writeAll(fd, buf->chunk);
+            continue;
+        }
+
+        size_t count = std::min<uint64_t>(buf->ringCount, flightRecords);
+        size_t first = (buf->ringNext + flightRecords - count) %
+            flightRecords;
+        for (size_t i = 0; i < count; ++i)
+            writeAll(fd, buf->ring[(first + i) % flightRecords]);
+    }
+
+    ::close(fd);
+}
+
+void
+BinaryLogger::notifyFork()
+{
+    // The output file moved to the child's output directory
+    if (!name.empty())
+        path = simout.resolve(name);
+
+    // Threads are not forked. The parent's writer was idle, as the
+    // logger was flushed before forking, so a new one can take over.
+    if (writer) {
+        // The parent's writer cannot be joined here, so its handle leaks
+        writer.release();
+        writer.reset(new std::thread(&BinaryLogger::writerLoop, this));
+    }
+}
+
+int
+BinaryLogger::LineBuf::overflow(int c)
+{
+    if (c == traits_type::eof())
+        return traits_type::not_eof(c);
+
+    line.push_back(traits_type::to_char_type(c));
+    if (c == '\n') {
+        logger.logMessage(MaxTick, "", line);
+        line.clear();
+    }
+    return c;
+}
+
+int
+BinaryLogger::LineBuf::sync()
+{
+    if (!line.empty()) {
+        logger.logMessage(MaxTick, "", line);
+        line.clear();
+    }
+    return 0;
+}
+
+} // namespace Trace
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __BASE_TRACE_BINARY_HH__
+#define __BASE_TRACE_BINARY_HH__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "base/trace.hh"
+
+namespace Trace {
+
+/**
+ * Debug logger writing compact binary records instead of text.
+ *
+ * Messages are stored with their format string and raw arguments (see
+ * encodeArgs()), and strings such as object names, flags and formats
+ * are written once and referred to by id. Each thread appends records
+ * to its own buffer, and full buffers are written to the output by a
+ * background thread, so tracing does not wait for formatting or IO.
+ * util/decode_trace.py turns the output back into the usual text.
+ *
+ * In flight recorder mode nothing is written while simulating. Every
+ * thread only keeps its last N records in a ring, and the rings are
+ * written out by flush() when gem5 exits. When it aborts (e.g. on a
+ * panic for a deadlock), flushFromSignal() appends the rings to the
+ * output file one thread after the other, without merging them.
+ *
+ * The output starts with the 8 byte magic "gem5trc1" followed by
+ * records, each starting with a one byte type:
+ *   'S' id:u32 len:u32 chars       -- string table entry
+ *   'M' tick:u64 name:u32 flag:u32 fmt:u32 nargs:u8 args
+ *                                  -- unformatted message
+ *   'T' tick:u64 name:u32 len:u32 chars
+ *                                  -- preformatted text
+ * All integers are in host byte order. String id 0 is the empty
+ * string and is never written.
+ */
+class BinaryLogger : public Logger
+{
+  public:
+    /**
+     * @param stream Output, opened in binary mode
+     * @param name Name of the output file in simout, reopened to
+     *        write out the buffered records when gem5 aborts. Empty
+     *        if the output is not a file.
+     * @param flight_records Records kept per thread in flight recorder
+     *        mode, 0 to write all records
+     */
+    BinaryLogger(std::ostream &stream, const std::string &name,
+                 size_t flight_records = 0);
+    ~BinaryLogger();
+
+    void logMessage(Tick when, const std::string &name,
+                    const std::string &message) override;
+
+    /**
+     * Text written to this stream is logged as messages without a
+     * name, one per line.
+     */
+    std::ostream &getOstream() override { return lineStream; }
+
+    void flush() override;
+    void flushFromSignal() override;
+    void notifyFork() override;
+
+  protected:
+    void logRecord(Tick when, const std::string &name, const char *flag,
+                   const char *fmt, const std::string &args) override;
+
+  private:
+    /** Records of one thread */
+    struct ThreadBuffer
+    {
+        /** Records waiting to be handed to the writer */
+        std::string chunk;
+        /** Last records in flight recorder mode */
+        std::vector<std::string> ring;
+        size_t ringNext;
+        uint64_t ringCount;
+
+        /**
+         * Ids of strings this thread has used. Formats and flags are
+         * looked up by address, but the string is kept to detect
+         * formats that are not literals.
+         */
+        std::unordered_map<const char *,
+                           std::pair<std::string, uint32_t>> literalIds;
+        std::unordered_map<std::string, uint32_t> nameIds;
+
+        ThreadBuffer() : ringNext(0), ringCount(0) {}
+    };
+
+    /** Turns text written to getOstream() into messages */
+    class LineBuf : public std::streambuf
+    {
+      public:
+        LineBuf(BinaryLogger &logger) : logger(logger) {}
+
+      protected:
+        int overflow(int c) override;
+        int sync() override;
+
+      private:
+        BinaryLogger &logger;
+        std::string line;
+    };
+
+    ThreadBuffer &threadBuffer();
+
+    /** Id of a string, registering it on first use */
+    uint32_t stringId(const std::string &str);
+    uint32_t literalId(ThreadBuffer &buf, const char *str);
+    uint32_t nameId(ThreadBuffer &buf, const std::string &name);
+
+    /** Start a record in the calling thread's buffer */
+    std::string &beginRecord(ThreadBuffer &buf);
+    /** Finish a record started with beginRecord() */
+    void endRecord(ThreadBuffer &buf);
+
+    /** Hand a thread's chunk to the writer */
+    void submit(ThreadBuffer &buf);
+    void writerLoop();
+    void writeFlightRecords();
+
+    std::ostream &stream;
+    const std::string name;
+    /** Resolved path of the output file, empty if there is none */
+    std::string path;
+    const size_t flightRecords;
+
+    /** Size at which a thread hands its chunk to the writer */
+    static const size_t chunkSize = 256 * 1024;
+
+    /** String table, shared by all threads */
+    std::mutex tableMutex;
+    std::unordered_map<std::string, uint32_t> stringIds;
+    /** Table entries not written to the output yet */
+    std::string pendingStrings;
+
+    /** Buffers of all threads that have logged */
+    std::mutex buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+    /** Chunks waiting for the writer */
+    std::mutex queueMutex;
+    std::condition_variable queueCond;
+    std::condition_variable idleCond;
+    std::deque<std::string> queue;
+    /** Chunks are queued or being written */
+    std::atomic<bool> writing;
+    bool stopping;
+    std::unique_ptr<std::thread> writer;
+
+    /** Serializes writes to the output stream */
+    std::mutex streamMutex;
+
+    LineBuf lineBuf;
+    std::ostream lineStream;
+};
+
+} // namespace Trace
+
+#endif // __BASE_TRACE_BINARY_HH__
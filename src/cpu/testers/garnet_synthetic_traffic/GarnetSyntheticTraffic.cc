@@ -92,11 +92,15 @@ GarnetSyntheticTraffic::GarnetSyntheticTraffic(const Params *p)
       injRate(p->inj_rate),
       injVnet(p->inj_vnet),
       precision(p->precision),
+      geometric(p->geometric_interarrival),
+      nextInjection(MaxTick),
       responseLimit(p->response_limit),
       masterId(p->system->getMasterId(this))
 {
     // set up counters
-    noResponseCycles = 0;
+    lastResponseCycle = Cycles(0);
+    if (geometric)
+        nextInjection = nextInjectionTick();
     schedule(tickEvent, 0);
 
     initTrafficType();
@@ -135,7 +139,7 @@ GarnetSyntheticTraffic::completeRequest(PacketPtr pkt)
             pkt->req->getPaddr());
 
     assert(pkt->isResponse());
-    noResponseCycles = 0;
+    lastResponseCycle = curCycle();
     delete pkt;
 }
 
@@ -143,21 +147,29 @@ GarnetSyntheticTraffic::completeRequest(PacketPtr pkt)
 void
 GarnetSyntheticTraffic::tick()
 {
-    if (++noResponseCycles >= responseLimit) {
+    if (injRate > 0 && curCycle() - lastResponseCycle >= responseLimit) {
         fatal("%s deadlocked at cycle %d\n", name(), curTick());
     }
 
-    // make new request based on injection rate
-    // (injection rate's range depends on precision)
-    // - generate a random number between 0 and 10^precision
-    // - send pkt if this number is < injRate*(10^precision)
     bool sendAllowedThisCycle;
-    double injRange = pow((double) 10, (double) precision);
-    unsigned trySending = random_mt.random<unsigned>(0, (int) injRange);
-    if (trySending < injRate*injRange)
-        sendAllowedThisCycle = true;
-    else
-        sendAllowedThisCycle = false;
+    if (geometric) {
+        // the tester only wakes up for its next injection or the end of
+        // the simulation
+        sendAllowedThisCycle = curTick() >= nextInjection;
+        if (sendAllowedThisCycle)
+            nextInjection = nextInjectionTick();
+    } else {
+        // make new request based on injection rate
+        // (injection rate's range depends on precision)
+        // - generate a random number between 0 and 10^precision
+        // - send pkt if this number is < injRate*(10^precision)
+        double injRange = pow((double) 10, (double) precision);
+        unsigned trySending = random_mt.random<unsigned>(0, (int) injRange);
+        if (trySending < injRate*injRange)
+            sendAllowedThisCycle = true;
+        else
+            sendAllowedThisCycle = false;
+    }
 
     // always generatePkt unless fixedPkts or singleSender is enabled
     if (sendAllowedThisCycle) {
@@ -176,9 +188,51 @@ GarnetSyntheticTraffic::tick()
     // Schedule wakeup
     if (curTick() >= simCycles)
         exitSimLoop("Network Tester completed simCycles");
-    else {
-        if (!tickEvent.scheduled())
-            schedule(tickEvent, clockEdge(Cycles(1)));
+    else
+        scheduleTick();
+}
+
+void
+GarnetSyntheticTraffic::scheduleTick()
+{
+    Tick when = clockEdge(Cycles(1));
+    if (geometric) {
+        // wake up for the deadlock check at least every responseLimit
+        // cycles while injecting
+        Tick limit = injRate > 0 ? clockEdge(responseLimit) : MaxTick;
+        when = std::min(std::min(nextInjection, limit),
+                        std::max<Tick>(simCycles, curTick() + 1));
+    }
+
+    if (!tickEvent.scheduled())
+        schedule(tickEvent, when);
+    else if (when < tickEvent.when())
+        reschedule(tickEvent, when);
+}
+
+Tick
+GarnetSyntheticTraffic::nextInjectionTick()
+{
+    if (injRate <= 0)
+        return MaxTick;
+    if (injRate >= 1)
+        return clockEdge(Cycles(1));
+
+    // Cycles up to and including the next success of a Bernoulli trial
+    // per cycle with probability injRate
+    double u = random_mt.random<double>();
+    return clockEdge(Cycles(1 + floor(log1p(-u) / log1p(-injRate))));
+}
+
+void
+GarnetSyntheticTraffic::setInjectionRate(double rate)
+{
+    injRate = rate;
+    lastResponseCycle = curCycle();
+
+    if (geometric) {
+        nextInjection = nextInjectionTick();
+        scheduleTick();
     }
 }
 
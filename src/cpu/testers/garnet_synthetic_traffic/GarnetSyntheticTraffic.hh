@@ -73,6 +73,12 @@ class GarnetSyntheticTraffic : public MemObject
      */
     void printAddr(Addr a);
 
+    /**
+     * Change the injection rate, e.g. between the points of a sweep. A
+     * rate of 0 stops injection.
+     */
+    void setInjectionRate(double rate);
+
   protected:
     EventFunctionWrapper tickEvent;
 
@@ -115,7 +121,7 @@ class GarnetSyntheticTraffic : public MemObject
 
     unsigned blockSizeBits;
 
-    Tick noResponseCycles;
+    Cycles lastResponseCycle;
 
     int numDestinations;
     Tick simCycles;
@@ -130,12 +136,19 @@ class GarnetSyntheticTraffic : public MemObject
     int injVnet;
     int precision;
 
+    // Draw the gaps between injections instead of a trial per cycle
+    const bool geometric;
+    Tick nextInjection;
+
     const Cycles responseLimit;
 
     MasterID masterId;
 
     void completeRequest(PacketPtr pkt);
 
+    Tick nextInjectionTick();
+    void scheduleTick();
+
     void generatePkt();
     void sendPkt(PacketPtr pkt);
     void initTrafficType();
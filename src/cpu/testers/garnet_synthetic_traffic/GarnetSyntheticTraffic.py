@@ -29,6 +29,7 @@
 from m5.objects.MemObject import MemObject
 from m5.params import *
 from m5.proxy import *
+from m5.SimObject import *
 
 class GarnetSyntheticTraffic(MemObject):
     type = 'GarnetSyntheticTraffic'
@@ -51,7 +52,15 @@ class GarnetSyntheticTraffic(MemObject):
                                 Default is to inject in all three vnets")
     precision = Param.Int(3, "Number of digits of precision \
                               after decimal point")
+    geometric_interarrival = Param.Bool(False, "Draw the cycles between \
+                              injections from a geometric distribution \
+                              instead of a trial every cycle, so the \
+                              tester only wakes up to inject")
     response_limit = Param.Cycles(5000000, "Cycles before exiting \
                                             due to lack of progress")
     test = MasterPort("Port to the memory system to test")
     system = Param.System(Parent.any, "System we belong to")
+
+    cxx_exports = [
+        PyBindMethod("setInjectionRate"),
+    ]
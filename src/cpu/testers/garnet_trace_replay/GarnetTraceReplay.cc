@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/garnet_trace_replay/GarnetTraceReplay.hh"
+
+#include "base/logging.hh"
+#include "debug/GarnetTraceReplay.hh"
+#include "mem/protocol/MachineType.hh"
+#include "mem/ruby/network/garnet2.0/NetworkInterface.hh"
+#include "sim/sim_exit.hh"
+
+namespace {
+
+MachineID
+nodeToMachine(NodeID node)
+{
+    for (int m = 0; m < (int) MachineType_NUM; m++) {
+        if (node >= MachineType_base_number((MachineType) m) &&
+            node < MachineType_base_number((MachineType) (m+1))) {
+            return (MachineID) {(MachineType) m,
+                (node - MachineType_base_number((MachineType) m))};
+        }
+    }
+    panic("Node %d is not a controller\n", node);
+}
+
+} // anonymous namespace
+
+GarnetTraceReplay::GarnetTraceReplay(const Params *p)
+    : ClockedObject(p),
+      network(p->network),
+      traceFile(p->trace_file),
+      enforceDependencies(p->dependencies),
+      responseLimit(p->response_limit),
+      numPending(0),
+      numInjected(0),
+      numDelivered(0),
+      tickEvent([this]{ tick(); }, "GarnetTraceReplay tick",
+                false, Event::CPU_Tick_Pri)
+{
+}
+
+void
+GarnetTraceReplay::init()
+{
+    ClockedObject::init();
+
+    readNetworkTrace(traceFile, header, records);
+
+    fatal_if(header.nodes != network->getNumNodes(),
+             "%s: %s was captured with %d network interfaces, the "
+             "network has %d\n", name(), traceFile, header.nodes,
+             network->getNumNodes());
+    fatal_if(header.vnets > network->getNumberOfVirtualNetworks(),
+             "%s: %s uses %d vnets, the network has %d\n", name(),
+             traceFile, header.vnets,
+             network->getNumberOfVirtualNetworks());
+    warn_if(header.clockPeriod != clockPeriod(),
+            "%s: %s was captured with a clock period of %d ticks, the "
+            "replay uses %d\n", name(), traceFile, header.clockPeriod,
+            clockPeriod());
+
+    dependents.resize(records.size());
+    pending.resize(header.nodes * header.vnets);
+
+    uint64_t first = records.empty() ? 0 : records.front().cycle;
+    for (const auto &rec : records) {
+        if (enforceDependencies &&
+            rec.dependency != NetworkTraceRecord::NoDependency) {
+            dependents[rec.dependency].push_back(rec.id);
+        } else {
+            readyQueue.push(ReadyEntry(rec.cycle - first, rec.id));
+        }
+    }
+
+    network->setTraceReplay(
+        [this](const NetworkTraceMsg &msg) { delivered(msg); });
+
+    DPRINTF(GarnetTraceReplay, "Replaying %d messages from %s\n",
+            records.size(), traceFile);
+}
+
+void
+GarnetTraceReplay::startup()
+{
+    start = curCycle();
+    lastDelivery = start;
+
+    if (records.empty())
+        exitSimLoop("GarnetTraceReplay completed");
+    else
+        scheduleTick(Cycles(readyQueue.top().first));
+}
+
+void
+GarnetTraceReplay::scheduleTick(Cycles when)
+{
+    Tick tick = clockEdge(Cycles(when - std::min(when, now())));
+    if (!tickEvent.scheduled())
+        schedule(tickEvent, tick);
+    else if (tick < tickEvent.when())
+        reschedule(tickEvent, tick);
+}
+
+void
+GarnetTraceReplay::tick()
+{
+    const uint64_t cycle = now();
+
+    while (!readyQueue.empty() && readyQueue.top().first <= cycle) {
+        const NetworkTraceRecord &rec = records[readyQueue.top().second];
+        pending[rec.src * header.vnets + rec.vnet].push_back(
+            ReadyEntry(cycle, rec.id));
+        numPending++;
+        readyQueue.pop();
+    }
+
+    for (auto &queue : pending) {
+        while (!queue.empty()) {
+            const NetworkTraceRecord &rec = records[queue.front().second];
+            NetDest dest;
+            dest.add(nodeToMachine(rec.dest));
+            MsgPtr msg = std::make_shared<NetworkTraceMsg>(clockEdge(),
+                                                           rec, dest);
+            if (!network->getNetworkInterface(rec.src)->injectMessage(
+                    msg, rec.vnet)) {
+                break;
+            }
+
+            DPRINTF(GarnetTraceReplay, "Injected %s\n", *msg);
+            injectionDelay += cycle - queue.front().first;
+            messagesInjected++;
+            numInjected++;
+            numPending--;
+            queue.pop_front();
+        }
+    }
+
+    if (numInjected > numDelivered &&
+        curCycle() - lastDelivery >= responseLimit) {
+        fatal("%s: no message delivered for %d cycles\n", name(),
+              curCycle() - lastDelivery);
+    }
+
+    // Keep watching for deadlocks while messages are in flight, and
+    // skip ahead otherwise
+    if (numPending || numInjected > numDelivered)
+        scheduleTick(Cycles(cycle + 1));
+    else if (!readyQueue.empty())
+        scheduleTick(Cycles(readyQueue.top().first));
+}
+
+void
+GarnetTraceReplay::delivered(const NetworkTraceMsg &msg)
+{
+    DPRINTF(GarnetTraceReplay, "Delivered %s\n", msg);
+
+    const uint64_t cycle = now();
+    numDelivered++;
+    messagesDelivered++;
+    lastDelivery = curCycle();
+
+    for (uint32_t id : dependents[msg.record.id]) {
+        uint64_t ready = cycle + records[id].slack;
+        readyQueue.push(ReadyEntry(ready, id));
+        scheduleTick(Cycles(ready));
+    }
+
+    if (numDelivered == records.size())
+        exitSimLoop("GarnetTraceReplay completed");
+}
+
+void
+GarnetTraceReplay::regStats()
+{
+    ClockedObject::regStats();
+
+    messagesInjected
+        .name(name() + ".messages_injected")
+        .desc("Number of messages injected")
+        ;
+
+    messagesDelivered
+        .name(name() + ".messages_delivered")
+        .desc("Number of messages delivered")
+        ;
+
+    injectionDelay
+        .name(name() + ".injection_delay")
+        .desc("Cycles ready messages waited for their network interface")
+        ;
+
+    avgInjectionDelay
+        .name(name() + ".avg_injection_delay")
+        .desc("Average cycles a ready message waited for its network "
+              "interface")
+        ;
+    avgInjectionDelay = injectionDelay / messagesInjected;
+}
+
+GarnetTraceReplay *
+GarnetTraceReplayParams::create()
+{
+    return new GarnetTraceReplay(this);
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_GARNET_TRACE_REPLAY_HH__
+#define __CPU_GARNET_TRACE_REPLAY_HH__
+
+#include <deque>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
+#include "mem/ruby/network/garnet2.0/NetworkTrace.hh"
+#include "params/GarnetTraceReplay.hh"
+#include "sim/clocked_object.hh"
+#include "sim/eventq.hh"
+
+/**
+ * Drives a Garnet network from a trace recorded with
+ * GarnetNetwork.trace_capture. Messages without a dependency are
+ * injected at their recorded cycle, the others the recorded slack
+ * after their dependency was delivered, so the replay keeps the causal
+ * order of the captured traffic while following the timing of the
+ * network under test. Messages are injected directly into the network
+ * interfaces and never reach the protocol.
+ */
+class GarnetTraceReplay : public ClockedObject
+{
+  public:
+    typedef GarnetTraceReplayParams Params;
+    GarnetTraceReplay(const Params *p);
+
+    void init() override;
+    void startup() override;
+    void regStats() override;
+
+  private:
+    void tick();
+    void delivered(const NetworkTraceMsg &msg);
+    void scheduleTick(Cycles when);
+    Cycles now() const { return curCycle() - start; }
+
+    GarnetNetwork *network;
+    const std::string traceFile;
+    const bool enforceDependencies;
+    const Cycles responseLimit;
+
+    NetworkTraceHeader header;
+    std::vector<NetworkTraceRecord> records;
+    /** Records waiting for the delivery of each record */
+    std::vector<std::vector<uint32_t>> dependents;
+
+    /** Records by the cycle they may be injected at */
+    typedef std::pair<uint64_t, uint32_t> ReadyEntry;
+    std::priority_queue<ReadyEntry, std::vector<ReadyEntry>,
+                        std::greater<ReadyEntry>> readyQueue;
+    /** Ready records the network interface did not accept yet, per
+     *  source and vnet, with the cycle they became ready */
+    std::vector<std::deque<ReadyEntry>> pending;
+    uint64_t numPending;
+
+    uint64_t numInjected;
+    uint64_t numDelivered;
+    Cycles start;
+    Cycles lastDelivery;
+
+    EventFunctionWrapper tickEvent;
+
+    Stats::Scalar messagesInjected;
+    Stats::Scalar messagesDelivered;
+    Stats::Scalar injectionDelay;
+    Stats::Formula avgInjectionDelay;
+};
+
+#endif // __CPU_GARNET_TRACE_REPLAY_HH__
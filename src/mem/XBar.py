@@ -74,6 +74,13 @@ class BaseXBar(MemObject):
     # Width governing the throughput of the crossbar
     width = Param.Unsigned("Datapath width per port (bytes)")
 
+    # Occupy uncontended layers without scheduling a release event,
+    # the next user notices that the layer is free again. This saves
+    # an event per packet, but a packet arriving in the very tick the
+    # occupancy ends may be accepted directly rather than through a
+    # retry, so results are not guaranteed to be identical.
+    lazy_layer_release = Param.Bool(False, "Release idle layers lazily")
+
     # The default port can be left unconnected, or be used to connect
     # a default slave port
     default = MasterPort("Port for connecting an optional default slave")
@@ -123,9 +130,14 @@ class SnoopFilter(SimObject):
 
     system = Param.System(Parent.any, "System that the crossbar belongs to.")
 
-    # Sanity check on max capacity to track, adjust if needed.
+    # Capacity in terms of the amount of data tracked, lines beyond
+    # this are evicted and their holders back-invalidated.
     max_capacity = Param.MemorySize('8MB', "Maximum capacity of snoop filter")
 
+    # Organisation of the tracking storage, the number of sets
+    # (capacity / line size / assoc) has to be a power of two.
+    assoc = Param.Unsigned(16, "Associativity of the snoop filter")
+
 # We use a coherent crossbar to connect multiple masters to the L2
 # caches. Normally this crossbar would be part of the cache itself.
 class L2XBar(CoherentXBar):
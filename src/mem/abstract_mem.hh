@@ -269,6 +269,17 @@ class AbstractMemory : public MemObject
      */
     Addr start() const { return range.start(); }
 
+    /**
+     * Get the host address backing a guest physical address in this
+     * memory. The caller is responsible for checking that the address
+     * is within range and that the memory is not null.
+     *
+     * @param addr Guest physical address
+     * @return Pointer into the host backing store
+     */
+    uint8_t *toHostAddr(Addr addr) const
+    { return pmemAddr + addr - range.start(); }
+
     /**
      *  Should this memory be passed to the kernel and part of the OS
      *  physical memory layout.
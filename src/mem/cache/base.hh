@@ -54,6 +54,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <cstring>
 #include <string>
 
 #include "base/addr_range.hh"
@@ -1141,6 +1142,24 @@ class BaseCache : public MemObject
         }
     }
 
+    /**
+     * Copy bytes out of a block present in the cache, without updating
+     * the replacement state. Used by prefetchers that look at the data
+     * they find in the cache (e.g., to follow the indices of an array).
+     *
+     * @return false if the bytes are not all in one valid block
+     */
+    bool peekData(Addr addr, bool is_secure, unsigned size,
+                  uint8_t *data) const {
+        CacheBlk *block = tags->findBlock(addr, is_secure);
+        Addr offset = addr & Addr(blkSize - 1);
+        if (!block || offset + size > blkSize) {
+            return false;
+        }
+        std::memcpy(data, block->data + offset, size);
+        return true;
+    }
+
     bool inMissQueue(Addr addr, bool is_secure) const {
         return mshrQueue.findMatch(addr, is_secure);
     }
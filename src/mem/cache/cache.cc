@@ -1225,38 +1225,78 @@ Cache::recvTimingSnoopReq(PacketPtr pkt)
             return;
         }
 
-        // conceptually writebacks are no different to other blocks in
-        // this cache, so the behaviour is modelled after handleSnoop,
-        // the difference being that instead of querying the block
-        // state to determine if it is dirty and writable, we use the
-        // command and fields of the writeback packet
-        bool respond = wb_pkt->cmd == MemCmd::WritebackDirty &&
-            pkt->needsResponse();
-        bool have_writable = !wb_pkt->hasSharers();
-        bool invalidate = pkt->isInvalidate();
-
-        if (!pkt->req->isUncacheable() && pkt->isRead() && !invalidate) {
-            assert(!pkt->needsWritable());
-            pkt->setHasSharers();
-            wb_pkt->setHasSharers();
-        }
-
-        if (respond) {
-            pkt->setCacheResponding();
+        if (pkt->isClean() && wb_pkt->cmd == MemCmd::WritebackDirty) {
+            // as in handleSnoop, a cleaning snoop is not responded
+            // to, instead the dirty data goes down as a WriteClean
+            // with the id of the snoop so that the cache maintenance
+            // operation does not complete before it reaches the PoC
+            RequestPtr req = std::make_shared<Request>(
+                wb_pkt->getAddr(), blkSize, 0, Request::wbMasterId);
+            if (wb_pkt->isSecure()) {
+                req->setFlags(Request::SECURE);
+            }
+            req->taskId(wb_pkt->req->taskId());
 
-            if (have_writable) {
-                pkt->setResponderHadWritable();
+            PacketPtr wc_pkt = new Packet(req, MemCmd::WriteClean, blkSize,
+                                          pkt->id);
+            if (pkt->req->getDest()) {
+                req->setFlags(pkt->req->getDest());
+                wc_pkt->setWriteThrough();
             }
+            if (wb_pkt->hasSharers()) {
+                wc_pkt->setHasSharers();
+            }
+            wc_pkt->allocate();
+            wc_pkt->setData(wb_pkt->getConstPtr<uint8_t>());
 
-            doTimingSupplyResponse(pkt, wb_pkt->getConstPtr<uint8_t>(),
-                                   false, false);
-        }
+            DPRINTF(Cache, "%s: Replacing %s with %s\n", __func__,
+                    wb_pkt->print(), wc_pkt->print());
 
-        if (invalidate && wb_pkt->cmd != MemCmd::WriteClean) {
-            // Invalidation trumps our writeback... discard here
             // Note: markInService will remove entry from writeback buffer.
             markInService(wb_entry);
             delete wb_pkt;
+
+            PacketList writebacks;
+            writebacks.push_back(wc_pkt);
+            doWritebacks(writebacks, clockEdge(forwardLatency) +
+                         pkt->headerDelay);
+            pkt->setSatisfied();
+        } else {
+            // conceptually writebacks are no different to other blocks
+            // in this cache, so the behaviour is modelled after
+            // handleSnoop, the difference being that instead of
+            // querying the block state to determine if it is dirty and
+            // writable, we use the command and fields of the writeback
+            // packet
+            bool respond = wb_pkt->cmd == MemCmd::WritebackDirty &&
+                pkt->needsResponse();
+            bool have_writable = !wb_pkt->hasSharers();
+            bool invalidate = pkt->isInvalidate();
+
+            if (!pkt->req->isUncacheable() && pkt->isRead() && !invalidate) {
+                assert(!pkt->needsWritable());
+                pkt->setHasSharers();
+                wb_pkt->setHasSharers();
+            }
+
+            if (respond) {
+                pkt->setCacheResponding();
+
+                if (have_writable) {
+                    pkt->setResponderHadWritable();
+                }
+
+                doTimingSupplyResponse(pkt, wb_pkt->getConstPtr<uint8_t>(),
+                                       false, false);
+            }
+
+            if (invalidate && wb_pkt->cmd != MemCmd::WriteClean) {
+                // Invalidation trumps our writeback... discard here
+                // Note: markInService will remove entry from writeback
+                // buffer.
+                markInService(wb_entry);
+                delete wb_pkt;
+            }
         }
     }
 
@@ -112,6 +112,10 @@ class QueuedPrefetcher(BasePrefetcher):
 
     tag_prefetch = Param.Bool(True, "Tag prefetch with PC of generating access")
 
+    trace_file = Param.String("", "Capture the observed accesses and the "
+        "generated prefetch candidates to this protobuf trace (relative to "
+        "the output directory, disabled if empty, requires protobuf)")
+
 class StridePrefetcher(QueuedPrefetcher):
     type = 'StridePrefetcher'
     cxx_class = 'StridePrefetcher'
@@ -341,3 +345,60 @@ class SlimAMPMPrefetcher(QueuedPrefetcher):
     dcpt = Param.DeltaCorrelatingPredictionTables(
         SlimDeltaCorrelatingPredictionTables(),
         "Delta Correlating Prediction Tables object")
+
+class IndirectMemoryPredictor(SimObject):
+    type = 'IndirectMemoryPredictor'
+    cxx_class = 'IndirectMemoryPredictor'
+    cxx_header = "mem/cache/prefetch/indirect_memory.hh"
+
+    block_size = Param.Int(Parent.cache_line_size, "Block size in bytes")
+
+    pt_table_entries = Param.MemorySize("16",
+        "Number of entries of the Prefetch Table")
+    pt_table_assoc = Param.Unsigned(16, "Associativity of the Prefetch Table")
+    pt_table_indexing_policy = Param.BaseIndexingPolicy(
+        SetAssociative(entry_size = 1, assoc = Parent.pt_table_assoc,
+        size = Parent.pt_table_entries),
+        "Indexing policy of the Prefetch Table")
+    pt_table_replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy of the Prefetch Table")
+
+    ipd_table_entries = Param.MemorySize("4",
+        "Number of entries of the Indirect Pattern Detector")
+    ipd_table_assoc = Param.Unsigned(4,
+        "Associativity of the Indirect Pattern Detector")
+    ipd_table_indexing_policy = Param.BaseIndexingPolicy(
+        SetAssociative(entry_size = 1, assoc = Parent.ipd_table_assoc,
+        size = Parent.ipd_table_entries),
+        "Indexing policy of the Indirect Pattern Detector")
+    ipd_table_replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy of the Indirect Pattern Detector")
+
+    shift_values = VectorParam.Int([2, 3, 4, -3],
+        "Shift values to evaluate (negative values are right shifts)")
+    addr_array_len = Param.Unsigned(4,
+        "Number of misses recorded per index in the pattern detector")
+    stream_counter_threshold = Param.Unsigned(4,
+        "Accesses with the same stride needed to consider an index stream")
+    streaming_distance = Param.Unsigned(4,
+        "Number of blocks prefetched ahead of an index stream")
+    indirect_distance = Param.Unsigned(8,
+        "Number of indices ahead of the stream whose targets are prefetched")
+    indirect_counter_bits = Param.Unsigned(3,
+        "Number of bits of the indirect confidence counters")
+    prefetch_threshold = Param.Unsigned(2,
+        "Confidence needed to issue indirect prefetches")
+    tracked_prefetches = Param.Unsigned(64,
+        "Number of recent indirect prefetches tracked for the statistics")
+
+class IndirectMemoryPrefetcher(QueuedPrefetcher):
+    type = 'IndirectMemoryPrefetcher'
+    cxx_class = 'IndirectMemoryPrefetcher'
+    cxx_header = "mem/cache/prefetch/indirect_memory.hh"
+
+    # The indices are read from the cache when it is hit
+    on_inst = False
+    prefetch_on_access = True
+
+    imp = Param.IndirectMemoryPredictor(IndirectMemoryPredictor(),
+        "Indirect Memory Prefetcher object")
@@ -31,9 +31,12 @@
 #ifndef __CACHE_PREFETCH_ASSOCIATIVE_SET_HH__
 #define __CACHE_PREFETCH_ASSOCIATIVE_SET_HH__
 
+#include <vector>
+
 #include "mem/cache/replacement_policies/base.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
+#include "mem/cache/tags/indexing_policies/set_associative.hh"
 
 /**
  * Entry used for set-associative tables, usable with replacement policies
@@ -122,6 +125,12 @@ class TaggedEntry : public ReplaceableEntry {
  * Associative container based on the previosuly defined Entry type
  * Each element is indexed by a key of type Addr, an additional
  * bool value is used as an additional tag data of the entry.
+ *
+ * This is the table substrate shared by the prefetchers. When the
+ * indexing policy is a plain SetAssociative one, the ways of a set
+ * are stored contiguously, and lookups and victim selection scan
+ * them directly instead of going through the (allocating)
+ * getPossibleEntries interface of the indexing policy.
  */
 template<class Entry>
 class AssociativeSet {
@@ -142,6 +151,26 @@ class AssociativeSet {
     BaseReplacementPolicy* const replacementPolicy;
     /** Vector containing the entries of the container */
     std::vector<Entry> entries;
+    /**
+     * Indexing policy if it is set associative and entries of a set
+     * are contiguous, nullptr otherwise.
+     */
+    const SetAssociative* flatIndexing;
+    /** Scratch space for the replacement candidates of a set */
+    mutable std::vector<ReplaceableEntry*> candidates;
+
+    /**
+     * Get the first way of the set of an address, only valid when
+     * flatIndexing is set.
+     */
+    Entry* firstWay(Addr addr) const
+    {
+        return const_cast<Entry*>(
+            &entries[flatIndexing->extractSet(addr) * associativity]);
+    }
+
+    /** Fill the candidates scratch vector with the ways of a set */
+    const std::vector<ReplaceableEntry*>& getCandidates(Addr addr) const;
 
   public:
     /**
@@ -196,6 +225,12 @@ class AssociativeSet {
      */
     void insertEntry(Addr addr, bool is_secure, Entry* entry);
 
+    /**
+     * Invalidate an entry and its replacement data
+     * @param entry the entry to be invalidated
+     */
+    void invalidate(Entry* entry);
+
     /** Iterator types */
     using const_iterator = typename std::vector<Entry>::const_iterator;
     using iterator = typename std::vector<Entry>::iterator;
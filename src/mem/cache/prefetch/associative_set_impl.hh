@@ -38,7 +38,8 @@ AssociativeSet<Entry>::AssociativeSet(int assoc, int num_entries,
         BaseIndexingPolicy *idx_policy, BaseReplacementPolicy *rpl_policy,
         Entry const &init_value)
   : associativity(assoc), numEntries(num_entries), indexingPolicy(idx_policy),
-    replacementPolicy(rpl_policy), entries(numEntries, init_value)
+    replacementPolicy(rpl_policy), entries(numEntries, init_value),
+    flatIndexing(dynamic_cast<const SetAssociative*>(idx_policy))
 {
     fatal_if(!isPowerOf2(num_entries), "The number of entries of an "
              "AssociativeSet<> must be a power of 2");
@@ -48,7 +49,26 @@ AssociativeSet<Entry>::AssociativeSet(int assoc, int num_entries,
         Entry* entry = &entries[entry_idx];
         indexingPolicy->setEntry(entry, entry_idx);
         entry->replacementData = replacementPolicy->instantiateEntry();
+
+        // the direct scan relies on the indexing policy placing the
+        // ways of a set next to each other
+        if (entry->getSet() != entry_idx / assoc ||
+            entry->getWay() != entry_idx % assoc) {
+            flatIndexing = nullptr;
+        }
     }
+    candidates.resize(assoc);
+}
+
+template<class Entry>
+const std::vector<ReplaceableEntry*>&
+AssociativeSet<Entry>::getCandidates(Addr addr) const
+{
+    Entry* set = firstWay(addr);
+    for (int way = 0; way < associativity; ++way) {
+        candidates[way] = &set[way];
+    }
+    return candidates;
 }
 
 template<class Entry>
@@ -56,6 +76,19 @@ Entry*
 AssociativeSet<Entry>::findEntry(Addr addr, bool is_secure) const
 {
     Addr tag = indexingPolicy->extractTag(addr);
+
+    if (flatIndexing) {
+        Entry* set = firstWay(addr);
+        for (int way = 0; way < associativity; ++way) {
+            Entry* entry = &set[way];
+            if ((entry->getTag() == tag) && entry->isValid() &&
+                entry->isSecure() == is_secure) {
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
     const std::vector<ReplaceableEntry*> selected_entries =
         indexingPolicy->getPossibleEntries(addr);
 
@@ -81,10 +114,16 @@ Entry*
 AssociativeSet<Entry>::findVictim(Addr addr)
 {
     // Get possible entries to be victimized
-    const std::vector<ReplaceableEntry*> selected_entries =
-        indexingPolicy->getPossibleEntries(addr);
-    Entry* victim = static_cast<Entry*>(replacementPolicy->getVictim(
+    Entry* victim;
+    if (flatIndexing) {
+        victim = static_cast<Entry*>(replacementPolicy->getVictim(
+                            getCandidates(addr)));
+    } else {
+        const std::vector<ReplaceableEntry*> selected_entries =
+            indexingPolicy->getPossibleEntries(addr);
+        victim = static_cast<Entry*>(replacementPolicy->getVictim(
                             selected_entries));
+    }
     // There is only one eviction for this replacement
     victim->reset();
     return victim;
@@ -95,6 +134,15 @@ template<class Entry>
 std::vector<Entry *>
 AssociativeSet<Entry>::getPossibleEntries(const Addr addr) const
 {
+    if (flatIndexing) {
+        Entry* set = firstWay(addr);
+        std::vector<Entry *> entries(associativity, nullptr);
+        for (int way = 0; way < associativity; ++way) {
+            entries[way] = &set[way];
+        }
+        return entries;
+    }
+
     std::vector<ReplaceableEntry *> selected_entries =
         indexingPolicy->getPossibleEntries(addr);
     std::vector<Entry *> entries(selected_entries.size(), nullptr);
@@ -116,4 +164,13 @@ AssociativeSet<Entry>::insertEntry(Addr addr, bool is_secure, Entry* entry)
    replacementPolicy->reset(entry->replacementData);
 }
 
+template<class Entry>
+void
+AssociativeSet<Entry>::invalidate(Entry* entry)
+{
+    entry->setInvalid();
+    entry->reset();
+    replacementPolicy->invalidate(entry->replacementData);
+}
+
 #endif//__CACHE_PREFETCH_ASSOCIATIVE_SET_IMPL_HH__
@@ -67,12 +67,14 @@ class BasePrefetcher : public ClockedObject
     {
       public:
         PrefetchListener(BasePrefetcher &_parent, ProbeManager *pm,
-                         const std::string &name)
+                         const std::string &name, bool _miss = false)
             : ProbeListenerArgBase(pm, name),
-              parent(_parent) {}
+              parent(_parent), miss(_miss) {}
         void notify(const PacketPtr &pkt) override;
       protected:
         BasePrefetcher &parent;
+        /** Whether the probe reports cache misses */
+        const bool miss;
     };
 
     std::vector<PrefetchListener *> listeners;
@@ -94,6 +96,12 @@ class BasePrefetcher : public ClockedObject
         bool validPC;
         /** Whether this address targets the secure memory space. */
         bool secure;
+        /** Size in bytes of the access. */
+        unsigned size;
+        /** Whether the access is a write. */
+        bool write;
+        /** Whether the access missed in the cache. */
+        bool miss;
 
       public:
         /**
@@ -142,6 +150,34 @@ class BasePrefetcher : public ClockedObject
             return masterId;
         }
 
+        /**
+         * Gets the size of the access that generated this address
+         * @return the size in bytes of the access
+         */
+        unsigned getSize() const
+        {
+            return size;
+        }
+
+        /**
+         * Checks if the access that generated this address is a write
+         * @return true if the access is a write
+         */
+        bool isWrite() const
+        {
+            return write;
+        }
+
+        /**
+         * Checks if the access that generated this address missed in
+         * the cache
+         * @return true if the access was a cache miss
+         */
+        bool isCacheMiss() const
+        {
+            return miss;
+        }
+
         /**
          * Check for equality
          * @param pfi PrefetchInfo to compare against
@@ -157,8 +193,9 @@ class BasePrefetcher : public ClockedObject
          * Constructs a PrefetchInfo using a PacketPtr.
          * @param pkt PacketPtr used to generate the PrefetchInfo
          * @param addr the address value of the new object
+         * @param miss whether the access missed in the cache
          */
-        PrefetchInfo(PacketPtr pkt, Addr addr);
+        PrefetchInfo(PacketPtr pkt, Addr addr, bool miss);
 
         /**
          * Constructs a PrefetchInfo using a new address value and
@@ -217,6 +254,13 @@ class BasePrefetcher : public ClockedObject
     /** Determine if address is in cache miss queue */
     bool inMissQueue(Addr addr, bool is_secure) const;
 
+    /**
+     * Read the contents of the parent cache, without side effects.
+     * @return false if the bytes are not in the cache
+     */
+    bool peekData(Addr addr, bool is_secure, unsigned size,
+                  uint8_t *data) const;
+
     bool hasBeenPrefetched(Addr addr, bool is_secure) const;
 
     /** Determine if addresses are on the same page */
@@ -270,8 +314,9 @@ class BasePrefetcher : public ClockedObject
     /**
      * Process a notification event from the ProbeListener.
      * @param pkt The memory request causing the event
+     * @param miss whether the event is a cache miss
      */
-    void probeNotify(const PacketPtr &pkt);
+    void probeNotify(const PacketPtr &pkt, bool miss);
 
     /**
      * Add a SimObject and a probe name to listen events from
@@ -131,8 +131,13 @@ DeltaCorrelatingPredictionTables::calculatePrefetch(
         DPRINTF(HWPrefetch, "Ignoring request with no PC.\n");
         return;
     }
-    Addr address = pfi.getAddr();
-    Addr pc = pfi.getPC();
+    calculatePrefetch(pfi.getPC(), pfi.getAddr(), addresses);
+}
+
+void
+DeltaCorrelatingPredictionTables::calculatePrefetch(Addr pc, Addr address,
+    std::vector<QueuedPrefetcher::AddrPriority> &addresses)
+{
     // Look up table entry, is_secure is unused in findEntry because we
     // index using the pc
     DCPTEntry *entry = table.findEntry(pc, false /* unused */);
@@ -118,6 +118,16 @@ class DeltaCorrelatingPredictionTables : public SimObject
     void calculatePrefetch(const BasePrefetcher::PrefetchInfo &pfi,
         std::vector<QueuedPrefetcher::AddrPriority> &addresses);
 
+    /**
+     * Computes the prefetch candidates of an access that is not seen
+     * through a PrefetchInfo, e.g., by the Ruby prefetchers.
+     * @param pc PC of the access, or any other identifier of its stream
+     * @param address address of the access
+     * @param addresses prefetch candidates generated
+     */
+    void calculatePrefetch(Addr pc, Addr address,
+        std::vector<QueuedPrefetcher::AddrPriority> &addresses);
+
 };
 
 struct DCPTPrefetcherParams;
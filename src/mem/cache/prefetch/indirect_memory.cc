@@ -0,0 +1,440 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/prefetch/indirect_memory.hh"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "arch/isa_traits.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "config/the_isa.hh"
+#include "debug/HWPrefetch.hh"
+#include "mem/cache/prefetch/associative_set_impl.hh"
+#include "params/IndirectMemoryPrefetcher.hh"
+#include "params/IndirectMemoryPredictor.hh"
+#include "sim/byteswap.hh"
+
+IndirectMemoryPredictor::IndirectMemoryPredictor(
+    const IndirectMemoryPredictorParams *p)
+  : SimObject(p), blkSize(p->block_size),
+    streamCounterThreshold(p->stream_counter_threshold),
+    streamingDistance(p->streaming_distance),
+    indirectDistance(p->indirect_distance),
+    maxIndirectCounter((1 << p->indirect_counter_bits) - 1),
+    prefetchThreshold(p->prefetch_threshold),
+    shiftValues(p->shift_values), addrArraySize(p->addr_array_len),
+    trackedPrefetches(p->tracked_prefetches),
+    prefetchTable(p->pt_table_assoc, p->pt_table_entries,
+                  p->pt_table_indexing_policy,
+                  p->pt_table_replacement_policy),
+    ipd(p->ipd_table_assoc, p->ipd_table_entries,
+        p->ipd_table_indexing_policy, p->ipd_table_replacement_policy,
+        IndirectPatternDetectorEntry(addrArraySize, shiftValues.size())),
+    ipdEntryTrackingMisses(nullptr)
+{
+    fatal_if(!isPowerOf2(blkSize), "%s: block size must be a power of 2\n",
+             name());
+    fatal_if(prefetchThreshold == 0 || prefetchThreshold > maxIndirectCounter,
+             "%s: the prefetch threshold must be between 1 and the maximum "
+             "value of the indirect counters\n", name());
+    fatal_if(shiftValues.empty(), "%s: no shift values provided\n", name());
+}
+
+bool
+IndirectMemoryPredictor::decodeIndex(const uint8_t *data, unsigned size,
+                                     Addr &index)
+{
+    switch (size) {
+      case sizeof(uint8_t):
+        index = data[0];
+        return true;
+      case sizeof(uint16_t): {
+        uint16_t value;
+        std::memcpy(&value, data, sizeof(value));
+        index = gtoh(value, TheISA::GuestByteOrder);
+        return true;
+      }
+      case sizeof(uint32_t): {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        index = gtoh(value, TheISA::GuestByteOrder);
+        return true;
+      }
+      case sizeof(uint64_t): {
+        uint64_t value;
+        std::memcpy(&value, data, sizeof(value));
+        index = gtoh(value, TheISA::GuestByteOrder);
+        return true;
+      }
+      default:
+        // Not an index
+        return false;
+    }
+}
+
+void
+IndirectMemoryPredictor::calculatePrefetch(Addr pc, Addr addr, unsigned size,
+    bool is_write, bool miss, const IndexReader &read_index,
+    std::vector<Addr> &addresses)
+{
+    checkRecentPrefetches(addr, miss);
+    checkAccessMatchOnActiveEntries(addr);
+
+    if (miss) {
+        demandMisses++;
+
+        // Correlate the misses that follow an index with the index
+        // value, the index loads themselves are not interesting
+        if (ipdEntryTrackingMisses != nullptr &&
+            ipdEntryTrackingMisses->pc != pc) {
+            if (!ipdEntryTrackingMisses->secondIndexSet) {
+                trackMissIndex1(addr);
+            } else {
+                trackMissIndex2(addr);
+            }
+        }
+    }
+
+    PrefetchTableEntry *pt_entry = prefetchTable.findEntry(pc, false);
+    if (pt_entry == nullptr) {
+        pt_entry = prefetchTable.findVictim(pc);
+        assert(pt_entry != nullptr);
+        prefetchTable.insertEntry(pc, false /* unused */, pt_entry);
+        pt_entry->address = addr;
+        return;
+    }
+    prefetchTable.accessEntry(pt_entry);
+
+    const int64_t stride = addr - pt_entry->address;
+    if (stride == 0) {
+        return;
+    }
+    if (stride == pt_entry->stride) {
+        if (pt_entry->streamCounter < streamCounterThreshold) {
+            pt_entry->streamCounter += 1;
+        }
+    } else {
+        pt_entry->stride = stride;
+        pt_entry->streamCounter = 0;
+    }
+    pt_entry->address = addr;
+
+    if (pt_entry->streamCounter < streamCounterThreshold) {
+        return;
+    }
+
+    // Keep the index array ahead of the stream, so that the indices
+    // used below are found in the cache
+    const int64_t step = std::abs(stride) >= blkSize ? stride :
+        (stride > 0 ? blkSize : -int64_t(blkSize));
+    for (int64_t distance = 1; distance <= streamingDistance; distance++) {
+        addresses.push_back(addr + step * distance);
+        streamPrefetches++;
+    }
+
+    Addr index;
+    if (is_write || !read_index(addr, size, index)) {
+        return;
+    }
+
+    if (!pt_entry->enabled) {
+        // No pattern found yet, use the index to look for one
+        allocateOrUpdateIPDEntry(pc, index);
+        return;
+    }
+
+    pt_entry->index = index;
+    if (!pt_entry->increasedIndirectCounter) {
+        // The previous index was not followed by its target
+        pt_entry->indirectCounter -= 1;
+        if (pt_entry->indirectCounter == 0) {
+            DPRINTF(HWPrefetch, "IMP: pattern of pc %#x lost\n", pc);
+            pt_entry->enabled = false;
+            return;
+        }
+    } else {
+        pt_entry->increasedIndirectCounter = false;
+    }
+
+    if (pt_entry->indirectCounter >= prefetchThreshold) {
+        Addr last_pf_addr = MaxAddr;
+        for (int64_t distance = 1; distance <= indirectDistance; distance++) {
+            Addr next_index;
+            if (!read_index(addr + stride * distance, size, next_index)) {
+                break;
+            }
+            Addr pf_addr = blockAddress(pt_entry->baseAddr +
+                indexOffset(next_index, pt_entry->shift));
+            if (pf_addr != last_pf_addr) {
+                addresses.push_back(pf_addr);
+                recordPrefetch(pf_addr);
+                indirectPrefetches++;
+                last_pf_addr = pf_addr;
+            }
+        }
+    }
+}
+
+void
+IndirectMemoryPredictor::allocateOrUpdateIPDEntry(Addr pc, Addr index)
+{
+    IndirectPatternDetectorEntry *ipd_entry = ipd.findEntry(pc, false);
+    if (ipd_entry != nullptr) {
+        ipd.accessEntry(ipd_entry);
+        if (!ipd_entry->secondIndexSet && ipd_entry->numMisses == 0) {
+            // Nothing was learnt from the previous index, replace it
+            ipd_entry->idx1 = index;
+        } else if (!ipd_entry->secondIndexSet) {
+            if (index == ipd_entry->idx1) {
+                return;
+            }
+            ipd_entry->idx2 = index;
+            ipd_entry->secondIndexSet = true;
+        } else {
+            // The misses of both indices did not match, start over
+            ipd_entry->reset();
+            ipd_entry->pc = pc;
+            ipd_entry->idx1 = index;
+        }
+    } else {
+        ipd_entry = ipd.findVictim(pc);
+        assert(ipd_entry != nullptr);
+        ipd.insertEntry(pc, false /* unused */, ipd_entry);
+        ipd_entry->pc = pc;
+        ipd_entry->idx1 = index;
+    }
+    ipdEntryTrackingMisses = ipd_entry;
+}
+
+void
+IndirectMemoryPredictor::trackMissIndex1(Addr miss_addr)
+{
+    IndirectPatternDetectorEntry *entry = ipdEntryTrackingMisses;
+    if (entry->numMisses == entry->baseAddr.size()) {
+        return;
+    }
+
+    // Record the base address each shift value would imply
+    std::vector<Addr> &ba_array = entry->baseAddr[entry->numMisses];
+    for (unsigned idx = 0; idx < shiftValues.size(); idx++) {
+        ba_array[idx] = miss_addr - indexOffset(entry->idx1,
+                                                shiftValues[idx]);
+    }
+    entry->numMisses += 1;
+}
+
+void
+IndirectMemoryPredictor::trackMissIndex2(Addr miss_addr)
+{
+    IndirectPatternDetectorEntry *entry = ipdEntryTrackingMisses;
+
+    // A miss of the second index implying the same base address and
+    // shift as a miss of the first one reveals the target array
+    for (unsigned midx = 0; midx < entry->numMisses; midx++) {
+        const std::vector<Addr> &ba_array = entry->baseAddr[midx];
+        for (unsigned idx = 0; idx < shiftValues.size(); idx++) {
+            const int shift = shiftValues[idx];
+            if (ba_array[idx] != miss_addr - indexOffset(entry->idx2, shift)) {
+                continue;
+            }
+
+            PrefetchTableEntry *pt_entry =
+                prefetchTable.findEntry(entry->pc, false);
+            if (pt_entry != nullptr) {
+                DPRINTF(HWPrefetch, "IMP: pattern found for pc %#x, base "
+                        "%#x, shift %d\n", entry->pc, ba_array[idx], shift);
+                pt_entry->baseAddr = ba_array[idx];
+                pt_entry->shift = shift;
+                pt_entry->enabled = true;
+                pt_entry->index = entry->idx2;
+                pt_entry->indirectCounter = prefetchThreshold;
+                // This miss is the target of the current index
+                pt_entry->increasedIndirectCounter = true;
+                patternsDetected++;
+            }
+            ipd.invalidate(entry);
+            ipdEntryTrackingMisses = nullptr;
+            return;
+        }
+    }
+}
+
+void
+IndirectMemoryPredictor::checkAccessMatchOnActiveEntries(Addr addr)
+{
+    for (auto &pt_entry : prefetchTable) {
+        if (pt_entry.isValid() && pt_entry.enabled &&
+            addr == pt_entry.baseAddr +
+                    indexOffset(pt_entry.index, pt_entry.shift)) {
+            if (pt_entry.indirectCounter < maxIndirectCounter) {
+                pt_entry.indirectCounter += 1;
+            }
+            pt_entry.increasedIndirectCounter = true;
+        }
+    }
+}
+
+void
+IndirectMemoryPredictor::checkRecentPrefetches(Addr addr, bool miss)
+{
+    const Addr blk_addr = blockAddress(addr);
+    for (auto it = recentPrefetches.begin(); it != recentPrefetches.end();
+         ++it) {
+        if (*it == blk_addr) {
+            if (miss) {
+                indirectLate++;
+            } else {
+                indirectHits++;
+            }
+            recentPrefetches.erase(it);
+            return;
+        }
+    }
+}
+
+void
+IndirectMemoryPredictor::recordPrefetch(Addr addr)
+{
+    for (const Addr pf_addr : recentPrefetches) {
+        if (pf_addr == addr) {
+            return;
+        }
+    }
+    if (recentPrefetches.size() == trackedPrefetches) {
+        recentPrefetches.pop_front();
+    }
+    recentPrefetches.push_back(addr);
+}
+
+void
+IndirectMemoryPredictor::regStats()
+{
+    SimObject::regStats();
+
+    patternsDetected
+        .name(name() + ".patterns_detected")
+        .desc("number of indirect patterns found")
+        ;
+
+    streamPrefetches
+        .name(name() + ".stream_prefetches")
+        .desc("number of prefetch candidates for the index streams")
+        ;
+
+    indirectPrefetches
+        .name(name() + ".indirect_prefetches")
+        .desc("number of prefetch candidates for the target arrays")
+        ;
+
+    indirectHits
+        .name(name() + ".indirect_hits")
+        .desc("number of demand hits on indirect prefetches")
+        ;
+
+    indirectLate
+        .name(name() + ".indirect_late")
+        .desc("number of demand misses on indirect prefetches")
+        ;
+
+    demandMisses
+        .name(name() + ".demand_misses")
+        .desc("number of demand misses observed")
+        ;
+
+    accuracy
+        .name(name() + ".accuracy")
+        .desc("fraction of the indirect prefetches used by demand accesses")
+        .precision(4)
+        ;
+    accuracy = (indirectHits + indirectLate) / indirectPrefetches;
+
+    coverage
+        .name(name() + ".coverage")
+        .desc("fraction of the misses removed by indirect prefetches")
+        .precision(4)
+        ;
+    coverage = indirectHits / (indirectHits + demandMisses);
+
+    timeliness
+        .name(name() + ".timeliness")
+        .desc("fraction of the used indirect prefetches that were on time")
+        .precision(4)
+        ;
+    timeliness = indirectHits / (indirectHits + indirectLate);
+}
+
+IndirectMemoryPredictor*
+IndirectMemoryPredictorParams::create()
+{
+    return new IndirectMemoryPredictor(this);
+}
+
+IndirectMemoryPrefetcher::IndirectMemoryPrefetcher(
+    const IndirectMemoryPrefetcherParams *p)
+  : QueuedPrefetcher(p), imp(*p->imp)
+{
+    fatal_if(useVirtualAddresses, "%s: the indirect memory prefetcher "
+             "reads the indices from the cache, it requires physical "
+             "addresses\n", name());
+}
+
+void
+IndirectMemoryPrefetcher::calculatePrefetch(const PrefetchInfo &pfi,
+    std::vector<AddrPriority> &addresses)
+{
+    // Index streams are identified by their PC
+    if (!pfi.hasPC()) {
+        return;
+    }
+
+    const bool is_secure = pfi.isSecure();
+    auto read_index = [this, is_secure](Addr addr, unsigned size,
+                                        Addr &index) {
+        uint8_t data[sizeof(uint64_t)];
+        return size <= sizeof(data) &&
+               peekData(addr, is_secure, size, data) &&
+               IndirectMemoryPredictor::decodeIndex(data, size, index);
+    };
+
+    candidates.clear();
+    imp.calculatePrefetch(pfi.getPC(), pfi.getAddr(), pfi.getSize(),
+                          pfi.isWrite(), pfi.isCacheMiss(), read_index,
+                          candidates);
+    for (Addr pf_addr : candidates) {
+        addresses.push_back(AddrPriority(pf_addr, 0));
+    }
+}
+
+IndirectMemoryPrefetcher*
+IndirectMemoryPrefetcherParams::create()
+{
+    return new IndirectMemoryPrefetcher(this);
+}
@@ -0,0 +1,321 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * Implementation of the Indirect Memory Prefetcher
+ *
+ * References:
+ * IMP: Indirect memory prefetcher.
+ * Yu, X., Hughes, C. J., Satish, N., & Devadas, S. (2015, December).
+ * In Proceedings of the 48th International Symposium on Microarchitecture
+ * (pp. 178-190). ACM.
+ *
+ * The prefetcher targets the A[B[i]] accesses of sparse and graph codes
+ * (e.g., CSR traversals). Index loads are detected as PC-localized
+ * streams in the Prefetch Table. The values they read are correlated
+ * with the following cache misses in the Indirect Pattern Detector: two
+ * different index values that map to the same base address with the
+ * same shift reveal the base address of the target array. From then on
+ * the indices found ahead of the stream are read from the cache and
+ * turned into prefetches for the target array.
+ *
+ * As with the DCPT, the main logic lives in a separate SimObject so that
+ * it can be shared by the classic prefetcher and the Ruby one. Its owner
+ * provides the index values through an IndexReader, as the data it can
+ * look at depends on the memory system.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_INDIRECT_MEMORY_HH__
+#define __MEM_CACHE_PREFETCH_INDIRECT_MEMORY_HH__
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/cache/prefetch/associative_set.hh"
+#include "mem/cache/prefetch/queued.hh"
+#include "sim/sim_object.hh"
+
+struct IndirectMemoryPredictorParams;
+
+class IndirectMemoryPredictor : public SimObject
+{
+  public:
+    /**
+     * Read an index of the given size at an address, converted to the
+     * host byte order. Returns false if the data is not available.
+     */
+    typedef std::function<bool(Addr addr, unsigned size, Addr &index)>
+        IndexReader;
+
+    /**
+     * Convert an index stored in guest memory to a host value
+     * @param data pointer to the bytes of the index
+     * @param size size of the index, 1, 2, 4 or 8 bytes
+     * @param index the value read, zero extended
+     * @return false if the size is not supported
+     */
+    static bool decodeIndex(const uint8_t *data, unsigned size, Addr &index);
+
+  private:
+    /** Block size of the memory system */
+    const unsigned blkSize;
+    /** Accesses with the same stride required to consider a stream */
+    const unsigned streamCounterThreshold;
+    /** Number of blocks prefetched ahead of an index stream */
+    const unsigned streamingDistance;
+    /** Number of indices ahead of the stream that are prefetched */
+    const unsigned indirectDistance;
+    /** Maximum value of the indirect confidence counters */
+    const unsigned maxIndirectCounter;
+    /** Confidence required to issue indirect prefetches */
+    const unsigned prefetchThreshold;
+    /** Shift values considered when looking for the target array */
+    const std::vector<int> shiftValues;
+    /** Number of misses recorded per index in the pattern detector */
+    const unsigned addrArraySize;
+    /** Number of recent indirect prefetches tracked for the stats */
+    const unsigned trackedPrefetches;
+
+    /** Prefetch Table entry, one per index load (PC) */
+    struct PrefetchTableEntry : public TaggedEntry
+    {
+        /** Last accessed address */
+        Addr address;
+        /** Last observed stride */
+        int64_t stride;
+        /** Number of consecutive accesses with the same stride */
+        unsigned streamCounter;
+        /** Whether an indirect pattern has been found for this stream */
+        bool enabled;
+        /** Last index read by this stream */
+        Addr index;
+        /** Base address of the target array */
+        Addr baseAddr;
+        /** Shift applied to the indices */
+        int shift;
+        /** Confidence of the indirect pattern */
+        unsigned indirectCounter;
+        /** Whether the pattern has been confirmed since the last index */
+        bool increasedIndirectCounter;
+
+        PrefetchTableEntry() : TaggedEntry(), address(0), stride(0),
+            streamCounter(0), enabled(false), index(0), baseAddr(0),
+            shift(0), indirectCounter(0), increasedIndirectCounter(false)
+        {}
+
+        void reset() override
+        {
+            address = 0;
+            stride = 0;
+            streamCounter = 0;
+            enabled = false;
+            index = 0;
+            baseAddr = 0;
+            shift = 0;
+            indirectCounter = 0;
+            increasedIndirectCounter = false;
+        }
+    };
+    /** Prefetch Table, indexed by the PC of the index loads */
+    AssociativeSet<PrefetchTableEntry> prefetchTable;
+
+    /** Indirect Pattern Detector entry */
+    struct IndirectPatternDetectorEntry : public TaggedEntry
+    {
+        /** PC of the index stream being trained */
+        Addr pc;
+        /** First index */
+        Addr idx1;
+        /** Second index */
+        Addr idx2;
+        /** Valid bit for the second index */
+        bool secondIndexSet;
+        /** Number of misses recorded after the first index */
+        unsigned numMisses;
+        /**
+         * Candidate base addresses, one row per recorded miss and one
+         * column per shift value
+         */
+        std::vector<std::vector<Addr>> baseAddr;
+
+        IndirectPatternDetectorEntry(unsigned int num_addresses,
+                                     unsigned int num_shifts)
+          : TaggedEntry(), pc(0), idx1(0), idx2(0), secondIndexSet(false),
+            numMisses(0),
+            baseAddr(num_addresses, std::vector<Addr>(num_shifts))
+        {}
+
+        void reset() override
+        {
+            pc = 0;
+            idx1 = 0;
+            idx2 = 0;
+            secondIndexSet = false;
+            numMisses = 0;
+        }
+    };
+    /** Indirect Pattern Detector, indexed by the PC of the index loads */
+    AssociativeSet<IndirectPatternDetectorEntry> ipd;
+
+    /** Entry of the detector that is currently recording misses */
+    IndirectPatternDetectorEntry *ipdEntryTrackingMisses;
+
+    /** Recently generated indirect prefetches, block aligned */
+    std::deque<Addr> recentPrefetches;
+
+    /** Block aligned address */
+    Addr blockAddress(Addr addr) const
+    {
+        return addr & ~(Addr(blkSize) - 1);
+    }
+
+    /**
+     * Offset of the target array element of an index, negative shifts
+     * are used for arrays indexed at a finer granularity than a byte
+     * (e.g., bitmaps)
+     */
+    static Addr indexOffset(Addr index, int shift)
+    {
+        return shift >= 0 ? index << shift : index >> -shift;
+    }
+
+    /**
+     * Allocate or update the detector entry of an index stream with a
+     * new index
+     * @param pc the PC of the index stream
+     * @param index the index read by the stream
+     */
+    void allocateOrUpdateIPDEntry(Addr pc, Addr index);
+
+    /**
+     * Record a miss in the detector entry tracking misses, before the
+     * second index has been seen
+     * @param miss_addr address of the miss
+     */
+    void trackMissIndex1(Addr miss_addr);
+
+    /**
+     * Compare a miss against the candidates of the first index, once
+     * the second index has been seen, enabling the stream on a match
+     * @param miss_addr address of the miss
+     */
+    void trackMissIndex2(Addr miss_addr);
+
+    /**
+     * Increase the confidence of the enabled streams that predicted
+     * this access
+     * @param addr address of the access
+     */
+    void checkAccessMatchOnActiveEntries(Addr addr);
+
+    /**
+     * Update the timeliness statistics with a demand access
+     * @param addr address of the access
+     * @param miss whether the access missed
+     */
+    void checkRecentPrefetches(Addr addr, bool miss);
+
+    /**
+     * Remember an indirect prefetch for the timeliness statistics
+     * @param addr block address of the prefetch
+     */
+    void recordPrefetch(Addr addr);
+
+    /** Number of indirect patterns found */
+    Stats::Scalar patternsDetected;
+    /** Prefetch candidates generated for the index streams */
+    Stats::Scalar streamPrefetches;
+    /** Prefetch candidates generated for the target arrays */
+    Stats::Scalar indirectPrefetches;
+    /** Demand accesses that hit on an indirect prefetch */
+    Stats::Scalar indirectHits;
+    /** Demand accesses that missed on a block still being prefetched */
+    Stats::Scalar indirectLate;
+    /** Demand misses observed */
+    Stats::Scalar demandMisses;
+    /** Fraction of indirect prefetches later used by a demand access */
+    Stats::Formula accuracy;
+    /** Fraction of the misses removed by indirect prefetches */
+    Stats::Formula coverage;
+    /** Fraction of the used indirect prefetches that arrived on time */
+    Stats::Formula timeliness;
+
+  public:
+    IndirectMemoryPredictor(const IndirectMemoryPredictorParams *p);
+    ~IndirectMemoryPredictor() {}
+
+    void regStats() override;
+
+    /**
+     * Train the predictor with a demand access and compute the
+     * prefetch candidates.
+     * @param pc PC of the access, it must be valid
+     * @param addr address of the access
+     * @param size size in bytes of the access
+     * @param is_write whether the access is a write
+     * @param miss whether the access missed in the cache
+     * @param read_index functor to read indices from memory
+     * @param addresses prefetch candidates generated
+     */
+    void calculatePrefetch(Addr pc, Addr addr, unsigned size, bool is_write,
+                           bool miss, const IndexReader &read_index,
+                           std::vector<Addr> &addresses);
+};
+
+struct IndirectMemoryPrefetcherParams;
+
+/**
+ * The classic prefetcher using the IMP. Indices are read from the
+ * parent cache, so the prefetcher needs to observe the cache hits and
+ * to work with physical addresses.
+ */
+class IndirectMemoryPrefetcher : public QueuedPrefetcher
+{
+    /** IMP object */
+    IndirectMemoryPredictor &imp;
+    /** Scratch space for the candidates of the IMP */
+    std::vector<Addr> candidates;
+
+  protected:
+    /**
+     * The target arrays are usually in other pages than the indices,
+     * trust the physical layout learnt by the IMP.
+     */
+    bool allowPageCrossing() const override { return true; }
+
+  public:
+    IndirectMemoryPrefetcher(const IndirectMemoryPrefetcherParams *p);
+    ~IndirectMemoryPrefetcher() {}
+
+    void calculatePrefetch(const PrefetchInfo &pfi,
+                           std::vector<AddrPriority> &addresses) override;
+};
+
+#endif//__MEM_CACHE_PREFETCH_INDIRECT_MEMORY_HH__
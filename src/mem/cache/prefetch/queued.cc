@@ -41,18 +41,42 @@
 
 #include <cassert>
 
+#include "base/callback.hh"
 #include "base/logging.hh"
+#include "base/output.hh"
 #include "base/trace.hh"
+#include "config/have_protobuf.hh"
 #include "debug/HWPrefetch.hh"
 #include "mem/request.hh"
 #include "params/QueuedPrefetcher.hh"
+#include "sim/core.hh"
+
+#if HAVE_PROTOBUF
+#include "proto/prefetch_trace.pb.h"
+#include "proto/protoio.hh"
+
+#endif
 
 QueuedPrefetcher::QueuedPrefetcher(const QueuedPrefetcherParams *p)
     : BasePrefetcher(p), queueSize(p->queue_size), latency(p->latency),
       queueSquash(p->queue_squash), queueFilter(p->queue_filter),
-      cacheSnoop(p->cache_snoop), tagPrefetch(p->tag_prefetch)
+      cacheSnoop(p->cache_snoop), tagPrefetch(p->tag_prefetch),
+      traceStream(nullptr)
 {
-
+    if (p->trace_file != "") {
+#if HAVE_PROTOBUF
+        traceStream = new ProtoOutputStream(simout.resolve(p->trace_file));
+
+        // The destructor is not called at exit, make sure the stream
+        // is flushed and closed
+        registerExitCallback(
+            new MakeCallback<QueuedPrefetcher,
+                             &QueuedPrefetcher::closeStreams>(this));
+#else
+        fatal("%s: prefetch traces require gem5 to be built with "
+              "protobuf support\n", name());
+#endif
+    }
 }
 
 QueuedPrefetcher::~QueuedPrefetcher()
@@ -63,6 +87,53 @@ QueuedPrefetcher::~QueuedPrefetcher()
     }
 }
 
+void
+QueuedPrefetcher::startup()
+{
+#if HAVE_PROTOBUF
+    if (traceStream) {
+        ProtoMessage::PrefetchTraceHeader header_msg;
+        header_msg.set_obj_id(name());
+        header_msg.set_tick_freq(SimClock::Frequency);
+        header_msg.set_block_size(blkSize);
+        traceStream->write(header_msg);
+    }
+#endif
+}
+
+void
+QueuedPrefetcher::closeStreams()
+{
+#if HAVE_PROTOBUF
+    delete traceStream;
+    traceStream = nullptr;
+#endif
+}
+
+void
+QueuedPrefetcher::traceAccess(const PacketPtr &pkt, const PrefetchInfo &pfi,
+                              const std::vector<AddrPriority> &addresses)
+{
+#if HAVE_PROTOBUF
+    ProtoMessage::PrefetchTrace trace_msg;
+
+    trace_msg.set_tick(curTick());
+    trace_msg.set_addr(pfi.getAddr());
+    if (pfi.hasPC())
+        trace_msg.set_pc(pfi.getPC());
+    trace_msg.set_master_id(pfi.getMasterId());
+    trace_msg.set_secure(pfi.isSecure());
+    trace_msg.set_write(pkt->isWrite());
+    trace_msg.set_inst(pkt->req->isInstFetch());
+    for (const AddrPriority& addr_prio : addresses) {
+        trace_msg.add_pf_addr(blockAddress(addr_prio.first));
+        trace_msg.add_pf_priority(addr_prio.second);
+    }
+
+    traceStream->write(trace_msg);
+#endif
+}
+
 void
 QueuedPrefetcher::notify(const PacketPtr &pkt, const PrefetchInfo &pfi)
 {
@@ -87,13 +158,18 @@ QueuedPrefetcher::notify(const PacketPtr &pkt, const PrefetchInfo &pfi)
     std::vector<AddrPriority> addresses;
     calculatePrefetch(pfi, addresses);
 
+    if (traceStream) {
+        traceAccess(pkt, pfi, addresses);
+    }
+
     // Queue up generated prefetches
     for (AddrPriority& addr_prio : addresses) {
 
         // Block align prefetch address
         addr_prio.first = blockAddress(addr_prio.first);
 
-        if (samePage(pfi.getAddr(), addr_prio.first)) {
+        if (samePage(pfi.getAddr(), addr_prio.first) ||
+            (!useVirtualAddresses && allowPageCrossing())) {
             PrefetchInfo new_pfi(pfi,addr_prio.first);
 
             pfIdentified++;
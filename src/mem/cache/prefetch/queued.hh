@@ -43,6 +43,7 @@
 #include <cstdint>
 #include <list>
 #include <utility>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "base/types.hh"
@@ -50,9 +51,13 @@
 #include "mem/packet.hh"
 
 struct QueuedPrefetcherParams;
+class ProtoOutputStream;
 
 class QueuedPrefetcher : public BasePrefetcher
 {
+  public:
+    using AddrPriority = std::pair<Addr, int32_t>;
+
   protected:
     struct DeferredPacket {
         /** Prefetch info corresponding to this packet */
@@ -112,6 +117,33 @@ class QueuedPrefetcher : public BasePrefetcher
     /** Tag prefetch with PC of generating access? */
     const bool tagPrefetch;
 
+    /**
+     * Optional trace of the observed accesses and the prefetch
+     * candidates generated for each of them, used to tune and train
+     * prefetchers offline. nullptr if tracing is disabled.
+     */
+    ProtoOutputStream *traceStream;
+
+    /** Flush and close the trace, called at exit */
+    void closeStreams();
+
+    /**
+     * Record an access and the prefetch candidates computed for it.
+     * @param pkt The packet that triggered the prefetcher
+     * @param pfi The information about the access
+     * @param addresses The candidates returned by calculatePrefetch
+     */
+    void traceAccess(const PacketPtr &pkt, const PrefetchInfo &pfi,
+                     const std::vector<AddrPriority> &addresses);
+
+    /**
+     * Whether the candidates may be in another page than the access
+     * that generated them. Only honoured when training on physical
+     * addresses, as the virtual address of another page cannot be
+     * translated.
+     */
+    virtual bool allowPageCrossing() const { return false; }
+
     using const_iterator = std::list<DeferredPacket>::const_iterator;
     const_iterator inPrefetch(const PrefetchInfo &pfi) const;
     using iterator = std::list<DeferredPacket>::iterator;
@@ -125,8 +157,6 @@ class QueuedPrefetcher : public BasePrefetcher
     Stats::Scalar pfSpanPage;
 
   public:
-    using AddrPriority = std::pair<Addr, int32_t>;
-
     QueuedPrefetcher(const QueuedPrefetcherParams *p);
     virtual ~QueuedPrefetcher();
 
@@ -143,6 +173,9 @@ class QueuedPrefetcher : public BasePrefetcher
         return pfq.empty() ? MaxTick : pfq.front().tick;
     }
 
+    /** Write the trace header, once the block size is known */
+    void startup() override;
+
     void regStats() override;
 };
 
@@ -56,12 +56,6 @@ SetAssociative::SetAssociative(const Params *p)
 {
 }
 
-uint32_t
-SetAssociative::extractSet(const Addr addr) const
-{
-    return (addr >> setShift) & setMask;
-}
-
 Addr
 SetAssociative::regenerateAddr(const Addr tag, const ReplaceableEntry* entry)
                                                                         const
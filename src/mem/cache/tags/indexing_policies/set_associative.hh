@@ -81,16 +81,18 @@ class ReplaceableEntry;
  */
 class SetAssociative : public BaseIndexingPolicy
 {
-  private:
+  public:
     /**
      * Apply a hash function to calculate address set.
      *
      * @param addr The address to calculate the set for.
      * @return The set index for given combination of address and way.
      */
-    uint32_t extractSet(const Addr addr) const;
+    uint32_t extractSet(const Addr addr) const
+    {
+        return (addr >> setShift) & setMask;
+    }
 
-  public:
     /**
      * Convenience typedef.
      */
@@ -58,6 +58,7 @@
 
 CoherentXBar::CoherentXBar(const CoherentXBarParams *p)
     : BaseXBar(p), system(p->system), snoopFilter(p->snoop_filter),
+      backInvMasterId(p->system->getMasterId(this, "back_invalidate")),
       snoopResponseLatency(p->snoop_response_latency),
       pointOfCoherency(p->point_of_coherency),
       pointOfUnification(p->point_of_unification)
@@ -223,6 +224,10 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
                     __func__, src_port->name(), pkt->print(),
                     sf_res.first.size(), sf_res.second);
 
+            // make sure any line the filter dropped to make room is
+            // no longer cached above before anyone relies on it
+            backInvalidate(true);
+
             if (pkt->isEviction()) {
                 // for block-evicting packets, i.e. writebacks and
                 // clean evictions, there is no need to snoop up, as
@@ -332,8 +337,8 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
 
             // remember where to route the normal response to
             if (expect_response || expect_snoop_resp) {
-                assert(routeTo.find(pkt->req) == routeTo.end());
-                routeTo[pkt->req] = slave_port_id;
+                assert(routeTo.find(pkt->req) == InvalidPortID);
+                routeTo.insert(pkt->req, slave_port_id);
 
                 panic_if(routeTo.size() > 512,
                          "Routing table exceeds 512 packets\n");
@@ -386,21 +391,19 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
                 assert(rsp_pkt);
 
                 // determine the destination
-                const auto route_lookup = routeTo.find(rsp_pkt->req);
-                assert(route_lookup != routeTo.end());
-                rsp_port_id = route_lookup->second;
+                rsp_port_id = routeTo.find(rsp_pkt->req);
                 assert(rsp_port_id != InvalidPortID);
                 assert(rsp_port_id < respLayers.size());
                 // remove the request from the routing table
-                routeTo.erase(route_lookup);
+                routeTo.erase(rsp_pkt->req);
             }
             outstandingCMO.erase(cmo_lookup);
         } else {
             respond_directly = false;
             outstandingCMO.emplace(pkt->id, deferred_rsp);
             if (!pkt->isWrite()) {
-                assert(routeTo.find(pkt->req) == routeTo.end());
-                routeTo[pkt->req] = slave_port_id;
+                assert(routeTo.find(pkt->req) == InvalidPortID);
+                routeTo.insert(pkt->req, slave_port_id);
 
                 panic_if(routeTo.size() > 512,
                          "Routing table exceeds 512 packets\n");
@@ -440,9 +443,7 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID master_port_id)
     MasterPort *src_port = masterPorts[master_port_id];
 
     // determine the destination
-    const auto route_lookup = routeTo.find(pkt->req);
-    assert(route_lookup != routeTo.end());
-    const PortID slave_port_id = route_lookup->second;
+    const PortID slave_port_id = routeTo.find(pkt->req);
     assert(slave_port_id != InvalidPortID);
     assert(slave_port_id < respLayers.size());
 
@@ -454,6 +455,10 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID master_port_id)
         return false;
     }
 
+    // remove the request from the routing table, the response is
+    // now guaranteed to go through
+    routeTo.erase(pkt->req);
+
     DPRINTF(CoherentXBar, "%s: src %s packet %s\n", __func__,
             src_port->name(), pkt->print());
 
@@ -482,9 +487,6 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID master_port_id)
     pkt->headerDelay = 0;
     slavePorts[slave_port_id]->schedTimingResp(pkt, curTick() + latency);
 
-    // remove the request from the routing table
-    routeTo.erase(route_lookup);
-
     respLayers[slave_port_id]->succeededTiming(packetFinishTime);
 
     // stats updates
@@ -543,8 +545,8 @@ CoherentXBar::recvTimingSnoopReq(PacketPtr pkt, PortID master_port_id)
 
     // if we can expect a response, remember how to route it
     if (!cache_responding && pkt->cacheResponding()) {
-        assert(routeTo.find(pkt->req) == routeTo.end());
-        routeTo[pkt->req] = master_port_id;
+        assert(routeTo.find(pkt->req) == InvalidPortID);
+        routeTo.insert(pkt->req, master_port_id);
     }
 
     // a snoop request came from a connected slave device (one of
@@ -564,9 +566,7 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
     SlavePort* src_port = slavePorts[slave_port_id];
 
     // get the destination
-    const auto route_lookup = routeTo.find(pkt->req);
-    assert(route_lookup != routeTo.end());
-    const PortID dest_port_id = route_lookup->second;
+    const PortID dest_port_id = routeTo.find(pkt->req);
     assert(dest_port_id != InvalidPortID);
 
     // determine if the response is from a snoop request we
@@ -601,6 +601,10 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
     DPRINTF(CoherentXBar, "%s: src %s packet %s\n", __func__,
             src_port->name(), pkt->print());
 
+    // remove the request from the routing table, this has to happen
+    // before forwarding as the packet may be gone after that
+    routeTo.erase(pkt->req);
+
     // store size and command as they might be modified when
     // forwarding the packet
     unsigned int pkt_size = pkt->hasData() ? pkt->getSize() : 0;
@@ -671,9 +675,6 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID slave_port_id)
         respLayers[dest_port_id]->succeededTiming(packetFinishTime);
     }
 
-    // remove the request from the routing table
-    routeTo.erase(route_lookup);
-
     // stats updates
     transDist[pkt_cmd]++;
     snoops++;
@@ -711,6 +712,37 @@ CoherentXBar::forwardTiming(PacketPtr pkt, PortID exclude_slave_port_id,
     snoopFanout.sample(fanout);
 }
 
+void
+CoherentXBar::backInvalidate(bool is_timing)
+{
+    SnoopFilter::Eviction victim;
+    if (!snoopFilter->takeEviction(victim))
+        return;
+
+    DPRINTF(CoherentXBar, "%s: addr %#x holders %d\n", __func__,
+            victim.addr, victim.holders.size());
+
+    RequestPtr req = std::make_shared<Request>(
+        victim.addr, system->cacheLineSize(),
+        victim.isSecure ? Request::SECURE : 0, backInvMasterId);
+    Packet pkt(req, MemCmd::CleanInvalidReq);
+    if (is_timing)
+        pkt.setExpressSnoop();
+
+    for (const auto& p : victim.holders) {
+        if (is_timing) {
+            p->sendTimingSnoopReq(&pkt);
+        } else {
+            p->sendAtomicSnoop(&pkt);
+        }
+        // cleaning snoops never get a data response, any dirty copy
+        // comes back down as a WriteClean
+        assert(!pkt.cacheResponding());
+        pkt.snoopDelay = 0;
+        backInvalidations++;
+    }
+}
+
 void
 CoherentXBar::recvReqRetry(PortID master_port_id)
 {
@@ -757,6 +789,7 @@ CoherentXBar::recvAtomic(PacketPtr pkt, PortID slave_port_id)
             // avoid situations where atomic upward snoops sneak in
             // between and change the filter state
             snoopFilter->finishRequest(false, pkt->getAddr(), pkt->isSecure());
+            backInvalidate(false);
 
             if (pkt->isEviction()) {
                 // for block-evicting packets, i.e. writebacks and
@@ -1124,6 +1157,11 @@ CoherentXBar::regStats()
         .name(name() + ".snoop_fanout")
         .desc("Request fanout histogram")
     ;
+
+    backInvalidations
+        .name(name() + ".back_invalidations")
+        .desc("Total back-invalidation snoops for snoop filter evictions")
+    ;
 }
 
 CoherentXBar *
@@ -280,6 +280,9 @@ class CoherentXBar : public BaseXBar
       * broadcast needed for probes.  NULL denotes an absent filter. */
     SnoopFilter *snoopFilter;
 
+    /** Master id used for back-invalidations of snoop filter victims */
+    const MasterID backInvMasterId;
+
     /** Cycles of snoop response latency.*/
     const Cycles snoopResponseLatency;
 
@@ -339,6 +342,16 @@ class CoherentXBar : public BaseXBar
     void forwardTiming(PacketPtr pkt, PortID exclude_slave_port_id,
                        const std::vector<QueuedSlavePort*>& dests);
 
+    /**
+     * Back-invalidate the holders of a line evicted from the snoop
+     * filter by the last lookupRequest, if any. The invalidation is a
+     * cache clean and invalidate, so dirty copies are written back
+     * through the crossbar as WriteCleans rather than responded to.
+     *
+     * @param is_timing Use timing (express) or atomic snoops
+     */
+    void backInvalidate(bool is_timing);
+
     /** Function called by the port when the crossbar is recieving a Atomic
       transaction.*/
     Tick recvAtomic(PacketPtr pkt, PortID slave_port_id);
@@ -432,6 +445,7 @@ class CoherentXBar : public BaseXBar
     Stats::Scalar snoops;
     Stats::Scalar snoopTraffic;
     Stats::Distribution snoopFanout;
+    Stats::Scalar backInvalidations;
 
   public:
 
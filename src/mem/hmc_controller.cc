@@ -103,8 +103,8 @@ bool HMCController::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
 
     // remember where to route the response to
     if (expect_response) {
-        assert(routeTo.find(pkt->req) == routeTo.end());
-        routeTo[pkt->req] = slave_port_id;
+        assert(routeTo.find(pkt->req) == InvalidPortID);
+        routeTo.insert(pkt->req, slave_port_id);
     }
 
     reqLayers[master_port_id]->succeededTiming(packetFinishTime);
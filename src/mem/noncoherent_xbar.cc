@@ -163,8 +163,8 @@ NoncoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
 
     // remember where to route the response to
     if (expect_response) {
-        assert(routeTo.find(pkt->req) == routeTo.end());
-        routeTo[pkt->req] = slave_port_id;
+        assert(routeTo.find(pkt->req) == InvalidPortID);
+        routeTo.insert(pkt->req, slave_port_id);
     }
 
     reqLayers[master_port_id]->succeededTiming(packetFinishTime);
@@ -184,9 +184,7 @@ NoncoherentXBar::recvTimingResp(PacketPtr pkt, PortID master_port_id)
     MasterPort *src_port = masterPorts[master_port_id];
 
     // determine the destination
-    const auto route_lookup = routeTo.find(pkt->req);
-    assert(route_lookup != routeTo.end());
-    const PortID slave_port_id = route_lookup->second;
+    const PortID slave_port_id = routeTo.find(pkt->req);
     assert(slave_port_id != InvalidPortID);
     assert(slave_port_id < respLayers.size());
 
@@ -222,7 +220,7 @@ NoncoherentXBar::recvTimingResp(PacketPtr pkt, PortID master_port_id)
     slavePorts[slave_port_id]->schedTimingResp(pkt, curTick() + latency);
 
     // remove the request from the routing table
-    routeTo.erase(route_lookup);
+    routeTo.erase(pkt->req);
 
     respLayers[slave_port_id]->succeededTiming(packetFinishTime);
 
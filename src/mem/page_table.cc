@@ -37,14 +37,198 @@
  */
 #include "mem/page_table.hh"
 
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
 #include <string>
 
 #include "base/compiler.hh"
 #include "base/trace.hh"
+#include "debug/Checkpoint.hh"
 #include "debug/MMU.hh"
 #include "sim/faults.hh"
 #include "sim/serialize.hh"
 
+namespace
+{
+
+/** On-disk record of a run of contiguous mappings. */
+struct MappingRun
+{
+    uint64_t vaddr;
+    uint64_t paddr;
+    uint64_t npages;
+    uint64_t flags;
+};
+
+} // anonymous namespace
+
+EmulationPageTable::Node::Node(bool leaf)
+    : count(0)
+{
+    if (leaf)
+        entries.reset(new Entry[Fanout]);
+    else
+        children.reset(new std::unique_ptr<Node>[Fanout]);
+}
+
+EmulationPageTable::EmulationPageTable(
+        const std::string &__name, uint64_t _pid, Addr _pageSize) :
+        pageSize(_pageSize), offsetMask(mask(floorLog2(_pageSize))),
+        pageShift(floorLog2(_pageSize)),
+        numLevels(divCeil(sizeof(Addr) * 8 - floorLog2(_pageSize),
+                          LevelBits)),
+        numPages(0), _epoch(newEpoch()), _pid(_pid), _name(__name)
+{
+    assert(isPowerOf2(pageSize));
+}
+
+EmulationPageTable::~EmulationPageTable()
+{
+}
+
+uint64_t
+EmulationPageTable::newEpoch()
+{
+    static std::atomic<uint64_t> nextEpoch(0);
+    return nextEpoch++;
+}
+
+void
+EmulationPageTable::TranslationCache::flush()
+{
+    for (auto &e : entries)
+        e.vpn = MaxAddr;
+}
+
+EmulationPageTable::Node *
+EmulationPageTable::findLeaf(Addr vpn, bool create)
+{
+    if (!root) {
+        if (!create)
+            return nullptr;
+        root.reset(new Node(numLevels == 1));
+    }
+
+    Node *node = root.get();
+    for (unsigned level = 0; level < numLevels - 1; ++level) {
+        std::unique_ptr<Node> &child = node->children[levelIndex(vpn, level)];
+        if (!child) {
+            if (!create)
+                return nullptr;
+            child.reset(new Node(level == numLevels - 2));
+            node->count++;
+        }
+        node = child.get();
+    }
+    return node;
+}
+
+const EmulationPageTable::Node *
+EmulationPageTable::findLeaf(Addr vpn) const
+{
+    const Node *node = root.get();
+    for (unsigned level = 0; node && level < numLevels - 1; ++level)
+        node = node->children[levelIndex(vpn, level)].get();
+    return node;
+}
+
+EmulationPageTable::Entry *
+EmulationPageTable::findEntry(Addr vpn)
+{
+    Node *leaf = findLeaf(vpn, false);
+    unsigned idx = vpn & (Fanout - 1);
+    return leaf && leaf->valid[idx] ? &leaf->entries[idx] : nullptr;
+}
+
+void
+EmulationPageTable::eraseLeafRun(Addr vpn, unsigned npages)
+{
+    // Remember the path so that nodes that become empty can be freed
+    // on the way back up.
+    Node *path[sizeof(Addr) * 8];
+    Node *node = root.get();
+    for (unsigned level = 0; level < numLevels - 1; ++level) {
+        path[level] = node;
+        node = node ? node->children[levelIndex(vpn, level)].get() : nullptr;
+    }
+
+    // Pages that are not mapped are skipped, like munmap does
+    if (!node)
+        return;
+
+    unsigned idx = vpn & (Fanout - 1);
+    assert(idx + npages <= Fanout);
+    for (unsigned i = idx; i < idx + npages; ++i) {
+        if (node->valid[i]) {
+            node->valid.reset(i);
+            node->count--;
+            numPages--;
+        }
+    }
+
+    for (int level = numLevels - 2; level >= 0 && node->count == 0;
+         --level) {
+        node = path[level];
+        node->children[levelIndex(vpn, level)].reset();
+        node->count--;
+    }
+    if (root && root->count == 0)
+        root.reset();
+}
+
+template <class F>
+void
+EmulationPageTable::forEachMapping(const Node *node, unsigned level, Addr vpn,
+                                   F &f) const
+{
+    if (level == numLevels - 1) {
+        for (unsigned i = 0; i < Fanout; ++i) {
+            if (node->valid[i])
+                f((vpn | i) << pageShift, node->entries[i]);
+        }
+        return;
+    }
+
+    for (unsigned i = 0; i < Fanout; ++i) {
+        const Node *child = node->children[i].get();
+        if (child)
+            forEachMapping(child, level + 1, (vpn | i) << LevelBits, f);
+    }
+}
+
+void
+EmulationPageTable::insert(Addr vpn, Addr paddr, Addr npages, uint64_t flags,
+                           bool clobber)
+{
+    // Fill one leaf at a time rather than walking the tree per page.
+    while (npages > 0) {
+        Node *leaf = findLeaf(vpn, true);
+        unsigned idx = vpn & (Fanout - 1);
+        unsigned run = std::min<Addr>(npages, Fanout - idx);
+
+        for (unsigned i = idx; i < idx + run; ++i) {
+            if (leaf->valid[i]) {
+                // already mapped
+                panic_if(!clobber,
+                         "EmulationPageTable::allocate: addr %#x already "
+                         "mapped", (vpn + i - idx) << pageShift);
+                _epoch = newEpoch();
+            } else {
+                leaf->valid.set(i);
+                leaf->count++;
+                numPages++;
+            }
+            leaf->entries[i] = Entry(paddr, flags);
+            paddr += pageSize;
+        }
+
+        vpn += run;
+        npages -= run;
+    }
+}
+
 void
 EmulationPageTable::map(Addr vaddr, Addr paddr, int64_t size, uint64_t flags)
 {
@@ -54,22 +238,8 @@ EmulationPageTable::map(Addr vaddr, Addr paddr, int64_t size, uint64_t flags)
 
     DPRINTF(MMU, "Allocating Page: %#x-%#x\n", vaddr, vaddr + size);
 
-    while (size > 0) {
-        auto it = pTable.find(vaddr);
-        if (it != pTable.end()) {
-            // already mapped
-            panic_if(!clobber,
-                     "EmulationPageTable::allocate: addr %#x already mapped",
-                     vaddr);
-            it->second = Entry(paddr, flags);
-        } else {
-            pTable.emplace(vaddr, Entry(paddr, flags));
-        }
-
-        size -= pageSize;
-        vaddr += pageSize;
-        paddr += pageSize;
-    }
+    insert(vaddr >> pageShift, paddr,
+           divCeil(std::max<int64_t>(size, 0), pageSize), flags, clobber);
 }
 
 void
@@ -81,13 +251,19 @@ EmulationPageTable::remap(Addr vaddr, int64_t size, Addr new_vaddr)
     DPRINTF(MMU, "moving pages from vaddr %08p to %08p, size = %d\n", vaddr,
             new_vaddr, size);
 
+    _epoch = newEpoch();
+
     while (size > 0) {
-        auto new_it M5_VAR_USED = pTable.find(new_vaddr);
-        auto old_it = pTable.find(vaddr);
-        assert(old_it != pTable.end() && new_it == pTable.end());
+        Addr vpn = vaddr >> pageShift;
+        Addr new_vpn = new_vaddr >> pageShift;
+
+        Entry *old_entry = findEntry(vpn);
+        assert(old_entry && !findEntry(new_vpn));
+        Entry entry = *old_entry;
+        eraseLeafRun(vpn, 1);
+
+        insert(new_vpn, entry.paddr, 1, entry.flags, false);
 
-        pTable.emplace(new_vaddr, old_it->second);
-        pTable.erase(old_it);
         size -= pageSize;
         vaddr += pageSize;
         new_vaddr += pageSize;
@@ -97,8 +273,10 @@ EmulationPageTable::remap(Addr vaddr, int64_t size, Addr new_vaddr)
 void
 EmulationPageTable::getMappings(std::vector<std::pair<Addr, Addr>> *addr_maps)
 {
-    for (auto &iter : pTable)
-        addr_maps->push_back(std::make_pair(iter.first, iter.second.paddr));
+    addr_maps->reserve(addr_maps->size() + numPages);
+    forEachMapping([addr_maps](Addr vaddr, const Entry &entry) {
+        addr_maps->push_back(std::make_pair(vaddr, entry.paddr));
+    });
 }
 
 void
@@ -108,12 +286,16 @@ EmulationPageTable::unmap(Addr vaddr, int64_t size)
 
     DPRINTF(MMU, "Unmapping page: %#x-%#x\n", vaddr, vaddr + size);
 
-    while (size > 0) {
-        auto it = pTable.find(vaddr);
-        assert(it != pTable.end());
-        pTable.erase(it);
-        size -= pageSize;
-        vaddr += pageSize;
+    _epoch = newEpoch();
+
+    Addr vpn = vaddr >> pageShift;
+    Addr npages = divCeil(std::max<int64_t>(size, 0), pageSize);
+
+    while (npages > 0) {
+        unsigned run = std::min<Addr>(npages, Fanout - (vpn & (Fanout - 1)));
+        eraseLeafRun(vpn, run);
+        vpn += run;
+        npages -= run;
     }
 }
 
@@ -123,9 +305,23 @@ EmulationPageTable::isUnmapped(Addr vaddr, int64_t size)
     // starting address must be page aligned
     assert(pageOffset(vaddr) == 0);
 
-    for (int64_t offset = 0; offset < size; offset += pageSize)
-        if (pTable.find(vaddr + offset) != pTable.end())
-            return false;
+    Addr vpn = vaddr >> pageShift;
+    Addr npages = divCeil(std::max<int64_t>(size, 0), pageSize);
+
+    while (npages > 0) {
+        const Node *leaf = findLeaf(vpn);
+        unsigned idx = vpn & (Fanout - 1);
+        unsigned run = std::min<Addr>(npages, Fanout - idx);
+
+        if (leaf) {
+            for (unsigned i = idx; i < idx + run; ++i)
+                if (leaf->valid[i])
+                    return false;
+        }
+
+        vpn += run;
+        npages -= run;
+    }
 
     return true;
 }
@@ -133,33 +329,39 @@ EmulationPageTable::isUnmapped(Addr vaddr, int64_t size)
 const EmulationPageTable::Entry *
 EmulationPageTable::lookup(Addr vaddr)
 {
-    Addr page_addr = pageAlign(vaddr);
-    PTableItr iter = pTable.find(page_addr);
-    if (iter == pTable.end())
-        return nullptr;
-    return &(iter->second);
+    return findEntry(vaddr >> pageShift);
 }
 
 bool
-EmulationPageTable::translate(Addr vaddr, Addr &paddr)
+EmulationPageTable::translate(Addr vaddr, Addr &paddr,
+                              TranslationCache *cache)
 {
-    const Entry *entry = lookup(vaddr);
-    if (!entry) {
-        DPRINTF(MMU, "Couldn't Translate: %#x\n", vaddr);
-        return false;
+    Addr vpn = vaddr >> pageShift;
+    Addr page_paddr = cache ? cache->lookup(*this, vpn) : MaxAddr;
+
+    if (page_paddr == MaxAddr) {
+        const Entry *entry = findEntry(vpn);
+        if (!entry) {
+            DPRINTF(MMU, "Couldn't Translate: %#x\n", vaddr);
+            return false;
+        }
+        page_paddr = entry->paddr;
+        if (cache)
+            cache->insert(vpn, page_paddr);
     }
-    paddr = pageOffset(vaddr) + entry->paddr;
+
+    paddr = pageOffset(vaddr) + page_paddr;
     DPRINTF(MMU, "Translating: %#x->%#x\n", vaddr, paddr);
     return true;
 }
 
 Fault
-EmulationPageTable::translate(const RequestPtr &req)
+EmulationPageTable::translate(const RequestPtr &req, TranslationCache *cache)
 {
     Addr paddr;
     assert(pageAlign(req->getVaddr() + req->getSize() - 1) ==
            pageAlign(req->getVaddr()));
-    if (!translate(req->getVaddr(), paddr))
+    if (!translate(req->getVaddr(), paddr, cache))
         return Fault(new GenericPageTableFault(req->getVaddr()));
     req->setPaddr(paddr);
     if ((paddr & (pageSize - 1)) + req->getSize() > pageSize) {
@@ -172,36 +374,93 @@ EmulationPageTable::translate(const RequestPtr &req)
 void
 EmulationPageTable::serialize(CheckpointOut &cp) const
 {
-    paramOut(cp, "ptable.size", pTable.size());
+    std::string filename = Serializable::currentSection() + ".ptable";
+    std::string filepath = CheckpointIn::dir() + "/" + filename;
 
-    PTable::size_type count = 0;
-    for (auto &pte : pTable) {
-        ScopedCheckpointSection sec(cp, csprintf("Entry%d", count++));
+    DPRINTF(Checkpoint, "Serializing %d page mappings to %s\n",
+            numPages, filename);
 
-        paramOut(cp, "vaddr", pte.first);
-        paramOut(cp, "paddr", pte.second.paddr);
-        paramOut(cp, "flags", pte.second.flags);
-    }
-    assert(count == pTable.size());
+    gzFile file = gzopen(filepath.c_str(), "wb");
+    fatal_if(file == NULL, "Can't open page table checkpoint file '%s'\n",
+             filename);
+
+    // Coalesce the mappings into runs of virtually and physically
+    // contiguous pages with identical flags while walking the tree.
+    MappingRun run = { 0, 0, 0, 0 };
+    uint64_t runs = 0;
+    auto flush_run = [&]() {
+        if (run.npages == 0)
+            return;
+        fatal_if(gzwrite(file, &run, sizeof(run)) != sizeof(run),
+                 "Write failed on page table checkpoint file '%s'\n",
+                 filename);
+        runs++;
+    };
+
+    forEachMapping([&](Addr vaddr, const Entry &entry) {
+        if (run.npages != 0 &&
+            vaddr == run.vaddr + run.npages * pageSize &&
+            entry.paddr == run.paddr + run.npages * pageSize &&
+            entry.flags == run.flags) {
+            run.npages++;
+            return;
+        }
+        flush_run();
+        run = { vaddr, entry.paddr, 1, entry.flags };
+    });
+    flush_run();
+
+    fatal_if(gzclose(file), "Close failed on page table checkpoint file "
+             "'%s'\n", filename);
+
+    paramOut(cp, "ptable.size", numPages);
+    paramOut(cp, "ptable.file", filename);
+    paramOut(cp, "ptable.runs", runs);
 }
 
 void
 EmulationPageTable::unserialize(CheckpointIn &cp)
 {
-    int count;
-    paramIn(cp, "ptable.size", count);
+    _epoch = newEpoch();
+
+    std::string filename;
+    if (!optParamIn(cp, "ptable.file", filename, false)) {
+        // Checkpoint with one section per mapping
+        int count;
+        paramIn(cp, "ptable.size", count);
+
+        for (int i = 0; i < count; ++i) {
+            ScopedCheckpointSection sec(cp, csprintf("Entry%d", i));
 
-    for (int i = 0; i < count; ++i) {
-        ScopedCheckpointSection sec(cp, csprintf("Entry%d", i));
+            Addr vaddr;
+            UNSERIALIZE_SCALAR(vaddr);
+            Addr paddr;
+            uint64_t flags;
+            UNSERIALIZE_SCALAR(paddr);
+            UNSERIALIZE_SCALAR(flags);
 
-        Addr vaddr;
-        UNSERIALIZE_SCALAR(vaddr);
-        Addr paddr;
-        uint64_t flags;
-        UNSERIALIZE_SCALAR(paddr);
-        UNSERIALIZE_SCALAR(flags);
+            insert(vaddr >> pageShift, paddr, 1, flags, true);
+        }
+        return;
+    }
+
+    uint64_t runs;
+    paramIn(cp, "ptable.runs", runs);
 
-        pTable.emplace(vaddr, Entry(paddr, flags));
+    std::string filepath = cp.cptDir + "/" + filename;
+    gzFile file = gzopen(filepath.c_str(), "rb");
+    fatal_if(file == NULL, "Can't open page table checkpoint file '%s'",
+             filename);
+
+    for (uint64_t i = 0; i < runs; ++i) {
+        MappingRun run;
+        fatal_if(gzread(file, &run, sizeof(run)) != sizeof(run),
+                 "Read failed on page table checkpoint file '%s'\n",
+                 filename);
+        insert(run.vaddr >> pageShift, run.paddr, run.npages, run.flags,
+               true);
     }
-}
 
+    fatal_if(gzclose(file), "Close failed on page table checkpoint file "
+             "'%s'\n", filename);
+}
@@ -37,8 +37,10 @@
 #ifndef __MEM_PAGE_TABLE_HH__
 #define __MEM_PAGE_TABLE_HH__
 
+#include <bitset>
+#include <memory>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 #include "base/intmath.hh"
 #include "base/types.hh"
@@ -59,30 +61,113 @@ class EmulationPageTable : public Serializable
         Entry() {}
     };
 
+    class TranslationCache;
+
   protected:
-    typedef std::unordered_map<Addr, Entry> PTable;
-    typedef PTable::iterator PTableItr;
-    PTable pTable;
+    /**
+     * The mappings are kept in a radix tree indexed by virtual page
+     * number. Each level resolves LevelBits of the page number, and
+     * the leaves hold the entries themselves, so a dense region of
+     * the address space costs little more than its entries.
+     */
+    static const unsigned LevelBits = 9;
+    static const unsigned Fanout = 1 << LevelBits;
+
+    struct Node
+    {
+        /** Number of live children (interior) or entries (leaf). */
+        unsigned count;
+        /** Children of an interior node, null for a leaf. */
+        std::unique_ptr<std::unique_ptr<Node>[]> children;
+        /** Entries of a leaf, null for an interior node. */
+        std::unique_ptr<Entry[]> entries;
+        /** Which entries of a leaf are mapped. */
+        std::bitset<Fanout> valid;
+
+        Node(bool leaf);
+    };
 
     const Addr pageSize;
     const Addr offsetMask;
+    const unsigned pageShift;
+
+    /** Number of levels needed to cover the virtual page number. */
+    const unsigned numLevels;
+
+    std::unique_ptr<Node> root;
+
+    /** Number of pages currently mapped. */
+    uint64_t numPages;
+
+    /**
+     * Tag identifying the current set of mappings. It changes
+     * whenever an existing mapping is removed or modified, and is
+     * unique across all page tables, so translation caches can tell
+     * when they must be flushed.
+     */
+    uint64_t _epoch;
 
     const uint64_t _pid;
     const std::string _name;
 
-  public:
+    /** Get a fresh, globally unique epoch. */
+    static uint64_t newEpoch();
 
-    EmulationPageTable(
-            const std::string &__name, uint64_t _pid, Addr _pageSize) :
-            pageSize(_pageSize), offsetMask(mask(floorLog2(_pageSize))),
-            _pid(_pid), _name(__name)
+    unsigned
+    levelIndex(Addr vpn, unsigned level) const
+    {
+        return (vpn >> ((numLevels - 1 - level) * LevelBits)) &
+            (Fanout - 1);
+    }
+
+    /**
+     * Find the leaf covering a virtual page number.
+     * @param create Allocate the missing nodes on the way.
+     * @return The leaf, or nullptr if it does not exist.
+     */
+    Node *findLeaf(Addr vpn, bool create);
+    const Node *findLeaf(Addr vpn) const;
+
+    /** Look up the entry of a virtual page number, if mapped. */
+    Entry *findEntry(Addr vpn);
+
+    /**
+     * Map a run of pages to physically contiguous memory.
+     * @param clobber Whether existing mappings may be replaced.
+     */
+    void insert(Addr vpn, Addr paddr, Addr npages, uint64_t flags,
+                bool clobber);
+
+    /**
+     * Remove a run of mappings that lies within a single leaf, and
+     * free the leaf and any interior nodes that become empty. Pages
+     * of the run that are not mapped are left alone.
+     */
+    void eraseLeafRun(Addr vpn, unsigned npages);
+
+    /**
+     * Visit every mapping in ascending virtual address order.
+     * @param f Called with the virtual page address and the entry.
+     */
+    template <class F>
+    void forEachMapping(F f) const
     {
-        assert(isPowerOf2(pageSize));
+        if (root)
+            forEachMapping(root.get(), 0, 0, f);
     }
 
+    template <class F>
+    void forEachMapping(const Node *node, unsigned level, Addr vpn,
+                        F &f) const;
+
+  public:
+
+    EmulationPageTable(
+            const std::string &__name, uint64_t _pid, Addr _pageSize);
+
     uint64_t pid() const { return _pid; };
 
-    virtual ~EmulationPageTable() {};
+    virtual ~EmulationPageTable();
 
     /* generic page table mapping flags
      *              unset | set
@@ -104,6 +189,9 @@ class EmulationPageTable : public Serializable
     Addr pageAlign(Addr a)  { return (a & ~offsetMask); }
     Addr pageOffset(Addr a) { return (a &  offsetMask); }
 
+    /** Tag of the current set of mappings, see TranslationCache. */
+    uint64_t epoch() const { return _epoch; }
+
     /**
      * Maps a virtual memory region to a physical memory region.
      * @param vaddr The starting virtual address of the region.
@@ -135,9 +223,11 @@ class EmulationPageTable : public Serializable
      * Translate function
      * @param vaddr The virtual address.
      * @param paddr Physical address from translation.
+     * @param cache Optional translation cache to look in first.
      * @return True if translation exists
      */
-    bool translate(Addr vaddr, Addr &paddr);
+    bool translate(Addr vaddr, Addr &paddr,
+                   TranslationCache *cache = nullptr);
 
     /**
      * Simplified translate function (just check for translation)
@@ -150,13 +240,72 @@ class EmulationPageTable : public Serializable
      * Perform a translation on the memory request, fills in paddr
      * field of req.
      * @param req The memory request.
+     * @param cache Optional translation cache to look in first.
      */
-    Fault translate(const RequestPtr &req);
+    Fault translate(const RequestPtr &req,
+                    TranslationCache *cache = nullptr);
 
     void getMappings(std::vector<std::pair<Addr, Addr>> *addr_mappings);
 
+    /**
+     * The mappings are written as runs of contiguous pages to a
+     * separate compressed file in the checkpoint directory, streamed
+     * straight from the tree. Checkpoints that store one section per
+     * mapping are still understood by unserialize().
+     */
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
 };
 
+/**
+ * A small direct-mapped cache of page table translations. Each user
+ * that translates often, such as a thread's memory proxy or a TLB in
+ * SE mode, keeps its own so that most translations skip the tree
+ * walk. A cache may be used with several page tables; it is flushed
+ * whenever the epoch of the table it is used with changes.
+ */
+class EmulationPageTable::TranslationCache
+{
+  private:
+    static const unsigned NumEntries = 64;
+
+    struct CacheEntry
+    {
+        Addr vpn;
+        Addr paddr;
+    };
+
+    CacheEntry entries[NumEntries];
+
+    /** Epoch of the page table the entries came from. */
+    uint64_t epoch;
+
+    void flush();
+
+  public:
+    TranslationCache() : epoch(0) { flush(); }
+
+    /**
+     * Look up a virtual page number, flushing the cache first if the
+     * mappings of the table have changed since it was filled.
+     * @return The physical page address, or MaxAddr on a miss.
+     */
+    Addr
+    lookup(const EmulationPageTable &pt, Addr vpn)
+    {
+        if (pt.epoch() != epoch) {
+            flush();
+            epoch = pt.epoch();
+        }
+        const CacheEntry &e = entries[vpn % NumEntries];
+        return e.vpn == vpn ? e.paddr : MaxAddr;
+    }
+
+    void
+    insert(Addr vpn, Addr paddr)
+    {
+        entries[vpn % NumEntries] = { vpn, paddr };
+    }
+};
+
 #endif // __MEM_PAGE_TABLE_HH__
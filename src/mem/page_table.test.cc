@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <utility>
+#include <vector>
+
+#include "base/debug.hh"
+#include "base/trace.hh"
+#include "mem/page_table.hh"
+#include "sim/faults.hh"
+#include "sim/serialize.hh"
+
+// The page table is linked on its own, so provide what it uses from
+// the rest of the simulator. Checkpoints and tracing are not tested.
+namespace Debug {
+SimpleFlag Checkpoint("Checkpoint", "");
+SimpleFlag MMU("MMU", "");
+}
+namespace Trace {
+Logger *getDebugLogger() { return nullptr; }
+std::string &argBuffer() { static std::string buf; return buf; }
+}
+__thread EventQueue *_curEventQueue = nullptr;
+bool ObjectMatch::domatch(const std::string &name) const { return false; }
+Serializable::Serializable() {}
+Serializable::~Serializable() {}
+const std::string &Serializable::currentSection()
+{ static std::string section; return section; }
+void Serializable::ScopedCheckpointSection::pushName(const char *) {}
+Serializable::ScopedCheckpointSection::~ScopedCheckpointSection() {}
+std::string CheckpointIn::dir() { return ""; }
+bool CheckpointIn::find(const std::string &, const std::string &,
+                        std::string &) { return false; }
+void FaultBase::invoke(ThreadContext *, const StaticInstPtr &) {}
+void GenericPageTableFault::invoke(ThreadContext *, const StaticInstPtr &) {}
+
+namespace {
+
+const Addr PageBytes = 4096;
+/** Bytes covered by a leaf of the tree with 4 kB pages. */
+const Addr LeafBytes = 512 * PageBytes;
+
+/** Exposes the tree to check which nodes are allocated. */
+class TestPageTable : public EmulationPageTable
+{
+  public:
+    TestPageTable() : EmulationPageTable("pt", 0, PageBytes) {}
+
+    bool empty() const { return !root; }
+
+    /** Number of leaves in the tree. */
+    unsigned leaves() const { return root ? leaves(root.get(), 0) : 0; }
+
+    uint64_t pages() const { return numPages; }
+
+  private:
+    unsigned
+    leaves(const Node *node, unsigned level) const
+    {
+        if (level == numLevels - 1)
+            return 1;
+        unsigned n = 0;
+        for (unsigned i = 0; i < Fanout; i++) {
+            if (node->children[i])
+                n += leaves(node->children[i].get(), level + 1);
+        }
+        return n;
+    }
+};
+
+} // anonymous namespace
+
+TEST(PageTableTest, MapLookup)
+{
+    TestPageTable pt;
+    pt.map(0x400000, 0x10000, 3 * PageBytes);
+
+    const EmulationPageTable::Entry *entry = pt.lookup(0x401000);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->paddr, 0x11000);
+
+    Addr paddr;
+    EXPECT_TRUE(pt.translate(0x402abc, paddr));
+    EXPECT_EQ(paddr, 0x12abc);
+    EXPECT_FALSE(pt.translate(0x403000, paddr));
+    EXPECT_EQ(pt.lookup(0x3ff000), nullptr);
+    EXPECT_EQ(pt.pages(), 3);
+}
+
+/** A region across a leaf boundary is split over two leaves */
+TEST(PageTableTest, MapAcrossNodes)
+{
+    TestPageTable pt;
+    Addr vaddr = LeafBytes - 2 * PageBytes;
+    pt.map(vaddr, 0x80000, 4 * PageBytes);
+
+    EXPECT_EQ(pt.leaves(), 2);
+    for (int i = 0; i < 4; i++) {
+        Addr paddr;
+        ASSERT_TRUE(pt.translate(vaddr + i * PageBytes, paddr));
+        EXPECT_EQ(paddr, 0x80000 + i * PageBytes);
+    }
+    EXPECT_FALSE(pt.isUnmapped(vaddr - PageBytes, 2 * PageBytes));
+    EXPECT_TRUE(pt.isUnmapped(vaddr + 4 * PageBytes, LeafBytes));
+
+    std::vector<std::pair<Addr, Addr>> mappings;
+    pt.getMappings(&mappings);
+    ASSERT_EQ(mappings.size(), 4);
+    EXPECT_EQ(mappings.front(), std::make_pair(vaddr, Addr(0x80000)));
+    EXPECT_EQ(mappings.back(),
+              std::make_pair(vaddr + 3 * PageBytes, Addr(0x83000)));
+}
+
+TEST(PageTableTest, Remap)
+{
+    TestPageTable pt;
+    pt.map(0x1000, 0x20000, 2 * PageBytes);
+    uint64_t epoch = pt.epoch();
+
+    pt.remap(0x1000, 2 * PageBytes, 3 * LeafBytes);
+    EXPECT_NE(pt.epoch(), epoch);
+    EXPECT_TRUE(pt.isUnmapped(0x1000, 2 * PageBytes));
+    EXPECT_EQ(pt.leaves(), 1);
+
+    Addr paddr;
+    ASSERT_TRUE(pt.translate(3 * LeafBytes + PageBytes, paddr));
+    EXPECT_EQ(paddr, 0x21000);
+    EXPECT_EQ(pt.pages(), 2);
+}
+
+/** Unmapping across a leaf boundary frees both leaves and the path */
+TEST(PageTableTest, UnmapAcrossNodesCollapses)
+{
+    TestPageTable pt;
+    Addr vaddr = 5 * LeafBytes - PageBytes;
+    pt.map(vaddr, 0, 2 * PageBytes);
+    pt.map(0x7fff00000000, 0, PageBytes);
+    EXPECT_EQ(pt.leaves(), 3);
+
+    pt.unmap(vaddr, 2 * PageBytes);
+    EXPECT_EQ(pt.leaves(), 1);
+    EXPECT_EQ(pt.lookup(vaddr), nullptr);
+    EXPECT_EQ(pt.lookup(vaddr + PageBytes), nullptr);
+    EXPECT_NE(pt.lookup(0x7fff00000000), nullptr);
+
+    pt.unmap(0x7fff00000000, PageBytes);
+    EXPECT_TRUE(pt.empty());
+    EXPECT_EQ(pt.pages(), 0);
+}
+
+/** Leaves stay allocated while any of their pages is mapped */
+TEST(PageTableTest, PartialUnmapKeepsLeaf)
+{
+    TestPageTable pt;
+    pt.map(0, 0, 4 * PageBytes);
+
+    pt.unmap(PageBytes, 2 * PageBytes);
+    EXPECT_EQ(pt.leaves(), 1);
+    EXPECT_NE(pt.lookup(0), nullptr);
+    EXPECT_EQ(pt.lookup(PageBytes), nullptr);
+    EXPECT_NE(pt.lookup(3 * PageBytes), nullptr);
+    EXPECT_EQ(pt.pages(), 2);
+}
+
+/** Unmapping pages that are not mapped leaves the table alone */
+TEST(PageTableTest, UnmapUnmapped)
+{
+    TestPageTable pt;
+    pt.unmap(0x10000, PageBytes);
+    EXPECT_TRUE(pt.empty());
+
+    pt.map(0, 0, PageBytes);
+    pt.unmap(0, LeafBytes + PageBytes);
+    EXPECT_TRUE(pt.empty());
+    EXPECT_EQ(pt.pages(), 0);
+}
+
+/** Translation caches are flushed when a mapping changes */
+TEST(PageTableTest, TranslationCache)
+{
+    TestPageTable pt;
+    EmulationPageTable::TranslationCache cache;
+    pt.map(0x1000, 0x5000, PageBytes);
+
+    Addr paddr;
+    ASSERT_TRUE(pt.translate(0x1008, paddr, &cache));
+    EXPECT_EQ(paddr, 0x5008);
+
+    pt.unmap(0x1000, PageBytes);
+    EXPECT_FALSE(pt.translate(0x1008, paddr, &cache));
+
+    pt.map(0x1000, 0x9000, PageBytes);
+    ASSERT_TRUE(pt.translate(0x1008, paddr, &cache));
+    EXPECT_EQ(paddr, 0x9008);
+}
@@ -41,17 +41,24 @@
 
 #include <fcntl.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/user.h>
 #include <unistd.h>
 #include <zlib.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <climits>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <vector>
 
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
 #include "debug/Checkpoint.hh"
@@ -71,14 +78,111 @@
 
 using namespace std;
 
+namespace {
+
+// Identifies a chunked memory image. The magic is followed by the
+// chunk size and count, and one index entry per chunk.
+const char chunkedImageMagic[8] = {'g', 'e', 'm', '5', 'm', 'e', 'm', '1'};
+
+struct ChunkIndexEntry
+{
+    // Offset of the deflated chunk in the file, and its length; zero
+    // length chunks are all zeroes and not stored
+    uint64_t offset;
+    uint64_t length;
+};
+
+bool
+isZeroChunk(const uint8_t *data, uint64_t len)
+{
+    const uint64_t *words = reinterpret_cast<const uint64_t *>(data);
+    for (uint64_t i = 0; i < len / sizeof(uint64_t); ++i)
+        if (words[i])
+            return false;
+    for (uint64_t i = len & ~(sizeof(uint64_t) - 1); i < len; ++i)
+        if (data[i])
+            return false;
+    return true;
+}
+
+/**
+ * Run func(i) for every i in [0, count) on up to the given number of
+ * threads, the calling thread included. Returns false as soon as any
+ * call has returned false.
+ */
+template <typename F>
+bool
+parallelFor(unsigned threads, uint64_t count, F func)
+{
+    std::atomic<uint64_t> next(0);
+    std::atomic<bool> ok(true);
+    auto worker = [&]() {
+        for (uint64_t i = next++; i < count && ok; i = next++) {
+            if (!func(i))
+                ok = false;
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < std::min<uint64_t>(threads, count); ++t)
+        pool.emplace_back(worker);
+    worker();
+    for (auto &t : pool)
+        t.join();
+    return ok;
+}
+
+bool
+writeFully(int fd, const void *buf, uint64_t len, uint64_t offset)
+{
+    const uint8_t *p = static_cast<const uint8_t *>(buf);
+    while (len) {
+        ssize_t n = pwrite(fd, p, std::min<uint64_t>(len, INT_MAX), offset);
+        if (n <= 0)
+            return false;
+        p += n;
+        len -= n;
+        offset += n;
+    }
+    return true;
+}
+
+bool
+readFully(int fd, void *buf, uint64_t len, uint64_t offset)
+{
+    uint8_t *p = static_cast<uint8_t *>(buf);
+    while (len) {
+        ssize_t n = pread(fd, p, std::min<uint64_t>(len, INT_MAX), offset);
+        if (n <= 0)
+            return false;
+        p += n;
+        len -= n;
+        offset += n;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
 PhysicalMemory::PhysicalMemory(const string& _name,
                                const vector<AbstractMemory*>& _memories,
-                               bool mmap_using_noreserve) :
-    _name(_name), size(0), mmapUsingNoReserve(mmap_using_noreserve)
+                               bool mmap_using_noreserve,
+                               Enums::MemImageFormat image_format,
+                               unsigned image_threads,
+                               uint64_t image_chunk_size) :
+    _name(_name), size(0), mmapUsingNoReserve(mmap_using_noreserve),
+    imageFormat(image_format),
+    imageThreads(image_threads ? image_threads :
+                 std::max(std::thread::hardware_concurrency(), 1U)),
+    imageChunkSize(image_chunk_size)
 {
     if (mmap_using_noreserve)
         warn("Not reserving swap space. May cause SIGSEGV on actual usage\n");
 
+    fatal_if(imageChunkSize == 0 || imageChunkSize % sysconf(_SC_PAGESIZE),
+             "Checkpoint memory chunk size must be a multiple of the "
+             "host page size\n");
+
     // add the memories from the system to the address map as
     // appropriate
     for (const auto& m : _memories) {
@@ -238,6 +342,15 @@ PhysicalMemory::isMemAddr(Addr addr) const
     return addrMap.contains(addr) != addrMap.end();
 }
 
+uint8_t *
+PhysicalMemory::hostAddr(Addr addr, Addr size) const
+{
+    const auto& m = addrMap.contains(RangeSize(addr, size));
+    if (m == addrMap.end() || m->first.interleaved() || m->second->isNull())
+        return nullptr;
+    return m->second->toHostAddr(addr);
+}
+
 AddrRangeList
 PhysicalMemory::getConfAddrRanges() const
 {
@@ -331,7 +444,12 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     // we cannot use the address range for the name as the
     // memories that are not part of the address map can overlap
     string filename = name() + ".store" + to_string(store_id) + ".pmem";
+    if (imageFormat == Enums::chunked)
+        filename += ".chunks";
+    else if (imageFormat == Enums::sparse)
+        filename += ".raw";
     long range_size = range.size();
+    string format = Enums::MemImageFormatStrings[imageFormat];
 
     DPRINTF(Checkpoint, "Serializing physical memory %s with size %d\n",
             filename, range_size);
@@ -339,26 +457,42 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     SERIALIZE_SCALAR(store_id);
     SERIALIZE_SCALAR(filename);
     SERIALIZE_SCALAR(range_size);
+    SERIALIZE_SCALAR(format);
 
     // write memory file
     string filepath = CheckpointIn::dir() + "/" + filename.c_str();
-    gzFile compressed_mem = gzopen(filepath.c_str(), "wb");
+    switch (imageFormat) {
+      case Enums::chunked:
+        writeChunkedImage(filepath, range_size, pmem);
+        break;
+      case Enums::sparse:
+        writeSparseImage(filepath, range_size, pmem);
+        break;
+      default:
+        writeGzipImage(filepath, range_size, pmem);
+        break;
+    }
+}
+
+void
+PhysicalMemory::writeGzipImage(const string &path, uint64_t size,
+                               const uint8_t *pmem) const
+{
+    gzFile compressed_mem = gzopen(path.c_str(), "wb");
     if (compressed_mem == NULL)
-        fatal("Can't open physical memory checkpoint file '%s'\n",
-              filename);
+        fatal("Can't open physical memory checkpoint file '%s'\n", path);
 
     uint64_t pass_size = 0;
 
     // gzwrite fails if (int)len < 0 (gzwrite returns int)
-    for (uint64_t written = 0; written < range.size();
-         written += pass_size) {
-        pass_size = (uint64_t)INT_MAX < (range.size() - written) ?
-            (uint64_t)INT_MAX : (range.size() - written);
+    for (uint64_t written = 0; written < size; written += pass_size) {
+        pass_size = (uint64_t)INT_MAX < (size - written) ?
+            (uint64_t)INT_MAX : (size - written);
 
         if (gzwrite(compressed_mem, pmem + written,
                     (unsigned int) pass_size) != (int) pass_size) {
             fatal("Write failed on physical memory checkpoint file '%s'\n",
-                  filename);
+                  path);
         }
     }
 
@@ -366,8 +500,104 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     // is zero
     if (gzclose(compressed_mem))
         fatal("Close failed on physical memory checkpoint file '%s'\n",
-              filename);
+              path);
+}
 
+void
+PhysicalMemory::writeChunkedImage(const string &path, uint64_t size,
+                                  const uint8_t *pmem) const
+{
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0664);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n", path);
+
+    const uint64_t num_chunks = divCeil(size, imageChunkSize);
+    vector<ChunkIndexEntry> index(num_chunks);
+    uint64_t header[2] = { imageChunkSize, num_chunks };
+    uint64_t offset = sizeof(chunkedImageMagic) + sizeof(header) +
+        num_chunks * sizeof(ChunkIndexEntry);
+
+    // Deflate a batch of chunks in parallel, then append them in order;
+    // the batches bound the memory held by compressed data
+    const uint64_t batch = imageThreads * 4;
+    vector<vector<uint8_t>> out(batch);
+    for (uint64_t first = 0; first < num_chunks; first += batch) {
+        uint64_t count = min(batch, num_chunks - first);
+        bool ok = parallelFor(imageThreads, count, [&](uint64_t i) {
+            uint64_t chunk = first + i;
+            uint64_t start = chunk * imageChunkSize;
+            uint64_t len = min(imageChunkSize, size - start);
+            vector<uint8_t> &buf = out[i];
+            if (isZeroChunk(pmem + start, len)) {
+                buf.clear();
+                return true;
+            }
+            uLongf out_len = compressBound(len);
+            buf.resize(out_len);
+            if (compress2(buf.data(), &out_len, pmem + start, len,
+                          Z_BEST_SPEED) != Z_OK)
+                return false;
+            buf.resize(out_len);
+            return true;
+        });
+        if (!ok)
+            fatal("Compression failed on physical memory checkpoint "
+                  "file '%s'\n", path);
+
+        for (uint64_t i = 0; i < count; ++i) {
+            ChunkIndexEntry &entry = index[first + i];
+            entry.offset = out[i].empty() ? 0 : offset;
+            entry.length = out[i].size();
+            if (!writeFully(fd, out[i].data(), entry.length, offset))
+                fatal("Write failed on physical memory checkpoint file "
+                      "'%s'\n", path);
+            offset += entry.length;
+        }
+    }
+
+    if (!writeFully(fd, chunkedImageMagic, sizeof(chunkedImageMagic), 0) ||
+        !writeFully(fd, header, sizeof(header), sizeof(chunkedImageMagic)) ||
+        !writeFully(fd, index.data(), num_chunks * sizeof(ChunkIndexEntry),
+                    sizeof(chunkedImageMagic) + sizeof(header)))
+        fatal("Write failed on physical memory checkpoint file '%s'\n",
+              path);
+
+    if (close(fd))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              path);
+}
+
+void
+PhysicalMemory::writeSparseImage(const string &path, uint64_t size,
+                                 const uint8_t *pmem) const
+{
+    // A run restored from a sparse image maps the image file, possibly
+    // the one being replaced here. Writing a new file and renaming it
+    // into place leaves the mapped file untouched.
+    string tmp_path = path + ".tmp";
+    int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0664);
+    if (fd < 0 || ftruncate(fd, size))
+        fatal("Can't create physical memory checkpoint file '%s'\n",
+              tmp_path);
+
+    // Chunks that are all zeroes are left as holes in the file
+    bool ok = parallelFor(imageThreads, divCeil(size, imageChunkSize),
+                          [&](uint64_t chunk) {
+        uint64_t start = chunk * imageChunkSize;
+        uint64_t len = min(imageChunkSize, size - start);
+        return isZeroChunk(pmem + start, len) ||
+            writeFully(fd, pmem + start, len, start);
+    });
+    if (!ok)
+        fatal("Write failed on physical memory checkpoint file '%s'\n",
+              tmp_path);
+
+    if (close(fd))
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              tmp_path);
+    if (rename(tmp_path.c_str(), path.c_str()))
+        fatal("Can't rename physical memory checkpoint file '%s' to '%s'\n",
+              tmp_path, path);
 }
 
 void
@@ -398,8 +628,6 @@ PhysicalMemory::unserialize(CheckpointIn &cp)
 void
 PhysicalMemory::unserializeStore(CheckpointIn &cp)
 {
-    const uint32_t chunk_size = 16384;
-
     unsigned int store_id;
     UNSERIALIZE_SCALAR(store_id);
 
@@ -407,30 +635,53 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(filename);
     string filepath = cp.cptDir + "/" + filename;
 
-    // mmap memoryfile
-    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
-    if (compressed_mem == NULL)
-        fatal("Can't open physical memory checkpoint file '%s'", filename);
+    // checkpoints from before the other layouts existed are gzip images
+    string format = "gzip";
+    UNSERIALIZE_OPT_SCALAR(format);
 
     // we've already got the actual backing store mapped
-    uint8_t* pmem = backingStore[store_id].pmem;
-    AddrRange range = backingStore[store_id].range;
+    const BackingStoreEntry &store = backingStore[store_id];
+    uint8_t* pmem = store.pmem;
+    AddrRange range = store.range;
 
     long range_size;
     UNSERIALIZE_SCALAR(range_size);
 
-    DPRINTF(Checkpoint, "Unserializing physical memory %s with size %d\n",
-            filename, range_size);
+    DPRINTF(Checkpoint, "Unserializing physical memory %s (%s) with size "
+            "%d\n", filename, format, range_size);
 
     if (range_size != range.size())
         fatal("Memory range size has changed! Saw %lld, expected %lld\n",
               range_size, range.size());
 
+    if (format == "chunked") {
+        readChunkedImage(filepath, range.size(), pmem);
+    } else if (format == "sparse") {
+        // memory handed to KVM keeps its anonymous mapping
+        readSparseImage(filepath, range.size(), pmem, !store.kvmMap);
+    } else if (format == "gzip") {
+        readGzipImage(filepath, range.size(), pmem);
+    } else {
+        fatal("Unknown memory image format '%s' in checkpoint file '%s'\n",
+              format, filename);
+    }
+}
+
+void
+PhysicalMemory::readGzipImage(const string &path, uint64_t size,
+                              uint8_t *pmem) const
+{
+    const uint32_t chunk_size = 16384;
+
+    gzFile compressed_mem = gzopen(path.c_str(), "rb");
+    if (compressed_mem == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'", path);
+
     uint64_t curr_size = 0;
     long* temp_page = new long[chunk_size];
     long* pmem_current;
     uint32_t bytes_read;
-    while (curr_size < range.size()) {
+    while (curr_size < size) {
         bytes_read = gzread(compressed_mem, temp_page, chunk_size);
         if (bytes_read == 0)
             break;
@@ -452,5 +703,95 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
 
     if (gzclose(compressed_mem))
         fatal("Close failed on physical memory checkpoint file '%s'\n",
-              filename);
+              path);
+}
+
+void
+PhysicalMemory::readChunkedImage(const string &path, uint64_t size,
+                                 uint8_t *pmem) const
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n", path);
+
+    char magic[sizeof(chunkedImageMagic)];
+    uint64_t header[2];
+    if (!readFully(fd, magic, sizeof(magic), 0) ||
+        memcmp(magic, chunkedImageMagic, sizeof(magic)) ||
+        !readFully(fd, header, sizeof(header), sizeof(magic)))
+        fatal("Physical memory checkpoint file '%s' is not a chunked "
+              "image\n", path);
+
+    const uint64_t chunk_size = header[0];
+    const uint64_t num_chunks = header[1];
+    if (chunk_size == 0 || num_chunks != divCeil(size, chunk_size))
+        fatal("Physical memory checkpoint file '%s' has %d chunks of %d "
+              "bytes, expected %d bytes\n", path, num_chunks, chunk_size,
+              size);
+
+    vector<ChunkIndexEntry> index(num_chunks);
+    if (!readFully(fd, index.data(), num_chunks * sizeof(ChunkIndexEntry),
+                   sizeof(magic) + sizeof(header)))
+        fatal("Read failed on physical memory checkpoint file '%s'\n",
+              path);
+
+    // Every chunk is inflated straight into its place in the backing
+    // store; the untouched zero chunks stay unallocated
+    bool ok = parallelFor(imageThreads, num_chunks, [&](uint64_t chunk) {
+        const ChunkIndexEntry &entry = index[chunk];
+        if (!entry.length)
+            return true;
+        thread_local vector<uint8_t> in;
+        in.resize(entry.length);
+        uint64_t start = chunk * chunk_size;
+        uLongf len = min(chunk_size, size - start);
+        uLongf expected = len;
+        return readFully(fd, in.data(), entry.length, entry.offset) &&
+            uncompress(pmem + start, &len, in.data(), entry.length) == Z_OK &&
+            len == expected;
+    });
+    if (!ok)
+        fatal("Read failed on physical memory checkpoint file '%s'\n",
+              path);
+
+    close(fd);
+}
+
+void
+PhysicalMemory::readSparseImage(const string &path, uint64_t size,
+                                uint8_t *pmem, bool map_file) const
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st))
+        fatal("Can't open physical memory checkpoint file '%s'\n", path);
+    if ((uint64_t)st.st_size != size)
+        fatal("Physical memory checkpoint file '%s' has %d bytes, expected "
+              "%d\n", path, st.st_size, size);
+
+    if (map_file) {
+        // Replace the anonymous backing store with a private mapping of
+        // the image; pages are read on first touch and copied on write
+        int map_flags = MAP_PRIVATE | MAP_FIXED;
+        if (mmapUsingNoReserve)
+            map_flags |= MAP_NORESERVE;
+        void *p = mmap(pmem, size, PROT_READ | PROT_WRITE, map_flags, fd, 0);
+        if (p != pmem) {
+            perror("mmap");
+            fatal("Could not map physical memory checkpoint file '%s'\n",
+                  path);
+        }
+    } else {
+        bool ok = parallelFor(imageThreads, divCeil(size, imageChunkSize),
+                              [&](uint64_t chunk) {
+            uint64_t start = chunk * imageChunkSize;
+            return readFully(fd, pmem + start,
+                             min(imageChunkSize, size - start), start);
+        });
+        if (!ok)
+            fatal("Read failed on physical memory checkpoint file '%s'\n",
+                  path);
+    }
+
+    close(fd);
 }
@@ -41,6 +41,7 @@
 #define __MEM_PHYSICAL_HH__
 
 #include "base/addr_range_map.hh"
+#include "enums/MemImageFormat.hh"
 #include "mem/packet.hh"
 
 /**
@@ -129,6 +130,13 @@ class PhysicalMemory : public Serializable
     // Let the user choose if we reserve swap space when calling mmap
     const bool mmapUsingNoReserve;
 
+    // Layout of the backing store images written to checkpoints, the
+    // host threads used to write and read them, and the chunk size of
+    // the chunked and sparse layouts
+    const Enums::MemImageFormat imageFormat;
+    const unsigned imageThreads;
+    const uint64_t imageChunkSize;
+
     // The physical memory used to provide the memory in the simulated
     // system
     std::vector<BackingStoreEntry> backingStore;
@@ -153,6 +161,28 @@ class PhysicalMemory : public Serializable
                             bool conf_table_reported,
                             bool in_addr_map, bool kvm_map);
 
+    /**
+     * Writers and readers for the different memory image layouts. The
+     * gzip image is a single compressed stream. The chunked image
+     * starts with a header and an index of independently deflated
+     * chunks, so that they can be compressed and inflated by several
+     * threads, with all-zero chunks left out. The sparse image is the
+     * raw backing store with holes for the all-zero chunks; it is
+     * restored by mapping the file copy-on-write over the store.
+     */
+    void writeGzipImage(const std::string &path, uint64_t size,
+                        const uint8_t *pmem) const;
+    void writeChunkedImage(const std::string &path, uint64_t size,
+                           const uint8_t *pmem) const;
+    void writeSparseImage(const std::string &path, uint64_t size,
+                          const uint8_t *pmem) const;
+    void readGzipImage(const std::string &path, uint64_t size,
+                       uint8_t *pmem) const;
+    void readChunkedImage(const std::string &path, uint64_t size,
+                          uint8_t *pmem) const;
+    void readSparseImage(const std::string &path, uint64_t size,
+                         uint8_t *pmem, bool map_file) const;
+
   public:
 
     /**
@@ -160,7 +190,9 @@ class PhysicalMemory : public Serializable
      */
     PhysicalMemory(const std::string& _name,
                    const std::vector<AbstractMemory*>& _memories,
-                   bool mmap_using_noreserve);
+                   bool mmap_using_noreserve,
+                   Enums::MemImageFormat image_format,
+                   unsigned image_threads, uint64_t image_chunk_size);
 
     /**
      * Unmap all the backing store we have used.
@@ -182,6 +214,16 @@ class PhysicalMemory : public Serializable
      */
     bool isMemAddr(Addr addr) const;
 
+    /**
+     * Get a host pointer to a block of guest physical memory, provided
+     * the whole block is backed by a single, non-null memory.
+     *
+     * @param addr Start of the block
+     * @param size Size of the block in bytes
+     * @return Pointer into the backing store, or nullptr
+     */
+    uint8_t *hostAddr(Addr addr, Addr size) const;
+
     /**
      * Get the memory ranges for all memories that are to be reported
      * to the configuration table. The ranges are merged before they
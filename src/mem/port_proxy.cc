@@ -39,6 +39,9 @@
 
 #include "mem/port_proxy.hh"
 
+#include <algorithm>
+#include <vector>
+
 #include "base/chunk_generator.hh"
 
 void
@@ -79,13 +82,14 @@ void
 PortProxy::memsetBlobPhys(Addr addr, Request::Flags flags,
                           uint8_t v, int size) const
 {
-    // quick and dirty...
-    uint8_t *buf = new uint8_t[size];
-
-    std::memset(buf, v, size);
-    PortProxy::writeBlobPhys(addr, flags, buf, size);
+    // A single line worth of fill data is enough since every chunk
+    // written below is at most one line.
+    std::vector<uint8_t> buf(std::min<int>(size, _cacheLineSize), v);
 
-    delete [] buf;
+    for (ChunkGenerator gen(addr, size, _cacheLineSize); !gen.done();
+         gen.next()) {
+        PortProxy::writeBlobPhys(gen.addr(), flags, buf.data(), gen.size());
+    }
 }
 
 
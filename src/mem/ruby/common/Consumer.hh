@@ -92,6 +92,35 @@ class Consumer
     void scheduleEvent(Cycles timeDelta);
 
   private:
+    /**
+     * Wakeup event, named after the consumer's object so that traces
+     * and event profiles attribute it. The name is only built when
+     * asked for.
+     */
+    class WakeupEvent : public Event
+    {
+      private:
+        Consumer *consumer;
+
+      public:
+        WakeupEvent(Consumer *c)
+            : Event(Default_Pri, AutoDelete), consumer(c)
+        {
+        }
+
+        void process() override { consumer->wakeup(); }
+
+        const std::string
+        name() const override
+        {
+            return consumer->getName() + ".wakeup";
+        }
+
+        const void *nameOwner() const override { return consumer; }
+
+        const char *description() const override { return "Consumer Event"; }
+    };
+
     std::set<Tick> m_scheduled_wakeups;
     ClockedObject *em;
 };
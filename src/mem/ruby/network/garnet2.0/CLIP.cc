@@ -33,8 +33,10 @@
 
 #include "mem/ruby/network/garnet2.0/CLIP.hh"
 
+#include <algorithm>
 #include <cmath>
 
+#include "base/intmath.hh"
 #include "debug/RubyNetwork.hh"
 #include "params/GarnetIntLink.hh"
 
@@ -47,6 +49,13 @@ CLIP::CLIP(const Params *p)
     phyIfcLatency = p->phys_latency;
     logIfcLatency = p->logic_latency;
 
+    cdc = false;
+    syncLatency = p->sync_latency;
+    fifoDepth = p->fifo_depth;
+    fatal_if(fifoDepth == 0, "%s: CDC FIFO depth must be non-zero\n",
+             name());
+    lastRead = 0;
+
     nLink = p->link;
     if (mType == FROM_LINK_) {
         nLink->setLinkConsumer(this);
@@ -61,27 +70,99 @@ CLIP::CLIP(const Params *p)
 
     lenBuffer.resize(p->vcs_per_vnet * p->virt_nets);
     extraCredit.resize(p->vcs_per_vnet * p->virt_nets);
+
+    m_converted_bits = 0;
+    m_cdc_crossings = 0;
+    m_cdc_full_stalls = 0;
+    m_cdc_delay = 0;
 }
 
 void
-CLIP::init(CLIP *coBrid, bool clip_en)
+CLIP::init(CLIP *coBrid, bool clip_en, bool cdc_en)
 {
     coBridge = coBrid;
     enable = clip_en;
+    cdc = cdc_en;
 }
 
 CLIP::~CLIP()
 {
 }
 
+void
+CLIP::setInterfaceLatency(Cycles logic, Cycles phys)
+{
+    logIfcLatency = logic;
+    phyIfcLatency = phys;
+}
+
+bool
+CLIP::isIdle()
+{
+    if (!NetworkLink::isIdle())
+        return false;
+    for (int len : lenBuffer)
+        if (len)
+            return false;
+    for (const auto &credits : extraCredit)
+        if (!credits.empty())
+            return false;
+    return true;
+}
+
+Tick
+CLIP::crossClockDomain(ClockedObject *reader)
+{
+    // Entries read by now have left the FIFO
+    while (!cdcFifo.empty() && cdcFifo.front() <= curTick())
+        cdcFifo.pop_front();
+
+    // A full FIFO holds the writer until enough entries are read
+    Tick written = curTick();
+    if (cdcFifo.size() >= fifoDepth) {
+        written = cdcFifo[cdcFifo.size() - fifoDepth];
+        m_cdc_full_stalls++;
+    }
+
+    // The reader sees the entry once it is through the synchronizer,
+    // and reads at most one entry per cycle
+    Tick period = reader->clockPeriod();
+    Tick edge = reader->clockEdge();
+    if (written > edge)
+        edge += divCeil(written - edge, period) * period;
+    Tick read = std::max(edge + reader->cyclesToTicks(syncLatency),
+                         lastRead + period);
+
+    DPRINTF(RubyNetwork, "CDC write at %ld read at %ld by %s "
+            "(%d entries)\n", written, read, reader->name(),
+            cdcFifo.size() + 1);
+
+    lastRead = read;
+    cdcFifo.push_back(read);
+    m_cdc_crossings++;
+    return read;
+}
+
 void
 CLIP::scheduleFlit(flit *t_flit, Cycles latency)
 {
-    Cycles totLatency = latency + phyIfcLatency;
+    ClockedObject *consumer = link_consumer->getObject();
+
+    // Without CLIP the bridge only crosses clock domains, so there is
+    // no physical interface
+    Cycles totLatency = latency + (enable ? phyIfcLatency : Cycles(0));
+    Tick time = consumer->clockEdge(totLatency);
+
+    if (cdc) {
+        Tick crossed = crossClockDomain(consumer) +
+            consumer->cyclesToTicks(totLatency);
+        m_cdc_delay += crossed - time;
+        time = crossed;
+    }
 
-    t_flit->set_time(link_consumer->getObject()->clockEdge(totLatency));
+    t_flit->set_time(time);
     linkBuffer->insert(t_flit);
-    link_consumer->scheduleEvent(totLatency);
+    link_consumer->scheduleEventAbsolute(time);
 }
 
 void
@@ -93,8 +174,9 @@ CLIP::neutralize(int vc, int eCredit)
 void
 CLIP::flitisizeAndSend(flit *t_flit)
 {
-    // Serialize-Deserialize only if CLIP is enabled
-    if (enable) {
+    // Serialize-Deserialize only if CLIP is enabled and the widths
+    // differ; a sweep may have resized the link to match the router
+    if (enable && bitWidth != nLink->bitWidth) {
         // Calculate the target-width
         int target_width = bitWidth;
         int cur_width = nLink->bitWidth;
@@ -105,10 +187,12 @@ CLIP::flitisizeAndSend(flit *t_flit)
 
         DPRINTF(RubyNetwork, "Target width: %d Current: %d\n",
             target_width, cur_width);
-        assert(target_width != cur_width);
 
         int vc = t_flit->get_vc();
 
+        if (t_flit->get_type() != CREDIT_)
+            m_converted_bits += cur_width;
+
         if (target_width > cur_width) {
             // Deserialize
             // This deserializer combines flits from the
@@ -180,9 +264,21 @@ CLIP::flitisizeAndSend(flit *t_flit)
         return;
     }
 
-    // If only CDC is enabled schedule it
-    scheduleFlit(t_flit, Cycles(0));
+    // If only CDC is enabled schedule it, otherwise the flit still
+    // crosses the logical interface
+    scheduleFlit(t_flit, enable ? logIfcLatency : Cycles(0));
+}
+
+void
+CLIP::resetStats()
+{
+    NetworkLink::resetStats();
+    m_converted_bits = 0;
+    m_cdc_crossings = 0;
+    m_cdc_full_stalls = 0;
+    m_cdc_delay = 0;
 }
+
 void
 CLIP::wakeup()
 {
@@ -34,6 +34,7 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET2_0_CLIP_HH__
 #define __MEM_RUBY_NETWORK_GARNET2_0_CLIP_HH__
 
+#include <deque>
 #include <iostream>
 #include <queue>
 #include <vector>
@@ -55,17 +56,36 @@ class CLIP: public CreditLink
     CLIP(const Params *p);
     ~CLIP();
 
-    void init(CLIP *coBrid, bool clip_en);
+    void init(CLIP *coBrid, bool clip_en, bool cdc_en);
 
     void wakeup();
     void neutralize(int vc, int eCredit);
 
+    // Runtime changes for design space sweeps, see GarnetIntLink
+    void setInterfaceLatency(Cycles logic, Cycles phys);
+    bool isIdle();
+
     void scheduleFlit(flit *t_flit, Cycles latency);
     void flitisizeAndSend(flit *t_flit);
 
+    bool isEnabled() const { return enable; }
+    // Bits of data flits serialized or deserialized since the last
+    // reset, for the energy model
+    uint64_t getConvertedBits() const { return m_converted_bits; }
+
+    // Flits and credits through the CDC FIFO, those that found it full,
+    // and the ticks the crossing added to their latency
+    uint64_t getCdcCrossings() const { return m_cdc_crossings; }
+    uint64_t getCdcFullStalls() const { return m_cdc_full_stalls; }
+    Tick getCdcDelay() const { return m_cdc_delay; }
+
+    void resetStats();
+
     friend class GarnetNetwork;
 
   protected:
+    Tick crossClockDomain(ClockedObject *reader);
+
     // Pointer to co-existing bridge
     // CreditBridge for Network Bridge and vice versa
     CLIP *coBridge;
@@ -85,10 +105,24 @@ class CLIP: public CreditLink
     Cycles phyIfcLatency;
     Cycles logIfcLatency;
 
+    // Clock domain crossing FIFO between the object and the link,
+    // written in the sender's clock and read in the receiver's
+    bool cdc;
+    Cycles syncLatency;
+    unsigned fifoDepth;
+    // Read times of the entries not yet read
+    std::deque<Tick> cdcFifo;
+    Tick lastRead;
+
     // Used by Credit Deserializer
     std::vector<int> lenBuffer;
     std::vector<std::queue<int>> extraCredit;
 
+    uint64_t m_converted_bits;
+    uint64_t m_cdc_crossings;
+    uint64_t m_cdc_full_stalls;
+    Tick m_cdc_delay;
+
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_CLIP_HH__
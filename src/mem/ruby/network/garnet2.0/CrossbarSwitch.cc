@@ -111,6 +111,16 @@ CrossbarSwitch::functionalWrite(Packet *pkt)
    return num_functional_writes;
 }
 
+bool
+CrossbarSwitch::isIdle()
+{
+    for (auto buffer : m_switch_buffer) {
+        if (!buffer->isEmpty())
+            return false;
+    }
+    return true;
+}
+
 void
 CrossbarSwitch::resetStats()
 {
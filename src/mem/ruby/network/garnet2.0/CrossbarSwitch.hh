@@ -60,6 +60,7 @@ class CrossbarSwitch : public Consumer
 
     uint32_t functionalWrite(Packet *pkt);
     void resetStats();
+    bool isIdle();
 
   private:
     int m_num_vcs;
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "mem/ruby/network/garnet2.0/GarnetEnergyModel.hh"
+
+#include "base/logging.hh"
+
+namespace {
+
+const double picojoule = 1e-12;
+const double milliwatt = 1e-3;
+
+/** Radix the crossbar energy parameter is given for */
+const double crossbarRadix = 5;
+
+} // anonymous namespace
+
+GarnetEnergyModel::GarnetEnergyModel(const Params *p)
+    : SimObject(p),
+      bufferWriteEnergy(p->buffer_write_energy * picojoule),
+      bufferReadEnergy(p->buffer_read_energy * picojoule),
+      arbitrationEnergy(p->arbitration_energy * picojoule),
+      crossbarEnergy(p->crossbar_energy * picojoule),
+      linkBitEnergy(p->link_energy * picojoule),
+      interposerLinkBitEnergy(p->interposer_link_energy * picojoule),
+      clipBitEnergy(p->clip_energy * picojoule),
+      linkActivityFactor(p->link_activity_factor),
+      routerPortLeakage(p->router_leakage * milliwatt),
+      linkBitLeakage(p->link_leakage * milliwatt),
+      interposerLinkBitLeakage(p->interposer_link_leakage * milliwatt),
+      clipPower(p->clip_leakage * milliwatt)
+{
+    fatal_if(linkActivityFactor < 0 || linkActivityFactor > 1,
+             "%s: link activity factor %f is not in [0, 1]", name(),
+             linkActivityFactor);
+}
+
+double
+GarnetEnergyModel::routerEnergy(double buffer_reads, double buffer_writes,
+                                double arbitrations,
+                                double crossbar_traversals,
+                                uint32_t bit_width, double radix) const
+{
+    // Crossbar wires grow with the number of ports they span
+    return (buffer_reads * bufferReadEnergy +
+            buffer_writes * bufferWriteEnergy) * bit_width +
+        arbitrations * arbitrationEnergy +
+        crossbar_traversals * bit_width * crossbarEnergy *
+        radix / crossbarRadix;
+}
+
+double
+GarnetEnergyModel::linkEnergy(double flits, uint32_t bit_width,
+                              bool interposer) const
+{
+    double bit_energy = interposer ? interposerLinkBitEnergy : linkBitEnergy;
+    return flits * bit_width * linkActivityFactor * bit_energy;
+}
+
+double
+GarnetEnergyModel::clipEnergy(double bits) const
+{
+    return bits * clipBitEnergy;
+}
+
+double
+GarnetEnergyModel::routerLeakage(double radix) const
+{
+    return radix * routerPortLeakage;
+}
+
+double
+GarnetEnergyModel::linkLeakage(uint32_t bit_width, bool interposer) const
+{
+    return bit_width *
+        (interposer ? interposerLinkBitLeakage : linkBitLeakage);
+}
+
+double
+GarnetEnergyModel::clipLeakage() const
+{
+    return clipPower;
+}
+
+GarnetEnergyModel *
+GarnetEnergyModelParams::create()
+{
+    return new GarnetEnergyModel(this);
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_GARNETENERGYMODEL_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_GARNETENERGYMODEL_HH__
+
+#include <cstdint>
+
+#include "params/GarnetEnergyModel.hh"
+#include "sim/sim_object.hh"
+
+/*
+ * Activity-based energy model of a Garnet network. It turns the event
+ * counts the routers, links and CLIPs keep into energy, so energy and
+ * energy-delay come out of a run instead of a separate DSENT pass.
+ * All energies are in joules and powers in watts; the parameters are
+ * in picojoules and milliwatts (see GarnetEnergyModel.py).
+ */
+class GarnetEnergyModel : public SimObject
+{
+  public:
+    typedef GarnetEnergyModelParams Params;
+    GarnetEnergyModel(const Params *p);
+
+    /**
+     * Dynamic energy of router activity.
+     * @param radix Average of the input and output port counts
+     */
+    double routerEnergy(double buffer_reads, double buffer_writes,
+                        double arbitrations, double crossbar_traversals,
+                        uint32_t bit_width, double radix) const;
+
+    /** Dynamic energy of flits crossing a link */
+    double linkEnergy(double flits, uint32_t bit_width,
+                      bool interposer) const;
+
+    /** Dynamic energy of bits through a CLIP serializer/deserializer */
+    double clipEnergy(double bits) const;
+
+    double routerLeakage(double radix) const;
+    double linkLeakage(uint32_t bit_width, bool interposer) const;
+    double clipLeakage() const;
+
+  private:
+    const double bufferWriteEnergy;
+    const double bufferReadEnergy;
+    const double arbitrationEnergy;
+    const double crossbarEnergy;
+    const double linkBitEnergy;
+    const double interposerLinkBitEnergy;
+    const double clipBitEnergy;
+    const double linkActivityFactor;
+
+    const double routerPortLeakage;
+    const double linkBitLeakage;
+    const double interposerLinkBitLeakage;
+    const double clipPower;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_GARNETENERGYMODEL_HH__
@@ -0,0 +1,98 @@
+# Copyright (c) 2019 Georgia Institute of Technology
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.SimObject import SimObject
+
+# Activity-based energy of the routers, links and CLIPs of a Garnet
+# network. Dynamic energy is charged per event counted by the network
+# (buffer reads and writes, switch arbitrations, crossbar traversals,
+# bits toggling on links and bits through CLIP serializers), leakage
+# per port, link bit and CLIP. The subclasses below are per-technology
+# tables in the range of published router and link models; calibrate
+# them against a circuit-level model before trusting absolute numbers.
+class GarnetEnergyModel(SimObject):
+    type = 'GarnetEnergyModel'
+    cxx_header = "mem/ruby/network/garnet2.0/GarnetEnergyModel.hh"
+
+    # Dynamic energy, in picojoules
+    buffer_write_energy = Param.Float("pJ per bit written to an input VC")
+    buffer_read_energy = Param.Float("pJ per bit read from an input VC")
+    arbitration_energy = Param.Float("pJ per switch allocator arbitration")
+    crossbar_energy = Param.Float("pJ per bit through a crossbar with "
+                                  "5 ports, scaled with the radix")
+    link_energy = Param.Float("pJ per toggling bit on an on-chip link")
+    interposer_link_energy = Param.Float("pJ per toggling bit on a link "
+                                         "with CLIP at both ends")
+    clip_energy = Param.Float("pJ per bit serialized or deserialized by "
+                              "a CLIP")
+    link_activity_factor = Param.Float(0.5, "Fraction of the bits of a "
+                                       "link that toggle per flit")
+
+    # Leakage, in milliwatts
+    router_leakage = Param.Float("mW per router port")
+    link_leakage = Param.Float("mW per bit of an on-chip link")
+    interposer_link_leakage = Param.Float("mW per bit of an interposer link")
+    clip_leakage = Param.Float("mW per enabled CLIP")
+
+class GarnetEnergy45nm(GarnetEnergyModel):
+    buffer_write_energy = 0.060
+    buffer_read_energy = 0.050
+    arbitration_energy = 0.60
+    crossbar_energy = 0.090
+    link_energy = 0.170
+    interposer_link_energy = 0.90
+    clip_energy = 0.25
+    router_leakage = 1.2
+    link_leakage = 0.004
+    interposer_link_leakage = 0.010
+    clip_leakage = 0.5
+
+class GarnetEnergy22nm(GarnetEnergyModel):
+    buffer_write_energy = 0.027
+    buffer_read_energy = 0.022
+    arbitration_energy = 0.27
+    crossbar_energy = 0.040
+    link_energy = 0.100
+    interposer_link_energy = 0.60
+    clip_energy = 0.12
+    router_leakage = 0.8
+    link_leakage = 0.003
+    interposer_link_leakage = 0.008
+    clip_leakage = 0.3
+
+class GarnetEnergy14nm(GarnetEnergyModel):
+    buffer_write_energy = 0.018
+    buffer_read_energy = 0.015
+    arbitration_energy = 0.18
+    crossbar_energy = 0.027
+    link_energy = 0.080
+    interposer_link_energy = 0.50
+    clip_energy = 0.08
+    router_leakage = 0.6
+    link_leakage = 0.0025
+    interposer_link_leakage = 0.007
+    clip_leakage = 0.2
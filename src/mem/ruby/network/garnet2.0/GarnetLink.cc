@@ -49,6 +49,11 @@ GarnetIntLink::GarnetIntLink(const Params *p)
     txClipEn = p->tx_clip;
     rxClipEn = p->rx_clip;
 
+    txCdcEn = p->tx_cdc;
+    rxCdcEn = p->rx_cdc;
+
+    express = p->express;
+
     txNetBridge = p->tx_net_bridge;
     rxNetBridge = p->rx_net_bridge;
 
@@ -60,10 +65,58 @@ GarnetIntLink::GarnetIntLink(const Params *p)
 void
 GarnetIntLink::init()
 {
-    txNetBridge->init(txCredBridge, txClipEn);
-    rxNetBridge->init(rxCredBridge, rxClipEn);
-    txCredBridge->init(txNetBridge, txClipEn);
-    rxCredBridge->init(rxNetBridge, rxClipEn);
+    txNetBridge->init(txCredBridge, txClipEn, txCdcEn);
+    rxNetBridge->init(rxCredBridge, rxClipEn, rxCdcEn);
+    txCredBridge->init(txNetBridge, txClipEn, txCdcEn);
+    rxCredBridge->init(rxNetBridge, rxClipEn, rxCdcEn);
+}
+
+void
+GarnetIntLink::checkIdle(const char *what)
+{
+    fatal_if(!m_network_link->isIdle() || !m_credit_link->isIdle() ||
+             !txNetBridge->isIdle() || !rxNetBridge->isIdle() ||
+             !txCredBridge->isIdle() || !rxCredBridge->isIdle(),
+             "%s: cannot change the %s of a link carrying flits\n",
+             name(), what);
+}
+
+void
+GarnetIntLink::setLatency(uint32_t latency)
+{
+    checkIdle("latency");
+    fatal_if(latency == 0, "%s: link latency must be non-zero\n", name());
+
+    DPRINTF(RubyNetwork, "%s: latency %d -> %d\n", name(),
+            m_network_link->getLatency(), latency);
+    m_latency = Cycles(latency);
+    m_network_link->setLatency(Cycles(latency));
+    m_credit_link->setLatency(Cycles(latency));
+}
+
+void
+GarnetIntLink::setWidth(uint32_t width)
+{
+    checkIdle("width");
+    fatal_if(!txClipEn || !rxClipEn,
+             "%s: width can only change with CLIP at both ends\n", name());
+    fatal_if(width == 0, "%s: link width must be non-zero\n", name());
+
+    DPRINTF(RubyNetwork, "%s: width %d -> %d\n", name(),
+            m_network_link->bitWidth, width);
+    m_network_link->setWidth(width);
+    m_credit_link->setWidth(width);
+}
+
+void
+GarnetIntLink::setInterfaceLatency(uint32_t logic, uint32_t phys)
+{
+    checkIdle("interface latency");
+
+    // Only the network bridges model interface latency, the credit
+    // bridges are built with the defaults
+    txNetBridge->setInterfaceLatency(Cycles(logic), Cycles(phys));
+    rxNetBridge->setInterfaceLatency(Cycles(logic), Cycles(phys));
 }
 
 void
@@ -94,6 +147,9 @@ GarnetExtLink::GarnetExtLink(const Params *p)
     nicClipEn = p->nic_clip;
     rtrClipEn = p->rtr_clip;
 
+    nicCdcEn = p->nic_cdc;
+    rtrCdcEn = p->rtr_cdc;
+
     rtrNetBridge[0] = p->rtr_net_bridge[0];
     nicNetBridge[0] = p->nic_net_bridge[0];
 
@@ -111,15 +167,15 @@ GarnetExtLink::GarnetExtLink(const Params *p)
 void
 GarnetExtLink::init()
 {
-    nicNetBridge[0]->init(nicCredBridge[0], nicClipEn);
-    rtrNetBridge[0]->init(rtrCredBridge[0], rtrClipEn);
-    nicNetBridge[1]->init(nicCredBridge[1], nicClipEn);
-    rtrNetBridge[1]->init(rtrCredBridge[1], rtrClipEn);
-
-    nicCredBridge[0]->init(nicNetBridge[0], nicClipEn);
-    rtrCredBridge[0]->init(rtrNetBridge[0], rtrClipEn);
-    nicCredBridge[1]->init(nicNetBridge[1], nicClipEn);
-    rtrCredBridge[1]->init(rtrNetBridge[1], rtrClipEn);
+    nicNetBridge[0]->init(nicCredBridge[0], nicClipEn, nicCdcEn);
+    rtrNetBridge[0]->init(rtrCredBridge[0], rtrClipEn, rtrCdcEn);
+    nicNetBridge[1]->init(nicCredBridge[1], nicClipEn, nicCdcEn);
+    rtrNetBridge[1]->init(rtrCredBridge[1], rtrClipEn, rtrCdcEn);
+
+    nicCredBridge[0]->init(nicNetBridge[0], nicClipEn, nicCdcEn);
+    rtrCredBridge[0]->init(rtrNetBridge[0], rtrClipEn, rtrCdcEn);
+    nicCredBridge[1]->init(nicNetBridge[1], nicClipEn, nicCdcEn);
+    rtrCredBridge[1]->init(rtrNetBridge[1], rtrClipEn, rtrCdcEn);
 }
 
 void
@@ -55,15 +55,33 @@ class GarnetIntLink : public BasicIntLink
 
     void print(std::ostream& out) const;
 
+    /**
+     * Runtime reconfiguration for design space sweeps that fork from a
+     * warmed simulator. The link must be idle, i.e. the simulator must
+     * be drained. The width can only change on links with CLIP at both
+     * ends, since the routers keep the width they were built with.
+     */
+    void setLatency(uint32_t latency);
+    void setWidth(uint32_t width);
+    void setInterfaceLatency(uint32_t logic, uint32_t phys);
+
     friend class GarnetNetwork;
 
   protected:
+    void checkIdle(const char *what);
+
     NetworkLink* m_network_link;
     CreditLink* m_credit_link;
 
     bool txClipEn;
     bool rxClipEn;
 
+    // Clock domain crossing at either end, modelled by the bridges
+    bool txCdcEn;
+    bool rxCdcEn;
+
+    bool express;
+
     CLIP* txNetBridge;
     CLIP* rxNetBridge;
 
@@ -95,6 +113,9 @@ class GarnetExtLink : public BasicExtLink
     bool nicClipEn;
     bool rtrClipEn;
 
+    bool nicCdcEn;
+    bool rtrCdcEn;
+
     NetworkLink* m_network_links[2];
     CreditLink* m_credit_links[2];
 
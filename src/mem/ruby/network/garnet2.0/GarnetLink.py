@@ -30,6 +30,7 @@
 
 from m5.params import *
 from m5.proxy import *
+from m5.SimObject import *
 from m5.objects.ClockedObject import ClockedObject
 from m5.objects.BasicLink import BasicIntLink, BasicExtLink
 
@@ -57,6 +58,12 @@ class CLIP(CreditLink):
     vtype = Param.Int(2, "Direction of CDC 0:LINK->OBJECT, 1:OBJECT->LINK")
     logic_latency = Param.Cycles(1, "Latency of logical interface")
     phys_latency  = Param.Cycles(1, "Latency of physical interface")
+    # Clock domain crossing, used when the link enables CDC at this end
+    sync_latency = Param.Cycles(Parent.cdc_sync_latency, "Synchronizer "
+                                "latency of the CDC FIFO in cycles of the "
+                                "receiving clock")
+    fifo_depth = Param.Unsigned(Parent.cdc_fifo_depth,
+                                "Entries in the CDC FIFO")
 
 # Interior fixed pipeline links between routers
 class GarnetIntLink(BasicIntLink):
@@ -78,6 +85,15 @@ class GarnetIntLink(BasicIntLink):
     tx_clip = Param.Bool(False, "Enable CLIP")
     rx_clip = Param.Bool(False, "Enable CLIP")
 
+    express = Param.Bool(False, "Express link that skips the routers "
+                         "between its ends")
+
+    cxx_exports = [
+        PyBindMethod("setLatency"),
+        PyBindMethod("setWidth"),
+        PyBindMethod("setInterfaceLatency"),
+    ]
+
     width = Param.UInt32(Parent.ni_flit_size,
                           "bit width supported by the router")
 
@@ -33,20 +33,30 @@
 
 #include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
+#include "base/callback.hh"
 #include "base/cast.hh"
 #include "base/stl_helpers.hh"
+#include "debug/Drain.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
+#include "mem/ruby/network/garnet2.0/CLIP.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
+#include "mem/ruby/network/garnet2.0/GarnetEnergyModel.hh"
 #include "mem/ruby/network/garnet2.0/GarnetLink.hh"
 #include "mem/ruby/network/garnet2.0/NetworkInterface.hh"
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
+#include "mem/ruby/network/garnet2.0/NetworkTelemetry.hh"
+#include "mem/ruby/network/garnet2.0/NetworkTrace.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
 #include "mem/ruby/system/RubySystem.hh"
+#include "sim/core.hh"
+#include "sim/stats.hh"
 
 using namespace std;
 using m5::stl_helpers::deletePointers;
@@ -58,7 +68,8 @@ using m5::stl_helpers::deletePointers;
  */
 
 GarnetNetwork::GarnetNetwork(const Params *p)
-    : Network(p)
+    : Network(p),
+      drainCheckEvent([this]{ checkDrain(); }, name() + ".drainCheck")
 {
     m_num_rows = p->num_rows;
     m_ni_flit_size = p->ni_flit_size;
@@ -71,6 +82,31 @@ GarnetNetwork::GarnetNetwork(const Params *p)
     if (m_enable_fault_model)
         fault_model = p->fault_model;
 
+    m_packet_latency_hist.resize(1 << 16);
+    m_packets_in_flight = 0;
+
+    m_router_chiplet.assign(p->router_chiplets.begin(),
+                            p->router_chiplets.end());
+    m_router_chiplet.resize(p->routers.size(), 0);
+    m_ni_chiplet.resize(m_nodes, 0);
+    m_num_chiplets = 1;
+    for (int chiplet : m_router_chiplet) {
+        fatal_if(chiplet < 0, "Negative chiplet id %d", chiplet);
+        m_num_chiplets = max(m_num_chiplets, chiplet + 1);
+    }
+
+    m_trace_capture_file = p->trace_capture;
+    m_trace_dep_window = p->trace_dep_window;
+    m_trace_capture = nullptr;
+
+    m_energy_model = p->energy_model;
+
+    m_telemetry = nullptr;
+    if (!p->telemetry_file.empty()) {
+        m_telemetry = new NetworkTelemetry(this, p->telemetry_file,
+                                           p->telemetry_interval);
+    }
+
     m_vnet_type.resize(m_virtual_networks);
 
     for (int i = 0 ; i < m_virtual_networks ; i++) {
@@ -142,6 +178,15 @@ GarnetNetwork::init()
             router->printFaultVector(cout);
         }
     }
+
+    if (!m_trace_capture_file.empty()) {
+        m_trace_capture = new NetworkTraceCapture(m_trace_capture_file,
+            m_nodes, m_virtual_networks, clockPeriod(), m_trace_dep_window);
+        registerExitCallback(
+            new MakeCallback<NetworkTraceCapture,
+                             &NetworkTraceCapture::close>(m_trace_capture,
+                                                          true));
+    }
 }
 
 GarnetNetwork::~GarnetNetwork()
@@ -150,8 +195,153 @@ GarnetNetwork::~GarnetNetwork()
     deletePointers(m_nis);
     deletePointers(m_networklinks);
     deletePointers(m_creditlinks);
+    delete m_trace_capture;
+    delete m_telemetry;
+}
+
+void
+GarnetNetwork::startup()
+{
+    Network::startup();
+
+    if (m_telemetry) {
+        m_telemetry->start(m_router_chiplet);
+        registerExitCallback(
+            new MakeCallback<NetworkTelemetry,
+                             &NetworkTelemetry::close>(m_telemetry, true));
+    }
+}
+
+bool
+GarnetNetwork::isIdle()
+{
+    for (auto router : m_routers) {
+        if (!router->isIdle())
+            return false;
+    }
+    for (auto ni : m_nis) {
+        if (!ni->isIdle())
+            return false;
+    }
+    for (auto link : m_networklinks) {
+        if (!link->isIdle())
+            return false;
+    }
+    for (auto link : m_creditlinks) {
+        if (!link->isIdle())
+            return false;
+    }
+    for (auto bridge : m_clips) {
+        if (!bridge->isIdle())
+            return false;
+    }
+    for (auto bridge : m_cdc_bridges) {
+        if (!bridge->isIdle())
+            return false;
+    }
+    return true;
+}
+
+DrainState
+GarnetNetwork::drain()
+{
+    if (isIdle())
+        return DrainState::Drained;
+
+    DPRINTF(Drain, "%s: flits in flight, not drained\n", name());
+    if (!drainCheckEvent.scheduled())
+        schedule(drainCheckEvent, clockEdge(Cycles(1)));
+    return DrainState::Draining;
+}
+
+void
+GarnetNetwork::checkDrain()
+{
+    if (drainState() != DrainState::Draining)
+        return;
+
+    if (isIdle()) {
+        DPRINTF(Drain, "%s: drained\n", name());
+        signalDrainDone();
+    } else {
+        schedule(drainCheckEvent, clockEdge(Cycles(1)));
+    }
+}
+
+void
+GarnetNetwork::resetPacketLatencySamples()
+{
+    fill(m_packet_latency_hist.begin(), m_packet_latency_hist.end(), 0);
+}
+
+double
+GarnetNetwork::getPacketLatencyPercentile(double percentile) const
+{
+    uint64_t total = 0;
+    for (auto count : m_packet_latency_hist)
+        total += count;
+    if (total == 0)
+        return 0;
+
+    uint64_t rank = ceil(percentile / 100 * total);
+    uint64_t seen = 0;
+    for (int i = 0; i < m_packet_latency_hist.size(); ++i) {
+        seen += m_packet_latency_hist[i];
+        if (seen >= max<uint64_t>(rank, 1))
+            return i;
+    }
+    return m_packet_latency_hist.size() - 1;
+}
+
+void
+GarnetNetwork::sample_chiplet_latency(NodeID src_ni, NodeID dest_ni, int vnet,
+                                      Tick network_latency,
+                                      Tick queueing_latency)
+{
+    int index = (m_ni_chiplet[src_ni] * m_num_chiplets +
+                 m_ni_chiplet[dest_ni]) * m_virtual_networks + vnet;
+    m_packet_network_latency_hist[index].sample(
+        ticksToCycles(network_latency));
+    m_packet_queueing_latency_hist[index].sample(
+        ticksToCycles(queueing_latency));
+}
+
+bool
+GarnetNetwork::traceReplayDelivered(const MsgPtr &msg)
+{
+    if (!m_trace_replay)
+        return false;
+
+    const NetworkTraceMsg *trace_msg =
+        dynamic_cast<const NetworkTraceMsg *>(msg.get());
+    if (!trace_msg)
+        return false;
+
+    m_trace_replay(*trace_msg);
+    return true;
 }
 
+namespace {
+
+// Without a CDC the objects at the ends of a link wake each other up on
+// their own clock edges, so they have to share the clock. The NIs are
+// not checked: they run in the clock of their controllers and have
+// always woken up the links across clocks
+void
+checkClockCrossing(const BasicLink *link, const ClockedObject *end,
+                   const NetworkLink *net_link, const CreditLink *credit_link,
+                   bool cdc)
+{
+    if (cdc)
+        return;
+    fatal_if(end->clockPeriod() != net_link->clockPeriod() ||
+             end->clockPeriod() != credit_link->clockPeriod(),
+             "%s: %s and the link are clocked differently, enable CDC at "
+             "this end\n", link->name(), end->name());
+}
+
+} // anonymous namespace
+
 /*
  * This function creates a link from the Network Interface (NI)
  * into the Network.
@@ -173,14 +363,32 @@ GarnetNetwork::makeExtInLink(NodeID src, SwitchID dest, BasicLink* link,
     CreditLink* credit_link = garnet_link->m_credit_links[LinkDirection_In];
 
     m_networklinks.push_back(net_link);
+    m_interposer_link.push_back(false);
+    m_express_link.push_back(false);
     m_creditlinks.push_back(credit_link);
+    if (garnet_link->nicClipEn)
+        m_clips.push_back(garnet_link->nicNetBridge[LinkDirection_In]);
+    if (garnet_link->rtrClipEn)
+        m_clips.push_back(garnet_link->rtrNetBridge[LinkDirection_In]);
+    if (garnet_link->nicCdcEn) {
+        m_cdc_bridges.push_back(garnet_link->nicNetBridge[LinkDirection_In]);
+        m_cdc_bridges.push_back(garnet_link->nicCredBridge[LinkDirection_In]);
+    }
+    if (garnet_link->rtrCdcEn) {
+        m_cdc_bridges.push_back(garnet_link->rtrNetBridge[LinkDirection_In]);
+        m_cdc_bridges.push_back(garnet_link->rtrCredBridge[LinkDirection_In]);
+    }
 
     PortDirection dst_inport_dirn = "Local";
     ClockedObject *extNode = garnet_link->params()->ext_node;
     m_nis[src]->setClockDomain(extNode->getClockDomain());
+    m_ni_chiplet[src] = m_router_chiplet[dest];
+
+    checkClockCrossing(link, m_routers[dest], net_link, credit_link,
+                       garnet_link->rtrCdcEn);
 
-    if (garnet_link->nicClipEn) {
-        DPRINTF(RubyNetwork, "Enable CLIP at NIC for %s\n",
+    if (garnet_link->nicClipEn || garnet_link->nicCdcEn) {
+        DPRINTF(RubyNetwork, "Enable bridge at NIC for %s\n",
             garnet_link->name());
         m_nis[src]->
         addOutPort(garnet_link->nicNetBridge[LinkDirection_In],
@@ -190,8 +398,8 @@ GarnetNetwork::makeExtInLink(NodeID src, SwitchID dest, BasicLink* link,
         m_nis[src]->addOutPort(net_link, credit_link, dest);
     }
 
-    if (garnet_link->rtrClipEn) {
-        DPRINTF(RubyNetwork, "Enable CLIP at Rtr for %s\n",
+    if (garnet_link->rtrClipEn || garnet_link->rtrCdcEn) {
+        DPRINTF(RubyNetwork, "Enable bridge at Rtr for %s\n",
             garnet_link->name());
         m_routers[dest]->
             addInPort(dst_inport_dirn,
@@ -225,12 +433,31 @@ GarnetNetwork::makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
     CreditLink* credit_link = garnet_link->m_credit_links[LinkDirection_Out];
 
     m_networklinks.push_back(net_link);
+    m_interposer_link.push_back(false);
+    m_express_link.push_back(false);
     m_creditlinks.push_back(credit_link);
+    if (garnet_link->nicClipEn)
+        m_clips.push_back(garnet_link->nicNetBridge[LinkDirection_Out]);
+    if (garnet_link->rtrClipEn)
+        m_clips.push_back(garnet_link->rtrNetBridge[LinkDirection_Out]);
+    if (garnet_link->nicCdcEn) {
+        m_cdc_bridges.push_back(garnet_link->nicNetBridge[LinkDirection_Out]);
+        m_cdc_bridges.push_back(
+            garnet_link->nicCredBridge[LinkDirection_Out]);
+    }
+    if (garnet_link->rtrCdcEn) {
+        m_cdc_bridges.push_back(garnet_link->rtrNetBridge[LinkDirection_Out]);
+        m_cdc_bridges.push_back(
+            garnet_link->rtrCredBridge[LinkDirection_Out]);
+    }
 
     PortDirection src_outport_dirn = "Local";
 
-    if (garnet_link->nicClipEn) {
-        DPRINTF(RubyNetwork, "Enable CLIP at NIC for %s\n",
+    checkClockCrossing(link, m_routers[src], net_link, credit_link,
+                       garnet_link->rtrCdcEn);
+
+    if (garnet_link->nicClipEn || garnet_link->nicCdcEn) {
+        DPRINTF(RubyNetwork, "Enable bridge at NIC for %s\n",
             garnet_link->name());
         m_nis[dest]->
             addInPort(garnet_link->nicNetBridge[LinkDirection_Out],
@@ -239,8 +466,8 @@ GarnetNetwork::makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
         m_nis[dest]->addInPort(net_link, credit_link);
     }
 
-    if (garnet_link->rtrClipEn) {
-        DPRINTF(RubyNetwork, "Enable CLIP at Rtr for %s\n",
+    if (garnet_link->rtrClipEn || garnet_link->rtrCdcEn) {
+        DPRINTF(RubyNetwork, "Enable bridge at Rtr for %s\n",
             garnet_link->name());
         m_routers[src]->
             addOutPort(src_outport_dirn,
@@ -272,12 +499,35 @@ GarnetNetwork::makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
     NetworkLink* net_link = garnet_link->m_network_link;
     net_link->setType(INT_);
     CreditLink* credit_link = garnet_link->m_credit_link;
+    bool interposer = garnet_link->txClipEn && garnet_link->rxClipEn;
 
     m_networklinks.push_back(net_link);
+    m_interposer_link.push_back(interposer);
+    m_express_link.push_back(garnet_link->express);
     m_creditlinks.push_back(credit_link);
+    if (garnet_link->txClipEn)
+        m_clips.push_back(garnet_link->txNetBridge);
+    if (garnet_link->rxClipEn)
+        m_clips.push_back(garnet_link->rxNetBridge);
+    if (garnet_link->txCdcEn) {
+        m_cdc_bridges.push_back(garnet_link->txNetBridge);
+        m_cdc_bridges.push_back(garnet_link->txCredBridge);
+    }
+    if (garnet_link->rxCdcEn) {
+        m_cdc_bridges.push_back(garnet_link->rxNetBridge);
+        m_cdc_bridges.push_back(garnet_link->rxCredBridge);
+    }
+
+    if (m_telemetry)
+        m_telemetry->addLink(net_link, src, dest, interposer);
 
-    if (garnet_link->rxClipEn) {
-        DPRINTF(RubyNetwork, "Enable CLIP at Rx for %s\n",
+    checkClockCrossing(link, m_routers[src], net_link, credit_link,
+                       garnet_link->txCdcEn);
+    checkClockCrossing(link, m_routers[dest], net_link, credit_link,
+                       garnet_link->rxCdcEn);
+
+    if (garnet_link->rxClipEn || garnet_link->rxCdcEn) {
+        DPRINTF(RubyNetwork, "Enable bridge at Rx for %s\n",
             garnet_link->name());
         m_routers[dest]->addInPort(dst_inport_dirn,
             garnet_link->rxNetBridge, garnet_link->rxCredBridge);
@@ -285,8 +535,8 @@ GarnetNetwork::makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
         m_routers[dest]->addInPort(dst_inport_dirn, net_link, credit_link);
     }
 
-    if (garnet_link->txClipEn) {
-        DPRINTF(RubyNetwork, "Enable CLIP at Tx for %s\n",
+    if (garnet_link->txClipEn || garnet_link->txCdcEn) {
+        DPRINTF(RubyNetwork, "Enable bridge at Tx for %s\n",
             garnet_link->name());
         m_routers[src]->
             addOutPort(src_outport_dirn, garnet_link->txNetBridge,
@@ -377,6 +627,35 @@ GarnetNetwork::regStats()
     m_avg_packet_latency
         = m_avg_packet_network_latency + m_avg_packet_queueing_latency;
 
+    // Tail latencies by source chiplet, destination chiplet and vnet, in
+    // cycles with buckets within 1/32 of their values
+    int chiplet_pairs = m_num_chiplets * m_num_chiplets * m_virtual_networks;
+    m_packet_network_latency_hist
+        .init(chiplet_pairs, 5, 1 << 20)
+        .name(name() + ".packet_network_latency_hist")
+        .desc("network latency of packets in cycles")
+        .flags(Stats::nozero)
+        ;
+
+    m_packet_queueing_latency_hist
+        .init(chiplet_pairs, 5, 1 << 20)
+        .name(name() + ".packet_queueing_latency_hist")
+        .desc("queueing latency of packets in cycles")
+        .flags(Stats::nozero)
+        ;
+
+    for (int src = 0; src < m_num_chiplets; src++) {
+        for (int dest = 0; dest < m_num_chiplets; dest++) {
+            for (int vnet = 0; vnet < m_virtual_networks; vnet++) {
+                int i = (src * m_num_chiplets + dest) * m_virtual_networks +
+                    vnet;
+                string subname = csprintf("c%d_c%d_vnet%d", src, dest, vnet);
+                m_packet_network_latency_hist.subname(i, subname);
+                m_packet_queueing_latency_hist.subname(i, subname);
+            }
+        }
+    }
+
     // Flits
     m_flits_received
         .init(m_virtual_networks)
@@ -440,6 +719,16 @@ GarnetNetwork::regStats()
     m_avg_hops.name(name() + ".average_hops");
     m_avg_hops = m_total_hops / sum(m_flits_received);
 
+    m_bypassed_flits
+        .name(name() + ".bypassed_flits")
+        .desc("Router traversals that bypassed the pipeline")
+        .flags(Stats::nozero);
+    m_bypass_rate
+        .name(name() + ".bypass_rate")
+        .desc("Fraction of router traversals that bypassed the pipeline")
+        .flags(Stats::nozero | Stats::nonan);
+    m_bypass_rate = m_bypassed_flits / m_total_hops;
+
     // Links
     m_total_ext_in_link_utilization
         .name(name() + ".ext_in_link_utilization");
@@ -449,12 +738,93 @@ GarnetNetwork::regStats()
         .name(name() + ".int_link_utilization");
     m_average_link_utilization
         .name(name() + ".avg_link_utilization");
+    m_express_link_utilization
+        .name(name() + ".express_link_utilization")
+        .desc("Flits through express links")
+        .flags(Stats::nozero);
 
     m_average_vc_load
         .init(m_virtual_networks * m_vcs_per_vnet)
         .name(name() + ".avg_vc_load")
         .flags(Stats::pdf | Stats::total | Stats::nozero | Stats::oneline)
         ;
+
+    // Clock domain crossings
+    m_cdc_crossings
+        .name(name() + ".cdc_crossings")
+        .desc("Flits and credits through clock domain crossing FIFOs")
+        .flags(Stats::nozero);
+    m_cdc_full_stalls
+        .name(name() + ".cdc_fifo_full")
+        .desc("Crossings that found the CDC FIFO full")
+        .flags(Stats::nozero);
+    m_cdc_delay
+        .name(name() + ".cdc_delay")
+        .desc("Cycles added by clock domain crossings")
+        .flags(Stats::nozero);
+    m_avg_cdc_delay
+        .name(name() + ".average_cdc_delay")
+        .desc("Cycles added per clock domain crossing")
+        .flags(Stats::nozero | Stats::nonan);
+    m_avg_cdc_delay = m_cdc_delay / m_cdc_crossings;
+
+    // Energy, zero without a model
+
+    m_router_energy
+        .init(m_routers.size())
+        .name(name() + ".router_energy")
+        .desc("Dynamic and leakage energy of each router (J)")
+        .flags(Stats::total | Stats::nozero)
+        ;
+    for (int i = 0; i < m_routers.size(); i++)
+        m_router_energy.subname(i, csprintf("router%d", i));
+
+    m_router_dynamic_energy
+        .name(name() + ".router_dynamic_energy")
+        .desc("Dynamic energy of buffers, allocators and crossbars (J)")
+        .flags(Stats::nozero | Stats::nonan);
+    m_link_dynamic_energy
+        .name(name() + ".link_dynamic_energy")
+        .desc("Dynamic energy of on-chip links (J)")
+        .flags(Stats::nozero | Stats::nonan);
+    m_interposer_link_dynamic_energy
+        .name(name() + ".interposer_link_dynamic_energy")
+        .desc("Dynamic energy of links with CLIP at both ends (J)")
+        .flags(Stats::nozero | Stats::nonan);
+    m_clip_dynamic_energy
+        .name(name() + ".clip_dynamic_energy")
+        .desc("Dynamic energy of CLIP serializers/deserializers (J)")
+        .flags(Stats::nozero | Stats::nonan);
+    m_leakage_energy
+        .name(name() + ".leakage_energy")
+        .desc("Leakage energy of routers, links and CLIPs (J)")
+        .flags(Stats::nozero | Stats::nonan);
+
+    m_total_energy
+        .name(name() + ".total_energy")
+        .desc("Network energy (J)")
+        .flags(Stats::nozero | Stats::nonan);
+    m_total_energy = m_router_dynamic_energy + m_link_dynamic_energy +
+        m_interposer_link_dynamic_energy + m_clip_dynamic_energy +
+        m_leakage_energy;
+
+    m_average_power
+        .name(name() + ".average_power")
+        .desc("Average network power (W)")
+        .flags(Stats::nozero | Stats::nonan);
+    m_average_power = m_total_energy / simSeconds;
+
+    m_energy_delay_product
+        .name(name() + ".energy_delay_product")
+        .desc("Network energy times simulated time (J*s)")
+        .flags(Stats::nozero | Stats::nonan);
+    m_energy_delay_product = m_total_energy * simSeconds;
+
+    m_energy_per_flit
+        .name(name() + ".energy_per_flit")
+        .desc("Network energy per received flit (J)")
+        .flags(Stats::nozero | Stats::nonan);
+    m_energy_per_flit = m_total_energy / sum(m_flits_received);
 }
 
 void
@@ -473,20 +843,100 @@ GarnetNetwork::collateStats()
             m_total_ext_out_link_utilization += activity;
         else if (type == INT_)
             m_total_int_link_utilization += activity;
+        if (m_express_link[i])
+            m_express_link_utilization += activity;
+
+        // Links count their activity in their own clock
+        double link_cycles =
+            time_delta * clockPeriod() / m_networklinks[i]->clockPeriod();
 
         m_average_link_utilization +=
-            (double(activity) / time_delta);
+            (double(activity) / link_cycles);
 
         vector<unsigned int> vc_load = m_networklinks[i]->getVcLoad();
         for (int j = 0; j < vc_load.size(); j++) {
-            m_average_vc_load[j] += ((double)vc_load[j] / time_delta);
+            m_average_vc_load[j] += ((double)vc_load[j] / link_cycles);
         }
     }
 
+    Tick cdc_delay = 0;
+    for (auto bridge : m_cdc_bridges) {
+        m_cdc_crossings += bridge->getCdcCrossings();
+        m_cdc_full_stalls += bridge->getCdcFullStalls();
+        cdc_delay += bridge->getCdcDelay();
+    }
+    m_cdc_delay += double(cdc_delay) / clockPeriod();
+
     // Ask the routers to collate their statistics
     for (int i = 0; i < m_routers.size(); i++) {
         m_routers[i]->collateStats();
+        m_bypassed_flits += m_routers[i]->get_bypassed_flits();
+    }
+
+    if (m_energy_model)
+        collateEnergyStats(time_delta * clockPeriod() / SimClock::Float::s);
+}
+
+namespace {
+
+double
+routerRadix(const Router *router)
+{
+    return (router->get_num_inports() + router->get_num_outports()) / 2.0;
+}
+
+} // anonymous namespace
+
+double
+GarnetNetwork::getRouterEnergy(int router) const
+{
+    const Router *r = m_routers[router];
+    return m_energy_model->routerEnergy(r->get_buffer_reads(),
+                                        r->get_buffer_writes(),
+                                        r->get_arbiter_activity(),
+                                        r->get_crossbar_activity(),
+                                        r->get_bit_width(), routerRadix(r));
+}
+
+void
+GarnetNetwork::collateEnergyStats(double seconds)
+{
+    double router_energy = 0, link_energy = 0, interposer_energy = 0;
+    double clip_energy = 0, leakage = 0;
+
+    for (int i = 0; i < m_routers.size(); i++) {
+        double dynamic = getRouterEnergy(i);
+        double static_energy =
+            m_energy_model->routerLeakage(routerRadix(m_routers[i])) *
+            seconds;
+        m_router_energy[i] = dynamic + static_energy;
+        router_energy += dynamic;
+        leakage += static_energy;
     }
+
+    for (int i = 0; i < m_networklinks.size(); i++) {
+        const NetworkLink *link = m_networklinks[i];
+        bool interposer = m_interposer_link[i];
+        double dynamic = m_energy_model->linkEnergy(
+            link->getLinkUtilization(), link->bitWidth, interposer);
+        if (interposer)
+            interposer_energy += dynamic;
+        else
+            link_energy += dynamic;
+        leakage += m_energy_model->linkLeakage(link->bitWidth, interposer) *
+            seconds;
+    }
+
+    for (auto clip : m_clips) {
+        clip_energy += m_energy_model->clipEnergy(clip->getConvertedBits());
+        leakage += m_energy_model->clipLeakage() * seconds;
+    }
+
+    m_router_dynamic_energy = router_energy;
+    m_link_dynamic_energy = link_energy;
+    m_interposer_link_dynamic_energy = interposer_energy;
+    m_clip_dynamic_energy = clip_energy;
+    m_leakage_energy = leakage;
 }
 
 void
@@ -37,17 +37,24 @@
 #include <iostream>
 #include <vector>
 
+#include <functional>
+
 #include "mem/ruby/network/Network.hh"
 #include "mem/ruby/network/fault_model/FaultModel.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "params/GarnetNetwork.hh"
 
+class CLIP;
 class FaultModel;
+class GarnetEnergyModel;
 class NetworkInterface;
 class Router;
 class NetDest;
 class NetworkLink;
 class CreditLink;
+class NetworkTelemetry;
+class NetworkTraceCapture;
+class NetworkTraceMsg;
 
 class GarnetNetwork : public Network
 {
@@ -57,6 +64,12 @@ class GarnetNetwork : public Network
 
     ~GarnetNetwork();
     void init();
+    void startup();
+
+    // The network is drained once no flit or credit is left in any
+    // router, NI, link or bridge, so that links can be reconfigured
+    DrainState drain() override;
+    bool isIdle();
 
     // Configuration (set externally)
 
@@ -84,7 +97,18 @@ class GarnetNetwork : public Network
         return m_vnet_type[vnet];
     }
     int getNumRouters();
+    Router *getRouter(int id) { return m_routers[id]; }
     int get_router_id(int ni, int vnet);
+    NetworkInterface *getNetworkInterface(NodeID ni) { return m_nis.at(ni); }
+
+    // Network traces (see NetworkTrace.hh)
+    NetworkTraceCapture *getTraceCapture() const { return m_trace_capture; }
+
+    typedef std::function<void(const NetworkTraceMsg &)> TraceReplayCallback;
+    void setTraceReplay(TraceReplayCallback cb) { m_trace_replay = cb; }
+    // Hand a delivered message to the trace replay tester if it
+    // injected it
+    bool traceReplayDelivered(const MsgPtr &msg);
 
 
     // Methods used by Topology to setup the network
@@ -102,14 +126,70 @@ class GarnetNetwork : public Network
     //! indicates the number of messages that were written.
     uint32_t functionalWrite(Packet *pkt);
 
+    // Energy (see GarnetEnergyModel.hh), NULL without a model
+    GarnetEnergyModel *getEnergyModel() const { return m_energy_model; }
+    // Dynamic energy of a router's activity since the last reset
+    double getRouterEnergy(int router) const;
+
     // Stats
     void collateStats();
     void regStats();
     void print(std::ostream& out) const;
 
+    // Running totals across all vnets, for sampling scripts that take
+    // deltas around a measurement window. Latencies are in ticks.
+    double
+    getPacketsReceived() const
+    {
+        return m_packets_received.total();
+    }
+
+    double
+    getPacketLatency() const
+    {
+        return m_packet_network_latency.total() +
+            m_packet_queueing_latency.total();
+    }
+
+    double
+    getPacketsInjected() const
+    {
+        return m_packets_injected.total();
+    }
+
+    // Packets injected and not received yet, not cleared by stats resets
+    uint64_t getPacketsInFlight() const { return m_packets_in_flight; }
+
+    // Per-packet latencies in cycles since the last reset, for
+    // latency percentiles in injection rate sweeps
+    void
+    sample_packet_latency(Tick latency)
+    {
+        uint64_t cycles = std::min<uint64_t>(ticksToCycles(latency),
+                                             m_packet_latency_hist.size() - 1);
+        m_packet_latency_hist[cycles]++;
+    }
+    void resetPacketLatencySamples();
+    double getPacketLatencyPercentile(double percentile) const;
+
+    // Latency distributions per source chiplet, destination chiplet and
+    // vnet, for the tail latency of a packet
+    void sample_chiplet_latency(NodeID src_ni, NodeID dest_ni, int vnet,
+                                Tick network_latency, Tick queueing_latency);
+
     // increment counters
-    void increment_injected_packets(int vnet) { m_packets_injected[vnet]++; }
-    void increment_received_packets(int vnet) { m_packets_received[vnet]++; }
+    void
+    increment_injected_packets(int vnet)
+    {
+        m_packets_injected[vnet]++;
+        m_packets_in_flight++;
+    }
+    void
+    increment_received_packets(int vnet)
+    {
+        m_packets_received[vnet]++;
+        m_packets_in_flight--;
+    }
 
     void
     increment_packet_network_latency(Tick latency, int vnet)
@@ -155,6 +235,12 @@ class GarnetNetwork : public Network
     int m_routing_algorithm;
     bool m_enable_fault_model;
 
+    std::string m_trace_capture_file;
+    Cycles m_trace_dep_window;
+    NetworkTraceCapture *m_trace_capture;
+    NetworkTelemetry *m_telemetry;
+    TraceReplayCallback m_trace_replay;
+
     // Statistical variables
     Stats::Vector m_packets_received;
     Stats::Vector m_packets_injected;
@@ -181,19 +267,66 @@ class GarnetNetwork : public Network
     Stats::Scalar m_total_ext_in_link_utilization;
     Stats::Scalar m_total_ext_out_link_utilization;
     Stats::Scalar m_total_int_link_utilization;
+    Stats::Scalar m_express_link_utilization;
     Stats::Scalar m_average_link_utilization;
     Stats::Vector m_average_vc_load;
 
     Stats::Scalar  m_total_hops;
     Stats::Formula m_avg_hops;
 
+    // Router traversals that bypassed the pipeline
+    Stats::Scalar  m_bypassed_flits;
+    Stats::Formula m_bypass_rate;
+
+    // Packets by latency in cycles, the last bucket collects the rest
+    std::vector<uint64_t> m_packet_latency_hist;
+
+    uint64_t m_packets_in_flight;
+
+    Stats::VectorLogHistogram m_packet_network_latency_hist;
+    Stats::VectorLogHistogram m_packet_queueing_latency_hist;
+
+    // Clock domain crossings, with CDC enabled on any link
+    Stats::Scalar m_cdc_crossings;
+    Stats::Scalar m_cdc_full_stalls;
+    Stats::Scalar m_cdc_delay;
+    Stats::Formula m_avg_cdc_delay;
+
+    // Energy in joules since the last reset, with a model
+    GarnetEnergyModel *m_energy_model;
+    Stats::Vector m_router_energy;
+    Stats::Scalar m_router_dynamic_energy;
+    Stats::Scalar m_link_dynamic_energy;
+    Stats::Scalar m_interposer_link_dynamic_energy;
+    Stats::Scalar m_clip_dynamic_energy;
+    Stats::Scalar m_leakage_energy;
+    Stats::Formula m_total_energy;
+    Stats::Formula m_average_power;
+    Stats::Formula m_energy_delay_product;
+    Stats::Formula m_energy_per_flit;
+
+    // Chiplet of each router and of the router each NI attaches to
+    std::vector<int> m_router_chiplet;
+    std::vector<int> m_ni_chiplet;
+    int m_num_chiplets;
+
   private:
+    void collateEnergyStats(double seconds);
+
+    // Checks every cycle whether a draining network became idle
+    void checkDrain();
+    EventFunctionWrapper drainCheckEvent;
+
     GarnetNetwork(const GarnetNetwork& obj);
     GarnetNetwork& operator=(const GarnetNetwork& obj);
 
     std::vector<VNET_type > m_vnet_type;
     std::vector<Router *> m_routers;   // All Routers in Network
     std::vector<NetworkLink *> m_networklinks; // All flit links in the network
+    std::vector<bool> m_interposer_link; // CLIP at both ends of the link
+    std::vector<bool> m_express_link; // Link skipping routers
+    std::vector<CLIP *> m_clips; // Enabled network bridges
+    std::vector<CLIP *> m_cdc_bridges; // Bridges crossing clock domains
     std::vector<CreditLink *> m_creditlinks; // All credit links in the network
     std::vector<NetworkInterface *> m_nis;   // All NI's in Network
 };
@@ -30,6 +30,7 @@
 
 from m5.params import *
 from m5.proxy import *
+from m5.SimObject import *
 from m5.objects.Network import RubyNetwork
 from m5.objects.BasicRouter import BasicRouter
 from m5.objects.ClockedObject import ClockedObject
@@ -48,6 +49,38 @@ class GarnetNetwork(RubyNetwork):
     fault_model = Param.FaultModel(NULL, "network fault model");
     garnet_deadlock_threshold = Param.UInt32(50000,
                               "network-level deadlock threshold")
+    trace_capture = Param.String("", "Record the injected messages in this "
+                                 "file for GarnetTraceReplay")
+    trace_dep_window = Param.Cycles(1000, "Messages sent for a line up to "
+                                    "this many cycles after the node "
+                                    "received one for it depend on it")
+    telemetry_file = Param.String("", "Sample router and link activity "
+                                  "into this file of the output directory")
+    telemetry_interval = Param.Cycles(1000, "Cycles between telemetry "
+                                      "samples")
+    energy_model = Param.GarnetEnergyModel(NULL, "Activity-based energy "
+                                           "model of the routers, links "
+                                           "and CLIPs")
+    router_chiplets = VectorParam.Int([], "Chiplet of each router, for "
+                                      "the per chiplet latency histograms")
+    cdc_sync_latency = Param.Cycles(2, "Synchronizer latency of the CDC "
+                                    "FIFOs in cycles of the receiving "
+                                    "clock")
+    cdc_fifo_depth = Param.Unsigned(8, "Entries in the CDC FIFOs")
+    router_bypass = Param.Bool(False, "Let flits arriving at an idle input "
+                               "port skip the router pipeline")
+    lookahead_routing = Param.Bool(True, "Compute the route one router "
+                                   "ahead, so bypassing flits skip route "
+                                   "computation")
+
+    cxx_exports = [
+        PyBindMethod("getPacketsReceived"),
+        PyBindMethod("getPacketLatency"),
+        PyBindMethod("getPacketsInjected"),
+        PyBindMethod("getPacketsInFlight"),
+        PyBindMethod("resetPacketLatencySamples"),
+        PyBindMethod("getPacketLatencyPercentile"),
+    ]
 
 class GarnetNetworkInterface(ClockedObject):
     type = 'GarnetNetworkInterface'
@@ -72,3 +105,7 @@ class GarnetRouter(BasicRouter):
                           "number of virtual networks")
     width = Param.UInt32(Parent.ni_flit_size,
                           "bit width supported by the router")
+    bypass = Param.Bool(Parent.router_bypass,
+                        "skip the pipeline when the input port is idle")
+    lookahead_routing = Param.Bool(Parent.lookahead_routing,
+                                   "route computed by the upstream router")
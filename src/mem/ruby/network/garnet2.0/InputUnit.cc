@@ -56,6 +56,8 @@ InputUnit::InputUnit(int id, PortDirection direction, Router *router)
         m_num_buffer_reads[i] = 0;
         m_num_buffer_writes[i] = 0;
     }
+    m_num_bypassed = 0;
+    m_bypassing.resize(m_num_vcs, false);
 
     creditQueue = new flitBuffer();
     // Instantiating the virtual channels
@@ -78,6 +80,10 @@ InputUnit::~InputUnit()
  * and updates route in the input VC.
  * The flit is buffered for (m_latency - 1) cycles in the input VC
  * and marked as valid for SwitchAllocation starting that cycle.
+ * With bypass, a flit that finds its VC empty and its output port free
+ * goes for SwitchAllocation after the bypass stages instead. It counts
+ * as bypassed, without being written to and read from the buffer, only
+ * if it wins SA in that cycle (see account_bypass).
  *
  */
 
@@ -114,17 +120,25 @@ InputUnit::wakeup()
             assert(m_vcs[vc]->get_state() == ACTIVE_);
         }
 
+        bool bypass = can_bypass(vc);
 
         // Buffer the flit
         m_vcs[vc]->insertFlit(t_flit);
 
         int vnet = vc/m_vc_per_vnet;
-        // number of writes same as reads
-        // any flit that is written will be read only once
-        m_num_buffer_writes[vnet]++;
-        m_num_buffer_reads[vnet]++;
-
         Cycles pipe_stages = m_router->get_pipe_stages();
+        if (bypass) {
+            DPRINTF(RubyNetwork, "Router[%d] bypassing %s\n",
+                    m_router->get_id(), *t_flit);
+            pipe_stages = m_router->get_bypass_stages();
+            m_bypassing[vc] = true;
+        } else {
+            // number of writes same as reads
+            // any flit that is written will be read only once
+            m_num_buffer_writes[vnet]++;
+            m_num_buffer_reads[vnet]++;
+        }
+
         if (pipe_stages == 1) {
             // 1-cycle router
             // Flit goes for SA directly
@@ -147,6 +161,47 @@ InputUnit::wakeup()
     }
 }
 
+// A flit can bypass the router pipeline if its VC is empty, it does not
+// overtake flits of an ordered vnet, and its output port is free when it
+// reaches SA. Flits arriving at other input ports in the same cycle can
+// still take the port, so the bypass is only a try.
+bool
+InputUnit::can_bypass(int vc)
+{
+    Cycles bypass_stages = m_router->get_bypass_stages();
+    if (bypass_stages == 0)
+        return false;
+
+    int vnet = vc/m_vc_per_vnet;
+    bool ordered = m_router->get_net_ptr()->isVNetOrdered(vnet);
+    for (int i = vnet * m_vc_per_vnet; i < (vnet + 1) * m_vc_per_vnet; i++) {
+        if ((i == vc || ordered) && m_vcs[i]->get_buffered_flits())
+            return false;
+    }
+
+    return m_router->can_bypass(m_id, vc, m_vcs[vc]->get_outport(),
+        m_router->clockEdge(bypass_stages - Cycles(1)));
+}
+
+// Called by SwitchAllocator when the flit at the head of this VC wins the
+// switch. A flit that tried to bypass and lost SA waited in the buffer
+// after all, so it is charged a buffer write and read.
+void
+InputUnit::account_bypass(int vc, bool won)
+{
+    if (!m_bypassing[vc])
+        return;
+    m_bypassing[vc] = false;
+
+    if (won) {
+        m_num_bypassed++;
+    } else {
+        int vnet = vc/m_vc_per_vnet;
+        m_num_buffer_writes[vnet]++;
+        m_num_buffer_reads[vnet]++;
+    }
+}
+
 // Send a credit back to upstream router for this VC.
 // Called by SwitchAllocator when the flit in this VC wins the Switch.
 void
@@ -160,6 +215,24 @@ InputUnit::increment_credit(int in_vc, bool free_signal, Tick curTime)
 }
 
 
+int
+InputUnit::get_buffered_flits() const
+{
+    int flits = 0;
+    for (auto vc : m_vcs)
+        flits += vc->get_buffered_flits();
+    return flits;
+}
+
+int
+InputUnit::get_active_vcs() const
+{
+    int active = 0;
+    for (auto vc : m_vcs)
+        active += (vc->get_state() != IDLE_);
+    return active;
+}
+
 uint32_t
 InputUnit::functionalWrite(Packet *pkt)
 {
@@ -178,4 +251,5 @@ InputUnit::resetStats()
         m_num_buffer_reads[j] = 0;
         m_num_buffer_writes[j] = 0;
     }
+    m_num_bypassed = 0;
 }
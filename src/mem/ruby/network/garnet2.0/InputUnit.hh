@@ -53,6 +53,8 @@ class InputUnit : public Consumer
 
     void wakeup();
     void print(std::ostream& out) const {};
+    bool can_bypass(int vc);
+    void account_bypass(int vc, bool won);
 
     inline PortDirection get_direction() { return m_direction; }
 
@@ -144,6 +146,14 @@ class InputUnit : public Consumer
     { return m_num_buffer_reads[vnet]; }
     double get_buf_write_activity(unsigned int vnet) const
     { return m_num_buffer_writes[vnet]; }
+    uint64_t get_bypassed_flits() const { return m_num_bypassed; }
+
+    // Occupancy of the input VCs, for telemetry
+    int get_buffered_flits() const;
+
+    // No flits in the VCs and no credits waiting for the link
+    bool isIdle() { return !get_buffered_flits() && creditQueue->isEmpty(); }
+    int get_active_vcs() const;
 
     uint32_t functionalWrite(Packet *pkt);
     void resetStats();
@@ -165,6 +175,10 @@ class InputUnit : public Consumer
     // Statistical variables
     std::vector<double> m_num_buffer_writes;
     std::vector<double> m_num_buffer_reads;
+    uint64_t m_num_bypassed;
+
+    // VCs whose only flit tries to bypass the buffer
+    std::vector<bool> m_bypassing;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_INPUTUNIT_HH__
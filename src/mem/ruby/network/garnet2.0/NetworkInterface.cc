@@ -41,6 +41,7 @@
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
 #include "mem/ruby/network/garnet2.0/Credit.hh"
+#include "mem/ruby/network/garnet2.0/NetworkTrace.hh"
 #include "mem/ruby/network/garnet2.0/flitBuffer.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 
@@ -160,6 +161,15 @@ NetworkInterface::incrementStats(flit *t_flit)
         m_net_ptr->increment_received_packets(vnet);
         m_net_ptr->increment_packet_network_latency(network_delay, vnet);
         m_net_ptr->increment_packet_queueing_latency(queueing_delay, vnet);
+        m_net_ptr->sample_packet_latency(network_delay + queueing_delay);
+        m_net_ptr->sample_chiplet_latency(t_flit->get_route().src_ni,
+                                          t_flit->get_route().dest_ni, vnet,
+                                          network_delay, queueing_delay);
+
+        if (NetworkTraceCapture *trace = m_net_ptr->getTraceCapture()) {
+            trace->delivered(t_flit->get_msg_ptr().get(), m_id,
+                             m_net_ptr->curCycle());
+        }
     }
 
     // Hops
@@ -179,12 +189,15 @@ NetworkInterface::incrementStats(flit *t_flit)
 void
 NetworkInterface::wakeup()
 {
-    std::ostringstream oss;
-    for (auto &oPort: outPorts) {
-        oss << oPort->routerID() << "[" << oPort->printVnets() << "] ";
-    }
     DPRINTF(RubyNetwork, "Network Interface %d connected to router:%s "
-            "woke up. Period: %ld\n", m_id, oss.str(), clockPeriod());
+            "woke up. Period: %ld\n", m_id, Trace::lazy([this] {
+                std::ostringstream oss;
+                for (auto &oPort: outPorts) {
+                    oss << oPort->routerID() << "[" << oPort->printVnets()
+                        << "] ";
+                }
+                return oss.str();
+            }), clockPeriod());
 
     assert(curTick() == clockEdge());
     MsgPtr msg_ptr;
@@ -231,11 +244,17 @@ NetworkInterface::wakeup()
             // credits.
             if (t_flit->get_type() == TAIL_ ||
                 t_flit->get_type() == HEAD_TAIL_) {
-                if (!messageEnqueuedThisCycle &&
-                    outNode_ptr[vnet]->areNSlotsAvailable(1, curTime)) {
+                // Messages injected by a trace replay never reach the
+                // protocol
+                bool replayed =
+                    m_net_ptr->traceReplayDelivered(t_flit->get_msg_ptr());
+                if (replayed || (!messageEnqueuedThisCycle &&
+                    outNode_ptr[vnet]->areNSlotsAvailable(1, curTime))) {
                     // Space is available. Enqueue to protocol buffer.
-                    outNode_ptr[vnet]->enqueue(t_flit->get_msg_ptr(), curTime,
-                                               cyclesToTicks(Cycles(1)));
+                    if (!replayed) {
+                        outNode_ptr[vnet]->enqueue(t_flit->get_msg_ptr(),
+                            curTime, cyclesToTicks(Cycles(1)));
+                    }
 
                     // Simply send a credit back since we are not buffering
                     // this flit in the NI
@@ -427,6 +446,12 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
         route.hops_traversed = -1;
 
         m_net_ptr->increment_injected_packets(vnet);
+        if (NetworkTraceCapture *trace = m_net_ptr->getTraceCapture()) {
+            trace->injected(new_net_msg_ptr, m_id, destID, vnet,
+                m_net_ptr->MessageSizeType_to_int(
+                    net_msg_ptr->getMessageSize()),
+                m_net_ptr->curCycle());
+        }
         for (int i = 0; i < num_flits; i++) {
             m_net_ptr->increment_injected_flits(vnet);
             flit *fl = new flit(i, vc, vnet, route, num_flits, new_msg_ptr,
@@ -444,6 +469,20 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
     return true ;
 }
 
+bool
+NetworkInterface::injectMessage(MsgPtr msg_ptr, int vnet)
+{
+    MessageBuffer *b = inNode_ptr.at(vnet);
+    fatal_if(!b, "%s: no protocol buffer for vnet %d\n", name(), vnet);
+
+    Tick curTime = clockEdge();
+    if (!b->areNSlotsAvailable(1, curTime))
+        return false;
+
+    b->enqueue(msg_ptr, curTime, cyclesToTicks(Cycles(1)));
+    return true;
+}
+
 // Looking for a free output vc
 int
 NetworkInterface::calculateVC(int vnet)
@@ -647,6 +686,26 @@ NetworkInterface::functionalWrite(Packet *pkt)
     return num_functional_writes;
 }
 
+bool
+NetworkInterface::isIdle()
+{
+    if (!m_stall_queue.empty())
+        return false;
+    for (auto buffer : m_ni_out_vcs) {
+        if (!buffer->isEmpty())
+            return false;
+    }
+    for (auto &oPort : outPorts) {
+        if (!oPort->outFlitQueue()->isEmpty())
+            return false;
+    }
+    for (auto &iPort : inPorts) {
+        if (!iPort->outCreditQueue()->isEmpty())
+            return false;
+    }
+    return true;
+}
+
 NetworkInterface *
 GarnetNetworkInterfaceParams::create()
 {
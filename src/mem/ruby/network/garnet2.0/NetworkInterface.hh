@@ -74,8 +74,16 @@ class NetworkInterface : public ClockedObject, public Consumer
 
     uint32_t functionalWrite(Packet *);
 
+    // No flit or credit in the NI, for draining. Messages the
+    // controllers have not handed over yet do not count.
+    bool isIdle();
+
     void scheduleFlit(flit *t_flit);
 
+    // Queue a message as if sent by the attached controller. Returns
+    // false if its buffer is full.
+    bool injectMessage(MsgPtr msg_ptr, int vnet);
+
     int get_router_id(int vnet)
     {
         OutputPort *oPort = getOutportForVnet(vnet);
@@ -62,6 +62,16 @@ class NetworkLink : public ClockedObject, public Consumer
     flitBuffer *getBuffer() { return linkBuffer;}
     virtual void wakeup();
 
+    /**
+     * Change the latency or width of the link after it has been built,
+     * e.g. in a child forked for a design space sweep. The link has to
+     * be idle.
+     */
+    Cycles getLatency() const { return m_latency; }
+    void setLatency(Cycles latency) { m_latency = latency; }
+    void setWidth(uint32_t width) { bitWidth = width; }
+    bool isIdle() { return linkBuffer->isEmpty(); }
+
     unsigned int getLinkUtilization() const { return m_link_utilized; }
     const std::vector<unsigned int> & getVcLoad() const { return m_vc_load; }
 
@@ -83,7 +93,7 @@ class NetworkLink : public ClockedObject, public Consumer
   private:
     const int m_id;
     link_type m_type;
-    const Cycles m_latency;
+    Cycles m_latency;
 
   protected:
     flitBuffer *linkBuffer;
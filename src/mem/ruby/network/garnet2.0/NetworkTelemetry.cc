@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "mem/ruby/network/garnet2.0/NetworkTelemetry.hh"
+
+#include <cstring>
+
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "mem/ruby/network/garnet2.0/GarnetEnergyModel.hh"
+#include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
+#include "mem/ruby/network/garnet2.0/NetworkLink.hh"
+#include "mem/ruby/network/garnet2.0/Router.hh"
+
+namespace {
+
+const char telemetryMagic[8] = { 'g', 'e', 'm', '5', 't', 'e', 'l', '1' };
+
+// The energy metrics come last, they are only sampled with an energy
+// model
+const char *routerMetrics[] = {
+    "buffered_flits", "active_vcs", "credit_stalls", "flits",
+    "dyn_energy_pj",
+};
+const int numRouterMetrics = sizeof(routerMetrics) / sizeof(routerMetrics[0]);
+
+const char *linkMetrics[] = {
+    "utilization", "dyn_energy_pj",
+};
+const int numLinkMetrics = sizeof(linkMetrics) / sizeof(linkMetrics[0]);
+
+const double picojoulesPerJoule = 1e12;
+
+/** Increase of a counter that a stats reset may have cleared */
+template <class T>
+T
+counterDelta(T now, T last)
+{
+    return now >= last ? now - last : now;
+}
+
+void
+writeName(std::ostream &os, const char *name)
+{
+    TelemetryName rec;
+    memset(&rec, 0, sizeof(rec));
+    strncpy(rec.name, name, sizeof(rec.name) - 1);
+    os.write(reinterpret_cast<const char *>(&rec), sizeof(rec));
+}
+
+} // anonymous namespace
+
+NetworkTelemetry::NetworkTelemetry(GarnetNetwork *net,
+                                   const std::string &filename,
+                                   Cycles interval)
+    : net(net), energy(nullptr), filename(filename), interval(interval),
+      stream(nullptr),
+      sampleEvent([this]{ sample(); }, net->name() + ".telemetry"),
+      routerMetricCount(0), linkMetricCount(0),
+      sampleTime(Clock::duration::zero()), samples(0), rows(0)
+{
+    fatal_if(interval == 0, "Network telemetry needs a non-zero interval");
+}
+
+NetworkTelemetry::~NetworkTelemetry()
+{
+    close();
+}
+
+void
+NetworkTelemetry::addLink(NetworkLink *link, SwitchID src, SwitchID dest,
+                          bool interposer)
+{
+    assert(!stream);
+
+    TelemetryLink rec;
+    rec.src = src;
+    rec.dest = dest;
+    rec.interposer = interposer;
+    rec.id = link->get_id();
+
+    links.push_back(link);
+    linkTable.push_back(rec);
+}
+
+void
+NetworkTelemetry::start(const std::vector<int> &router_chiplets)
+{
+    const int routers = net->getNumRouters();
+
+    energy = net->getEnergyModel();
+    routerMetricCount = numRouterMetrics - (energy ? 0 : 1);
+    linkMetricCount = numLinkMetrics - (energy ? 0 : 1);
+
+    stream = simout.create(filename, true, true);
+    std::ostream &os = *stream->stream();
+
+    TelemetryHeader header;
+    memcpy(header.magic, telemetryMagic, sizeof(telemetryMagic));
+    header.clockPeriod = net->clockPeriod();
+    header.interval = interval;
+    header.routers = routers;
+    header.links = links.size();
+    header.routerMetrics = routerMetricCount;
+    header.linkMetrics = linkMetricCount;
+    os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    for (int i = 0; i < routerMetricCount; i++)
+        writeName(os, routerMetrics[i]);
+    for (int i = 0; i < linkMetricCount; i++)
+        writeName(os, linkMetrics[i]);
+
+    for (int i = 0; i < routers; i++) {
+        int32_t chiplet = i < router_chiplets.size() ? router_chiplets[i] : 0;
+        os.write(reinterpret_cast<const char *>(&chiplet), sizeof(chiplet));
+    }
+    os.write(reinterpret_cast<const char *>(linkTable.data()),
+             linkTable.size() * sizeof(TelemetryLink));
+
+    lastCreditStalls.resize(routers);
+    lastCrossbar.resize(routers);
+    lastRouterEnergy.resize(routers);
+    for (int i = 0; i < routers; i++) {
+        Router *router = net->getRouter(i);
+        lastCreditStalls[i] = router->get_credit_stalls();
+        lastCrossbar[i] = router->get_crossbar_activity();
+        if (energy)
+            lastRouterEnergy[i] = net->getRouterEnergy(i);
+    }
+    lastLinkFlits.resize(links.size());
+    for (int i = 0; i < links.size(); i++)
+        lastLinkFlits[i] = links[i]->getLinkUtilization();
+
+    ticks.resize(blockRows);
+    columns.resize((routerMetricCount * routers +
+                    linkMetricCount * links.size()) * blockRows);
+
+    startTime = Clock::now();
+    net->schedule(sampleEvent, net->clockEdge(interval));
+}
+
+void
+NetworkTelemetry::sample()
+{
+    Clock::time_point begin = Clock::now();
+    const int routers = lastCreditStalls.size();
+
+    ticks[rows] = curTick();
+    float *column = &columns[rows];
+
+    // Columns are metric major, matching the file layout
+    for (int i = 0; i < routers; i++) {
+        Router *router = net->getRouter(i);
+        uint64_t stalls = router->get_credit_stalls();
+        double crossbar = router->get_crossbar_activity();
+
+        column[(0 * routers + i) * blockRows] = router->get_buffered_flits();
+        column[(1 * routers + i) * blockRows] = router->get_active_vcs();
+        column[(2 * routers + i) * blockRows] =
+            counterDelta(stalls, lastCreditStalls[i]);
+        column[(3 * routers + i) * blockRows] =
+            counterDelta(crossbar, lastCrossbar[i]);
+
+        lastCreditStalls[i] = stalls;
+        lastCrossbar[i] = crossbar;
+
+        if (energy) {
+            double router_energy = net->getRouterEnergy(i);
+            column[(4 * routers + i) * blockRows] = picojoulesPerJoule *
+                counterDelta(router_energy, lastRouterEnergy[i]);
+            lastRouterEnergy[i] = router_energy;
+        }
+    }
+
+    column += routerMetricCount * routers * blockRows;
+    for (int i = 0; i < links.size(); i++) {
+        unsigned int flits = links[i]->getLinkUtilization();
+        unsigned int delta = counterDelta(flits, lastLinkFlits[i]);
+        column[i * blockRows] = float(delta) / interval;
+        lastLinkFlits[i] = flits;
+
+        if (energy) {
+            column[(links.size() + i) * blockRows] = picojoulesPerJoule *
+                energy->linkEnergy(delta, links[i]->bitWidth,
+                                   linkTable[i].interposer);
+        }
+    }
+
+    if (++rows == blockRows)
+        writeBlock();
+
+    net->schedule(sampleEvent, net->clockEdge(interval));
+
+    sampleTime += Clock::now() - begin;
+    samples++;
+}
+
+void
+NetworkTelemetry::writeBlock()
+{
+    if (rows == 0)
+        return;
+
+    std::ostream &os = *stream->stream();
+    uint32_t block_rows = rows;
+    os.write(reinterpret_cast<const char *>(&block_rows),
+             sizeof(block_rows));
+    os.write(reinterpret_cast<const char *>(ticks.data()),
+             rows * sizeof(uint64_t));
+    for (size_t col = 0; col < columns.size(); col += blockRows) {
+        os.write(reinterpret_cast<const char *>(&columns[col]),
+                 rows * sizeof(float));
+    }
+    rows = 0;
+}
+
+void
+NetworkTelemetry::close()
+{
+    if (sampleEvent.scheduled())
+        net->deschedule(sampleEvent);
+
+    if (stream) {
+        writeBlock();
+        simout.close(stream);
+        stream = nullptr;
+
+        double sample_secs =
+            std::chrono::duration<double>(sampleTime).count();
+        double total_secs =
+            std::chrono::duration<double>(Clock::now() - startTime).count();
+        if (samples && total_secs > 0) {
+            inform("Network telemetry: %d samples, %.1f us each, %.2f%% "
+                   "of the host time", samples, 1e6 * sample_secs / samples,
+                   100 * sample_secs / total_secs);
+        }
+    }
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_NETWORKTELEMETRY_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_NETWORKTELEMETRY_HH__
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/ruby/common/TypeDefines.hh"
+#include "sim/eventq.hh"
+
+class GarnetEnergyModel;
+class GarnetNetwork;
+class NetworkLink;
+class OutputStream;
+
+/*
+ * Network telemetry samples router and internal link counters every
+ * interval cycles into a time series, to show phase behaviour and
+ * transient hotspots that the whole run stats average away. Sampling
+ * only reads counters the routers and links keep anyway, so its cost
+ * is a few loads per input VC and link per interval. With an energy
+ * model, routers and links also report their dynamic energy per
+ * interval.
+ * util/garnet_heatmap.py renders the series.
+ *
+ * File layout (host byte order): a TelemetryHeader, the router metric
+ * names and then the link metric names (TelemetryName each), the chiplet
+ * of every router (int32_t), a TelemetryLink per internal link, then
+ * blocks of samples. A block is a uint32_t row count followed by its
+ * columns one after the other: the uint64_t tick of every sample, then a
+ * float column per router metric and router (metric major), then one
+ * per link metric and link.
+ */
+
+struct TelemetryHeader
+{
+    char magic[8];
+    /** Period of the network clock */
+    uint64_t clockPeriod;
+    /** Cycles between samples */
+    uint64_t interval;
+    uint32_t routers;
+    uint32_t links;
+    uint32_t routerMetrics;
+    uint32_t linkMetrics;
+};
+
+struct TelemetryName
+{
+    char name[24];
+};
+
+struct TelemetryLink
+{
+    uint32_t src;
+    uint32_t dest;
+    /** Non-zero for links with CLIP at both ends */
+    uint32_t interposer;
+    uint32_t id;
+};
+
+class NetworkTelemetry
+{
+  public:
+    NetworkTelemetry(GarnetNetwork *net, const std::string &filename,
+                     Cycles interval);
+    ~NetworkTelemetry();
+
+    /** Register an internal link, before start() */
+    void addLink(NetworkLink *link, SwitchID src, SwitchID dest,
+                 bool interposer);
+
+    /** Write the tables and schedule the first sample */
+    void start(const std::vector<int> &router_chiplets);
+
+    /**
+     * Write the samples taken so far and stop sampling. Reports the
+     * host time spent sampling, as a share of the host time since
+     * start().
+     */
+    void close();
+
+  private:
+    /** Rows buffered before a block is written */
+    static const int blockRows = 256;
+
+    typedef std::chrono::steady_clock Clock;
+
+    void sample();
+    void writeBlock();
+
+    GarnetNetwork *net;
+    /** Adds the dynamic energy metrics when set */
+    GarnetEnergyModel *energy;
+    const std::string filename;
+    const Cycles interval;
+    OutputStream *stream;
+    EventFunctionWrapper sampleEvent;
+
+    std::vector<NetworkLink *> links;
+    std::vector<TelemetryLink> linkTable;
+
+    /** Counter values at the last sample, to take differences */
+    std::vector<uint64_t> lastCreditStalls;
+    std::vector<double> lastCrossbar;
+    std::vector<unsigned int> lastLinkFlits;
+    std::vector<double> lastRouterEnergy;
+
+    int routerMetricCount;
+    int linkMetricCount;
+
+    /** Host time spent in sample() and when sampling started */
+    Clock::duration sampleTime;
+    Clock::time_point startTime;
+    uint64_t samples;
+
+    int rows;
+    std::vector<uint64_t> ticks;
+    /** Column major, blockRows values per column */
+    std::vector<float> columns;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_NETWORKTELEMETRY_HH__
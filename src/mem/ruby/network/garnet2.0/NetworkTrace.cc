@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "mem/ruby/network/garnet2.0/NetworkTrace.hh"
+
+#include <cstring>
+#include <fstream>
+
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "mem/ruby/common/Address.hh"
+
+namespace {
+
+const char traceMagic[8] = { 'g', 'e', 'm', '5', 'n', 't', 'r', '1' };
+
+} // anonymous namespace
+
+void
+readNetworkTrace(const std::string &filename, NetworkTraceHeader &header,
+                 std::vector<NetworkTraceRecord> &records)
+{
+    std::ifstream in(filename, std::ios::binary);
+    fatal_if(!in, "Can't open network trace %s\n", filename);
+
+    in.read(reinterpret_cast<char *>(&header), sizeof(header));
+    fatal_if(!in || memcmp(header.magic, traceMagic, sizeof(traceMagic)),
+             "%s is not a network trace\n", filename);
+
+    in.seekg(0, std::ios::end);
+    std::streamoff bytes = in.tellg() - std::streamoff(sizeof(header));
+    fatal_if(bytes % sizeof(NetworkTraceRecord),
+             "Network trace %s is truncated\n", filename);
+
+    records.resize(bytes / sizeof(NetworkTraceRecord));
+    in.seekg(sizeof(header));
+    in.read(reinterpret_cast<char *>(records.data()), bytes);
+    fatal_if(!in, "Error reading network trace %s\n", filename);
+
+    for (uint32_t i = 0; i < records.size(); ++i) {
+        const NetworkTraceRecord &rec = records[i];
+        fatal_if(rec.id != i || rec.src >= header.nodes ||
+                 rec.dest >= header.nodes || rec.vnet >= header.vnets ||
+                 (rec.dependency != NetworkTraceRecord::NoDependency &&
+                  rec.dependency >= i),
+                 "Network trace %s: bad record %d\n", filename, i);
+    }
+}
+
+NetworkTraceCapture::NetworkTraceCapture(const std::string &filename,
+                                         uint32_t nodes, uint32_t vnets,
+                                         Tick clock_period,
+                                         Cycles dep_window)
+    : depWindow(dep_window), nextId(0), lastDelivery(nodes)
+{
+    stream = simout.create(filename, true, true);
+
+    NetworkTraceHeader header;
+    memcpy(header.magic, traceMagic, sizeof(traceMagic));
+    header.nodes = nodes;
+    header.vnets = vnets;
+    header.clockPeriod = clock_period;
+    stream->stream()->write(reinterpret_cast<const char *>(&header),
+                            sizeof(header));
+}
+
+NetworkTraceCapture::~NetworkTraceCapture()
+{
+    close();
+}
+
+void
+NetworkTraceCapture::injected(const Message *msg, NodeID src, NodeID dest,
+                              int vnet, int size, Cycles now)
+{
+    if (!stream)
+        return;
+
+    Addr addr = msg->getaddr();
+    if (addr != MaxAddr)
+        addr = makeLineAddress(addr);
+
+    NetworkTraceRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.cycle = now;
+    rec.addr = addr;
+    rec.id = nextId++;
+    rec.dependency = NetworkTraceRecord::NoDependency;
+    rec.src = src;
+    rec.dest = dest;
+    rec.size = size;
+    rec.sizeType = msg->getMessageSize();
+    rec.vnet = vnet;
+
+    // A node that sends a message for a line it just received a message
+    // for is most likely answering or forwarding that message
+    if (addr != MaxAddr) {
+        auto it = lastDelivery[src].find(addr);
+        if (it != lastDelivery[src].end() &&
+            now - it->second.cycle <= depWindow) {
+            rec.dependency = it->second.id;
+            rec.slack = now - it->second.cycle;
+        }
+    }
+
+    inFlight[msg] = rec.id;
+    stream->stream()->write(reinterpret_cast<const char *>(&rec),
+                            sizeof(rec));
+}
+
+void
+NetworkTraceCapture::delivered(const Message *msg, NodeID dest, Cycles now)
+{
+    auto it = inFlight.find(msg);
+    if (it == inFlight.end())
+        return;
+
+    Addr addr = msg->getaddr();
+    if (addr != MaxAddr)
+        lastDelivery[dest][makeLineAddress(addr)] = { it->second, now };
+
+    inFlight.erase(it);
+}
+
+void
+NetworkTraceCapture::close()
+{
+    if (stream) {
+        simout.close(stream);
+        stream = nullptr;
+    }
+}
+
+void
+NetworkTraceMsg::print(std::ostream &out) const
+{
+    ccprintf(out, "[NetworkTraceMsg id=%d src=%d dest=%d vnet=%d "
+             "addr=%#x]", record.id, record.src, record.dest, record.vnet,
+             record.addr);
+}
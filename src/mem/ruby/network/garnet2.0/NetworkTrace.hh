@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_NETWORKTRACE_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_NETWORKTRACE_HH__
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/ruby/common/TypeDefines.hh"
+#include "mem/ruby/slicc_interface/Message.hh"
+
+class OutputStream;
+
+/*
+ * Network traces record every message injected into Garnet, one record
+ * per destination of multicast messages, together with the message it
+ * most likely depends on: the last message for the same cache line
+ * that was delivered to the injecting node, if that delivery is
+ * recent. GarnetTraceReplay (src/cpu/testers/garnet_trace_replay)
+ * drives a network from such a trace without the protocol, injecting
+ * a dependent message only once its dependency was delivered.
+ *
+ * File layout (host byte order): a NetworkTraceHeader followed by
+ * NetworkTraceRecords in injection order.
+ */
+
+struct NetworkTraceHeader
+{
+    char magic[8];
+    uint32_t nodes;
+    uint32_t vnets;
+    /** Period of the network clock the cycles are counted in */
+    uint64_t clockPeriod;
+};
+
+struct NetworkTraceRecord
+{
+    static const uint32_t NoDependency = UINT32_MAX;
+
+    /** Injection cycle */
+    uint64_t cycle;
+    /** Line address, MaxAddr if the message has none */
+    uint64_t addr;
+    /** Ids number the records from zero */
+    uint32_t id;
+    uint32_t dependency;
+    /** Cycles between delivery of the dependency and injection */
+    uint32_t slack;
+    uint16_t src;
+    uint16_t dest;
+    /** Size in bytes and as MessageSizeType */
+    uint16_t size;
+    uint8_t sizeType;
+    uint8_t vnet;
+};
+
+static_assert(sizeof(NetworkTraceRecord) == 40,
+              "NetworkTraceRecord layout changed");
+
+/** Check and read a network trace, fatal() on errors */
+void readNetworkTrace(const std::string &filename,
+                      NetworkTraceHeader &header,
+                      std::vector<NetworkTraceRecord> &records);
+
+/** Records the messages injected into a network */
+class NetworkTraceCapture
+{
+  public:
+    NetworkTraceCapture(const std::string &filename, uint32_t nodes,
+                        uint32_t vnets, Tick clock_period,
+                        Cycles dep_window);
+    ~NetworkTraceCapture();
+
+    void injected(const Message *msg, NodeID src, NodeID dest, int vnet,
+                  int size, Cycles now);
+    void delivered(const Message *msg, NodeID dest, Cycles now);
+
+    void close();
+
+  private:
+    struct Delivery
+    {
+        uint32_t id;
+        Cycles cycle;
+    };
+
+    OutputStream *stream;
+    const Cycles depWindow;
+    uint32_t nextId;
+
+    /** Ids of the messages in the network */
+    std::unordered_map<const Message *, uint32_t> inFlight;
+    /** Last delivery per node and line address */
+    std::vector<std::unordered_map<Addr, Delivery>> lastDelivery;
+};
+
+/** A message injected by GarnetTraceReplay */
+class NetworkTraceMsg : public Message
+{
+  public:
+    NetworkTraceMsg(Tick cur_time, const NetworkTraceRecord &record,
+                    const NetDest &dest)
+        : Message(cur_time), record(record), destination(dest),
+          messageSize((MessageSizeType)record.sizeType),
+          address(record.addr)
+    { }
+
+    MsgPtr clone() const { return std::make_shared<NetworkTraceMsg>(*this); }
+    void print(std::ostream &out) const;
+
+    const MessageSizeType &getMessageSize() const { return messageSize; }
+    MessageSizeType &getMessageSize() { return messageSize; }
+    const NetDest &getDestination() const { return destination; }
+    NetDest &getDestination() { return destination; }
+    const Addr &getaddr() const { return address; }
+
+    bool functionalRead(Packet *pkt) { return false; }
+    bool functionalWrite(Packet *pkt) { return false; }
+
+    const NetworkTraceRecord record;
+
+  private:
+    NetDest destination;
+    MessageSizeType messageSize;
+    Addr address;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_NETWORKTRACE_HH__
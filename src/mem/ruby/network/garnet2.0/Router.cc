@@ -33,6 +33,7 @@
 
 #include "mem/ruby/network/garnet2.0/Router.hh"
 
+#include "base/logging.hh"
 #include "base/stl_helpers.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
@@ -51,6 +52,16 @@ Router::Router(const Params *p)
     : BasicRouter(p), Consumer(this)
 {
     m_latency = p->latency;
+    // Without lookahead routing the route is computed in a cycle of its
+    // own before SA
+    m_bypass_stages = Cycles(p->bypass ? (p->lookahead_routing ? 1 : 2) : 0);
+    if (m_bypass_stages && m_bypass_stages >= m_latency) {
+        // The bypass would not be shorter than the pipeline
+        warn_once("Router bypass needs a router latency above %d cycles, "
+                  "disabled on routers with %d\n", m_bypass_stages,
+                  m_latency);
+        m_bypass_stages = Cycles(0);
+    }
     m_virtual_networks = p->virt_nets;
     m_vc_per_vnet = p->vcs_per_vnet;
     m_num_vcs = m_virtual_networks * m_vc_per_vnet;
@@ -180,6 +191,12 @@ Router::route_compute(RouteInfo route, int inport, PortDirection inport_dirn)
     return m_routing_unit->outportCompute(route, inport, inport_dirn);
 }
 
+bool
+Router::can_bypass(int inport, int invc, int outport, Tick time)
+{
+    return m_sw_alloc->can_bypass(inport, invc, outport, time);
+}
+
 void
 Router::grant_switch(int inport, flit *t_flit)
 {
@@ -238,6 +255,11 @@ Router::regStats()
         .name(name() + ".sw_output_arbiter_activity")
         .flags(Stats::nozero)
     ;
+
+    m_bypassed_flits
+        .name(name() + ".bypassed_flits")
+        .flags(Stats::nozero)
+    ;
 }
 
 void
@@ -253,6 +275,91 @@ Router::collateStats()
     m_sw_input_arbiter_activity = m_sw_alloc->get_input_arbiter_activity();
     m_sw_output_arbiter_activity = m_sw_alloc->get_output_arbiter_activity();
     m_crossbar_activity = m_switch->get_crossbar_activity();
+    m_bypassed_flits = get_bypassed_flits();
+}
+
+int
+Router::get_buffered_flits() const
+{
+    int flits = 0;
+    for (auto input_unit : m_input_unit)
+        flits += input_unit->get_buffered_flits();
+    return flits;
+}
+
+bool
+Router::isIdle()
+{
+    if (!m_switch->isIdle())
+        return false;
+    for (auto input_unit : m_input_unit) {
+        if (!input_unit->isIdle())
+            return false;
+    }
+    for (auto output_unit : m_output_unit) {
+        if (!output_unit->getOutQueue()->isEmpty())
+            return false;
+    }
+    return true;
+}
+
+int
+Router::get_active_vcs() const
+{
+    int active = 0;
+    for (auto input_unit : m_input_unit)
+        active += input_unit->get_active_vcs();
+    return active;
+}
+
+uint64_t
+Router::get_credit_stalls() const
+{
+    return m_sw_alloc->get_credit_stalls();
+}
+
+double
+Router::get_crossbar_activity() const
+{
+    return m_switch->get_crossbar_activity();
+}
+
+double
+Router::get_buffer_reads() const
+{
+    double reads = 0;
+    for (auto input_unit : m_input_unit) {
+        for (int vnet = 0; vnet < m_virtual_networks; vnet++)
+            reads += input_unit->get_buf_read_activity(vnet);
+    }
+    return reads;
+}
+
+double
+Router::get_buffer_writes() const
+{
+    double writes = 0;
+    for (auto input_unit : m_input_unit) {
+        for (int vnet = 0; vnet < m_virtual_networks; vnet++)
+            writes += input_unit->get_buf_write_activity(vnet);
+    }
+    return writes;
+}
+
+double
+Router::get_arbiter_activity() const
+{
+    return m_sw_alloc->get_input_arbiter_activity() +
+        m_sw_alloc->get_output_arbiter_activity();
+}
+
+uint64_t
+Router::get_bypassed_flits() const
+{
+    uint64_t flits = 0;
+    for (auto input_unit : m_input_unit)
+        flits += input_unit->get_bypassed_flits();
+    return flits;
 }
 
 void
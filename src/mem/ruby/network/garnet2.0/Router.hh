@@ -73,11 +73,13 @@ class Router : public BasicRouter, public Consumer
                     int link_weight, CreditLink *credit_link);
 
     Cycles get_pipe_stages(){ return m_latency; }
+    // Stages of a flit that bypasses the pipeline, 0 without bypass
+    Cycles get_bypass_stages() const { return m_bypass_stages; }
     int get_num_vcs()       { return m_num_vcs; }
     int get_num_vnets()     { return m_virtual_networks; }
     int get_vc_per_vnet()   { return m_vc_per_vnet; }
-    int get_num_inports()   { return m_input_unit.size(); }
-    int get_num_outports()  { return m_output_unit.size(); }
+    int get_num_inports() const { return m_input_unit.size(); }
+    int get_num_outports() const { return m_output_unit.size(); }
     int get_id()            { return m_id; }
 
     void init_net_ptr(GarnetNetwork* net_ptr)
@@ -92,6 +94,7 @@ class Router : public BasicRouter, public Consumer
     PortDirection getInportDirection(int inport);
 
     int route_compute(RouteInfo route, int inport, PortDirection direction);
+    bool can_bypass(int inport, int invc, int outport, Tick time);
     void grant_switch(int inport, flit *t_flit);
     void schedule_wakeup(Cycles time);
 
@@ -103,6 +106,21 @@ class Router : public BasicRouter, public Consumer
     void collateStats();
     void resetStats();
 
+    // Instantaneous occupancy and running counters for telemetry
+    int get_buffered_flits() const;
+    int get_active_vcs() const;
+    // No flit or credit anywhere in the router, for draining
+    bool isIdle();
+    uint64_t get_credit_stalls() const;
+    double get_crossbar_activity() const;
+
+    // Activity since the last reset, for the energy model
+    double get_buffer_reads() const;
+    double get_buffer_writes() const;
+    double get_arbiter_activity() const;
+    uint32_t get_bit_width() const { return m_bit_width; }
+    uint64_t get_bypassed_flits() const;
+
     // For Fault Model:
     bool get_fault_vector(int temperature, float fault_vector[]) {
         return m_network_ptr->fault_model->fault_vector(m_id, temperature,
@@ -121,6 +139,7 @@ class Router : public BasicRouter, public Consumer
 
   private:
     Cycles m_latency;
+    Cycles m_bypass_stages;
     int m_virtual_networks, m_num_vcs, m_vc_per_vnet;
     GarnetNetwork *m_network_ptr;
 
@@ -138,6 +157,8 @@ class Router : public BasicRouter, public Consumer
     Stats::Scalar m_sw_output_arbiter_activity;
 
     Stats::Scalar m_crossbar_activity;
+
+    Stats::Scalar m_bypassed_flits;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_ROUTER_HH__
@@ -48,6 +48,7 @@ SwitchAllocator::SwitchAllocator(Router *router)
 
     m_input_arbiter_activity = 0;
     m_output_arbiter_activity = 0;
+    m_credit_stalls = 0;
 }
 
 void
@@ -193,6 +194,11 @@ SwitchAllocator::arbitrate_outports()
                 // remove flit from Input VC
                 flit *t_flit = m_input_unit[inport]->getTopFlit(invc);
 
+                // A bypassing flit only skipped the buffer if it won SA
+                // in the cycle it became ready
+                m_input_unit[inport]->account_bypass(invc,
+                    t_flit->get_stage().second == curTick());
+
                 DPRINTF(RubyNetwork, "SwitchAllocator at Router %d "
                                      "granted outvc %d at outport %d "
                                      "to invc %d at inport %d to flit %s at "
@@ -309,8 +315,10 @@ SwitchAllocator::send_allowed(int inport, int invc, int outport, int outvc)
     }
 
     // cannot send if no outvc or no credit.
-    if (!has_outvc || !has_credit)
+    if (!has_outvc || !has_credit) {
+        m_credit_stalls++;
         return false;
+    }
 
 
     // protocol ordering check
@@ -336,6 +344,36 @@ SwitchAllocator::send_allowed(int inport, int invc, int outport, int outvc)
     return true;
 }
 
+/*
+ * A flit that bypasses the router pipeline goes straight for SA, which
+ * it must win. So the output port must be able to take it, and no other
+ * flit in the router may request that port when it gets there.
+ */
+
+bool
+SwitchAllocator::can_bypass(int inport, int invc, int outport, Tick time)
+{
+    int outvc = m_input_unit[inport]->get_outvc(invc);
+    if (outvc == -1) {
+        if (!m_output_unit[outport]->has_free_vc(get_vnet(invc)))
+            return false;
+    } else if (!m_output_unit[outport]->has_credit(outvc)) {
+        return false;
+    }
+
+    for (int i = 0; i < m_num_inports; i++) {
+        for (int vc = 0; vc < m_num_vcs; vc++) {
+            if ((i != inport || vc != invc) &&
+                m_input_unit[i]->need_stage(vc, SA_, time) &&
+                m_input_unit[i]->get_outport(vc) == outport) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
 // Assign a free VC to the winner of the output port.
 int
 SwitchAllocator::vc_allocate(int outport, int inport, int invc)
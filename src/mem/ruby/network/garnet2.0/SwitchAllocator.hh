@@ -57,6 +57,7 @@ class SwitchAllocator : public Consumer
     void arbitrate_inports();
     void arbitrate_outports();
     bool send_allowed(int inport, int invc, int outport, int outvc);
+    bool can_bypass(int inport, int invc, int outport, Tick time);
     int vc_allocate(int outport, int inport, int invc);
 
     inline double
@@ -70,6 +71,10 @@ class SwitchAllocator : public Consumer
         return m_output_arbiter_activity;
     }
 
+    // Switch requests that found no free output VC or credit, not reset
+    // with the stats so that telemetry can take differences
+    uint64_t get_credit_stalls() const { return m_credit_stalls; }
+
     void resetStats();
 
   private:
@@ -77,6 +82,7 @@ class SwitchAllocator : public Consumer
     int m_num_vcs, m_vc_per_vnet;
 
     double m_input_arbiter_activity, m_output_arbiter_activity;
+    uint64_t m_credit_stalls;
 
     Router *m_router;
     std::vector<int> m_round_robin_invc;
@@ -56,6 +56,7 @@ class VirtualChannel
     inline Tick get_enqueue_time()          { return m_enqueue_time; }
     inline void set_enqueue_time(Tick time) { m_enqueue_time = time; }
     inline VC_state_type get_state()        { return m_vc_state.first; }
+    inline int get_buffered_flits() { return m_input_buffer->getSize(); }
 
     inline bool isReady(Tick curTime)
     {
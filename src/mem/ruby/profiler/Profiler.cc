@@ -167,6 +167,12 @@ Profiler::regStats(const std::string &pName)
         .desc("")
         .flags(Stats::nozero | Stats::pdf | Stats::oneline);
 
+    m_missLatencyLogHistSeqr
+        .init(5, 1 << 24)
+        .name(pName + ".miss_latency_log_hist_seqr")
+        .desc("miss latency in cycles with percentiles")
+        .flags(Stats::nozero);
+
     for (int i = 0; i < RubyRequestType_NUM; i++) {
         m_typeLatencyHistSeqr.push_back(new Stats::Histogram());
         m_typeLatencyHistSeqr[i]
@@ -399,6 +405,7 @@ Profiler::collateStats()
                 m_latencyHistSeqr.add(seq->getLatencyHist());
                 m_hitLatencyHistSeqr.add(seq->getHitLatencyHist());
                 m_missLatencyHistSeqr.add(seq->getMissLatencyHist());
+                m_missLatencyLogHistSeqr.add(seq->getMissLatencyLogHist());
 
                 // add the per request type latencies
                 for (uint32_t j = 0; j < RubyRequestType_NUM; ++j) {
@@ -117,6 +117,7 @@ class Profiler
     //! miss in the controller connected to this sequencer.
     Stats::Histogram m_missLatencyHistSeqr;
     Stats::Histogram m_missLatencyHistCoalsr;
+    Stats::LogHistogram m_missLatencyLogHistSeqr;
     std::vector<Stats::Histogram *> m_missTypeLatencyHistSeqr;
     std::vector<Stats::Histogram *> m_missTypeLatencyHistCoalsr;
 
@@ -98,6 +98,14 @@ class Message
     virtual NetDest& getDestination()
     { panic("getDestination() called on wrong message!"); }
 
+    // Address of the message, overridden by the generated accessor of
+    // messages with an addr field. MaxAddr if there is none.
+    virtual const Addr& getaddr() const
+    {
+        static const Addr none = MaxAddr;
+        return none;
+    }
+
     int getIncomingLink() const { return incoming_link; }
     void setIncomingLink(int link) { incoming_link = link; }
     int getVnet() const { return vnet; }
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/structures/IndirectPrefetcher.hh"
+
+#include "debug/RubyPrefetcher.hh"
+#include "mem/ruby/system/RubySystem.hh"
+
+IndirectPrefetcher*
+RubyIndirectPrefetcherParams::create()
+{
+    return new IndirectPrefetcher(this);
+}
+
+IndirectPrefetcher::IndirectPrefetcher(const Params *p)
+    : Prefetcher(p), imp(*p->imp)
+{
+}
+
+void
+IndirectPrefetcher::observeLoadHit(Addr address, Addr pc, int size,
+                                   const DataBlock& data)
+{
+    observeLoad(address, pc, size, false, &data);
+}
+
+void
+IndirectPrefetcher::observeLoadMiss(Addr address, Addr pc)
+{
+    observeLoad(address, pc, 0, true, nullptr);
+}
+
+void
+IndirectPrefetcher::observeLoad(Addr address, Addr pc, int size, bool miss,
+                                const DataBlock *data)
+{
+    // Index streams are identified by their PC
+    if (pc == 0) {
+        return;
+    }
+
+    const Addr line_addr = makeLineAddress(address);
+    auto read_index = [data, line_addr](Addr addr, unsigned size,
+                                        Addr &index) {
+        return data != nullptr && size <= sizeof(uint64_t) &&
+               makeLineAddress(addr) == line_addr &&
+               getOffset(addr) + size <= RubySystem::getBlockSizeBytes() &&
+               IndirectMemoryPredictor::decodeIndex(
+                   data->getData(getOffset(addr), size), size, index);
+    };
+
+    candidates.clear();
+    imp.calculatePrefetch(pc, address, size, false, miss, read_index,
+                          candidates);
+
+    Addr last_line_addr = line_addr;
+    for (Addr pf_addr : candidates) {
+        Addr pf_line_addr = makeLineAddress(pf_addr);
+        if (pf_line_addr == last_line_addr) {
+            continue;
+        }
+        last_line_addr = pf_line_addr;
+
+        numIndirectRequested++;
+        DPRINTF(RubyPrefetcher, "Indirect prefetch candidate %#x\n",
+                pf_line_addr);
+        issuePrefetch(pf_line_addr, RubyRequestType_LD);
+    }
+}
+
+void
+IndirectPrefetcher::regStats()
+{
+    Prefetcher::regStats();
+
+    numIndirectRequested
+        .name(name() + ".indirect_prefetches_requested")
+        .desc("number of prefetch requests made on behalf of the IMP")
+        ;
+}
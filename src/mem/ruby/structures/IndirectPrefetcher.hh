@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_STRUCTURES_INDIRECTPREFETCHER_HH__
+#define __MEM_RUBY_STRUCTURES_INDIRECTPREFETCHER_HH__
+
+// Indirect memory prefetching (IMP) for the Ruby L1 caches
+
+#include <vector>
+
+#include "mem/cache/prefetch/indirect_memory.hh"
+#include "mem/ruby/structures/Prefetcher.hh"
+#include "params/RubyIndirectPrefetcher.hh"
+
+/**
+ * Ruby front-end of the IndirectMemoryPredictor. On top of the stream
+ * buffers of the base prefetcher, it trains the IMP with the demand
+ * loads of the L1 and enqueues the candidates in the prefetch queue of
+ * the controller. The indices are read from the data of the line being
+ * hit, so the lookahead is limited to the rest of that line.
+ */
+class IndirectPrefetcher : public Prefetcher
+{
+    public:
+        typedef RubyIndirectPrefetcherParams Params;
+        IndirectPrefetcher(const Params *p);
+
+        void observeLoadHit(Addr address, Addr pc, int size,
+                            const DataBlock& data) override;
+        void observeLoadMiss(Addr address, Addr pc) override;
+
+        void regStats() override;
+
+    private:
+        /**
+         * Train the IMP and enqueue its candidates
+         * @param address physical address of the load
+         * @param pc PC of the load
+         * @param size size in bytes of the load
+         * @param miss whether the load missed
+         * @param data data of the line of the load, nullptr on misses
+         */
+        void observeLoad(Addr address, Addr pc, int size, bool miss,
+                         const DataBlock *data);
+
+        /** IMP object */
+        IndirectMemoryPredictor &imp;
+
+        /** Scratch space for the candidates of the IMP */
+        std::vector<Addr> candidates;
+
+        //! Count of prefetch requests made on behalf of the IMP
+        Stats::Scalar numIndirectRequested;
+};
+
+#endif // __MEM_RUBY_STRUCTURES_INDIRECTPREFETCHER_HH__
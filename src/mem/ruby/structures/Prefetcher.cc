@@ -28,6 +28,7 @@
 
 #include "mem/ruby/structures/Prefetcher.hh"
 
+#include "base/logging.hh"
 #include "debug/RubyPrefetcher.hh"
 #include "mem/ruby/slicc_interface/RubySlicc_ComponentMapping.hh"
 #include "mem/ruby/system/RubySystem.hh"
@@ -47,10 +48,17 @@ Prefetcher::Prefetcher(const Params *p)
     m_negative_filter(p->unit_filter, 0),
     m_nonunit_filter(p->nonunit_filter, 0),
     m_prefetch_cross_pages(p->cross_page),
-    m_page_shift(p->sys->getPageShift())
+    m_page_shift(p->sys->getPageShift()),
+    m_pf_queue_size(p->queue_size), m_issue_width(p->issue_width),
+    m_throttle_buffer(p->throttle_buffer),
+    m_throttle_occupancy(p->throttle_occupancy),
+    m_issue_cycle(0), m_issued_this_cycle(0),
+    m_issue_event([this]{ issueQueuedPrefetches(); }, name())
 {
     assert(m_num_streams > 0);
     assert(m_num_startup_pfs <= MAX_PF_INFLIGHT);
+    fatal_if(m_pf_queue_size == 0, "%s: queue_size must be positive",
+             name());
 
     // create +1 stride filter
     m_unit_filter_index = 0;
@@ -84,6 +92,23 @@ Prefetcher::~Prefetcher()
     delete m_nonunit_hit;
 }
 
+DrainState
+Prefetcher::drain()
+{
+    if (m_issue_event.scheduled()) {
+        deschedule(m_issue_event);
+    }
+    return DrainState::Drained;
+}
+
+void
+Prefetcher::drainResume()
+{
+    if (!m_pf_queue.empty()) {
+        schedule(m_issue_event, m_controller->clockEdge(Cycles(1)));
+    }
+}
+
 void
 Prefetcher::regStats()
 {
@@ -133,6 +158,29 @@ Prefetcher::regStats()
         .name(name() + ".misses_on_prefetched_blocks")
         .desc("number of misses for blocks that were prefetched, yet missed")
         ;
+
+    numUnusedPrefetches
+        .name(name() + ".unused_prefetches")
+        .desc("number of prefetched blocks evicted before being accessed")
+        ;
+
+    numThrottledPrefetches
+        .name(name() + ".throttled_prefetches")
+        .desc("number of times the throttle held back the prefetch queue")
+        ;
+
+    accuracy
+        .name(name() + ".accuracy")
+        .desc("fraction of the accepted prefetches that were used")
+        ;
+    accuracy = (numHits + numPartialHits) / numPrefetchAccepted;
+
+    coverage
+        .name(name() + ".coverage")
+        .desc("fraction of the misses avoided or shortened by prefetches")
+        ;
+    coverage = (numHits + numPartialHits) /
+        (numHits + numPartialHits + numMissObserved);
 }
 
 void
@@ -219,6 +267,73 @@ Prefetcher::observePfHit(Addr address)
     issueNextPrefetch(address, NULL);
 }
 
+void
+Prefetcher::observePfEvict(Addr address)
+{
+    numUnusedPrefetches++;
+    DPRINTF(RubyPrefetcher, "Observed unused eviction for %#x\n", address);
+}
+
+void
+Prefetcher::issuePrefetch(Addr line_addr, const RubyRequestType& type)
+{
+    numPrefetchRequested++;
+
+    for (const auto &pf : m_pf_queue) {
+        if (pf.first == line_addr) {
+            DPRINTF(RubyPrefetcher, "Prefetch for %#x already queued\n",
+                    line_addr);
+            numDroppedPrefetches++;
+            return;
+        }
+    }
+
+    if (m_pf_queue.size() >= m_pf_queue_size) {
+        // the oldest request is the least likely to be timely
+        DPRINTF(RubyPrefetcher, "Prefetch queue full, dropping %#x\n",
+                m_pf_queue.front().first);
+        numDroppedPrefetches++;
+        m_pf_queue.pop_front();
+    }
+
+    m_pf_queue.emplace_back(line_addr, type);
+    issueQueuedPrefetches();
+}
+
+void
+Prefetcher::issueQueuedPrefetches()
+{
+    Cycles cur_cycle = m_controller->curCycle();
+    if (cur_cycle != m_issue_cycle) {
+        m_issue_cycle = cur_cycle;
+        m_issued_this_cycle = 0;
+    }
+
+    while (!m_pf_queue.empty()) {
+        if (m_issue_width != 0 && m_issued_this_cycle >= m_issue_width) {
+            break;
+        }
+        if (m_throttle_buffer != nullptr &&
+            m_throttle_buffer->getSize(curTick()) >= m_throttle_occupancy) {
+            DPRINTF(RubyPrefetcher, "Throttling %d queued prefetches\n",
+                    m_pf_queue.size());
+            numThrottledPrefetches++;
+            break;
+        }
+
+        const auto &pf = m_pf_queue.front();
+        DPRINTF(RubyPrefetcher, "Requesting prefetch for %#x\n", pf.first);
+        m_controller->enqueuePrefetch(pf.first, pf.second);
+        numPrefetchAccepted++;
+        m_issued_this_cycle++;
+        m_pf_queue.pop_front();
+    }
+
+    if (!m_pf_queue.empty() && !m_issue_event.scheduled()) {
+        schedule(m_issue_event, m_controller->clockEdge(Cycles(1)));
+    }
+}
+
 void
 Prefetcher::issueNextPrefetch(Addr address, PrefetchEntry *stream)
 {
@@ -253,8 +368,7 @@ Prefetcher::issueNextPrefetch(Addr address, PrefetchEntry *stream)
     // launch next prefetch
     stream->m_address = line_addr;
     stream->m_use_time = m_controller->curCycle();
-    DPRINTF(RubyPrefetcher, "Requesting prefetch for %#x\n", line_addr);
-    m_controller->enqueuePrefetch(line_addr, stream->m_type);
+    issuePrefetch(line_addr, stream->m_type);
 }
 
 uint32_t
@@ -316,9 +430,7 @@ Prefetcher::initializeStream(Addr address, int stride,
         }
 
         // launch prefetch
-        numPrefetchRequested++;
-        DPRINTF(RubyPrefetcher, "Requesting prefetch for %#x\n", line_addr);
-        m_controller->enqueuePrefetch(line_addr, m_array[index].m_type);
+        issuePrefetch(line_addr, m_array[index].m_type);
     }
 
     // update the address to be the last address prefetched
@@ -32,9 +32,12 @@
 // Implements Power 4 like prefetching
 
 #include <bitset>
+#include <deque>
+#include <utility>
 
 #include "base/statistics.hh"
 #include "mem/ruby/common/Address.hh"
+#include "mem/ruby/common/DataBlock.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
 #include "mem/ruby/slicc_interface/AbstractController.hh"
 #include "mem/ruby/slicc_interface/RubyRequest.hh"
@@ -83,7 +86,7 @@ class Prefetcher : public SimObject
     public:
         typedef PrefetcherParams Params;
         Prefetcher(const Params *p);
-        ~Prefetcher();
+        virtual ~Prefetcher();
 
         void issueNextPrefetch(Addr address, PrefetchEntry *stream);
         /**
@@ -92,15 +95,44 @@ class Prefetcher : public SimObject
          * on a line with the line's prefetch bit set. If this address
          * hits in m_array we will continue prefetching the stream.
          */
-        void observePfHit(Addr address);
-        void observePfMiss(Addr address);
+        virtual void observePfHit(Addr address);
+        virtual void observePfMiss(Addr address);
 
         /**
          * Observe a memory miss from the cache.
          *
          * @param address   The physical address that missed out of the cache.
          */
-        void observeMiss(Addr address, const RubyRequestType& type);
+        virtual void observeMiss(Addr address, const RubyRequestType& type);
+
+        /**
+         * Observe the eviction of a prefetched line that was never
+         * accessed.
+         *
+         * @param address   The line address of the evicted block.
+         */
+        void observePfEvict(Addr address);
+
+        /**
+         * Observe a demand load that hit in the cache, along with the
+         * data of its line. Ignored by the stream prefetcher, used by
+         * the prefetchers that look at the loaded values.
+         *
+         * @param address   The physical address of the load.
+         * @param pc        The PC of the load.
+         * @param size      The size in bytes of the load.
+         * @param data      The data of the line that was hit.
+         */
+        virtual void observeLoadHit(Addr address, Addr pc, int size,
+                                    const DataBlock& data) {}
+
+        /**
+         * Observe a demand load that missed in the cache.
+         *
+         * @param address   The physical address of the load.
+         * @param pc        The PC of the load.
+         */
+        virtual void observeLoadMiss(Addr address, Addr pc) {}
 
         /**
          * Print out some statistics
@@ -111,6 +143,29 @@ class Prefetcher : public SimObject
 
         void regStats();
 
+        /**
+         * Queued prefetches are held while the system is drained and
+         * handed to the controller again once it resumes.
+         */
+        DrainState drain() override;
+        void drainResume() override;
+
+    protected:
+        /**
+         * Request a prefetch. Requests wait in a small queue and are
+         * handed to the controller at most issue_width per cycle, and
+         * only while the throttle buffer is not busy.
+         *
+         * @param line_addr The line address to prefetch.
+         * @param type      The type of request to issue.
+         */
+        void issuePrefetch(Addr line_addr, const RubyRequestType& type);
+
+        /// determine the page aligned address
+        Addr pageAddress(Addr addr) const;
+
+        AbstractController *m_controller;
+
     private:
         /**
          * Returns an unused stream buffer (or if all are used, returns the
@@ -140,8 +195,8 @@ class Prefetcher : public SimObject
         bool accessNonunitFilter(Addr address, int *stride,
             bool &alloc);
 
-        /// determine the page aligned address
-        Addr pageAddress(Addr addr) const;
+        /// send the queued prefetches the controller can take this cycle
+        void issueQueuedPrefetches();
 
         //! number of prefetch streams available
         uint32_t m_num_streams;
@@ -186,13 +241,28 @@ class Prefetcher : public SimObject
         /// a round robin pointer into the unit filter group
         uint32_t m_nonunit_index;
 
+    protected:
         /// Used for allowing prefetches across pages.
         bool m_prefetch_cross_pages;
 
-        AbstractController *m_controller;
-
         const Addr m_page_shift;
 
+        /// Prefetches waiting to be handed to the controller
+        std::deque<std::pair<Addr, RubyRequestType>> m_pf_queue;
+        /// Maximum number of prefetches waiting in the queue
+        const uint32_t m_pf_queue_size;
+        /// Prefetches handed to the controller per cycle, 0 for no limit
+        const uint32_t m_issue_width;
+        /// Prefetches are held back while this buffer is busy
+        MessageBuffer *m_throttle_buffer;
+        /// Number of messages that makes the throttle buffer busy
+        const uint32_t m_throttle_occupancy;
+        /// Cycle of the last issue, and prefetches issued in that cycle
+        Cycles m_issue_cycle;
+        uint32_t m_issued_this_cycle;
+        /// Retries the queued prefetches in the next cycle
+        EventFunctionWrapper m_issue_event;
+
         //! Count of accesses to the prefetcher
         Stats::Scalar numMissObserved;
         //! Count of prefetch streams allocated
@@ -211,6 +281,14 @@ class Prefetcher : public SimObject
         Stats::Scalar numPagesCrossed;
         //! Count of misses incurred for blocks that were prefetched
         Stats::Scalar numMissedPrefetchedBlocks;
+        //! Count of prefetched blocks evicted before being accessed
+        Stats::Scalar numUnusedPrefetches;
+        //! Count of times the throttle held back the prefetch queue
+        Stats::Scalar numThrottledPrefetches;
+        //! Fraction of the accepted prefetches that were used
+        Stats::Formula accuracy;
+        //! Fraction of the misses that were avoided by prefetches
+        Stats::Formula coverage;
 };
 
 #endif // __MEM_RUBY_STRUCTURES_PREFETCHER_HH__
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/structures/RubyDeltaPrefetcher.hh"
+
+#include "debug/RubyPrefetcher.hh"
+
+RubyDeltaPrefetcher*
+RubyDeltaPrefetcherParams::create()
+{
+    return new RubyDeltaPrefetcher(this);
+}
+
+RubyDeltaPrefetcher::RubyDeltaPrefetcher(const Params *p)
+    : Prefetcher(p), pcIndexed(p->pc_indexed), dcpt(*p->dcpt)
+{
+}
+
+void
+RubyDeltaPrefetcher::observeMiss(Addr address, const RubyRequestType& type)
+{
+    DPRINTF(RubyPrefetcher, "Observed miss for %#x\n", address);
+    numMissObserved++;
+    if (!pcIndexed) {
+        train(address >> m_page_shift, makeLineAddress(address), type);
+    }
+}
+
+void
+RubyDeltaPrefetcher::observePfHit(Addr address)
+{
+    Prefetcher::observePfHit(address);
+    // A hit on a prefetched line is a miss that was avoided
+    if (!pcIndexed) {
+        train(address >> m_page_shift, makeLineAddress(address),
+              RubyRequestType_LD);
+    }
+}
+
+void
+RubyDeltaPrefetcher::observePfMiss(Addr address)
+{
+    Prefetcher::observePfMiss(address);
+    if (!pcIndexed) {
+        train(address >> m_page_shift, makeLineAddress(address),
+              RubyRequestType_LD);
+    }
+}
+
+void
+RubyDeltaPrefetcher::observeLoadHit(Addr address, Addr pc, int size,
+                                    const DataBlock& data)
+{
+    if (pcIndexed && pc != 0) {
+        train(pc, address, RubyRequestType_LD);
+    }
+}
+
+void
+RubyDeltaPrefetcher::observeLoadMiss(Addr address, Addr pc)
+{
+    if (pcIndexed && pc != 0) {
+        train(pc, address, RubyRequestType_LD);
+    }
+}
+
+void
+RubyDeltaPrefetcher::train(Addr key, Addr address,
+                           const RubyRequestType& type)
+{
+    candidates.clear();
+    dcpt.calculatePrefetch(key, address, candidates);
+
+    Addr last_line_addr = makeLineAddress(address);
+    for (const auto &candidate : candidates) {
+        Addr pf_addr = makeLineAddress(candidate.first);
+        if (pf_addr == last_line_addr) {
+            continue;
+        }
+        last_line_addr = pf_addr;
+
+        if (pageAddress(pf_addr) != pageAddress(address)) {
+            numPagesCrossed++;
+            if (!m_prefetch_cross_pages) {
+                continue;
+            }
+        }
+
+        DPRINTF(RubyPrefetcher, "Delta candidate %#x from %#x\n", pf_addr,
+                address);
+        issuePrefetch(pf_addr, type);
+    }
+}
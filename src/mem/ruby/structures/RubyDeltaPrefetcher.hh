@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_STRUCTURES_RUBYDELTAPREFETCHER_HH__
+#define __MEM_RUBY_STRUCTURES_RUBYDELTAPREFETCHER_HH__
+
+// Delta-correlating prefetching for the Ruby caches
+
+#include <vector>
+
+#include "mem/cache/prefetch/delta_correlating_prediction_tables.hh"
+#include "mem/ruby/structures/Prefetcher.hh"
+#include "params/RubyDeltaPrefetcher.hh"
+
+/**
+ * Ruby front-end of the DeltaCorrelatingPredictionTables. The delta
+ * history is kept per PC in the caches that see the PC of the loads
+ * (the L1s), and per page of the miss stream elsewhere (e.g., the L2).
+ */
+class RubyDeltaPrefetcher : public Prefetcher
+{
+    public:
+        typedef RubyDeltaPrefetcherParams Params;
+        RubyDeltaPrefetcher(const Params *p);
+
+        void observeMiss(Addr address, const RubyRequestType& type) override;
+        void observePfHit(Addr address) override;
+        void observePfMiss(Addr address) override;
+        void observeLoadHit(Addr address, Addr pc, int size,
+                            const DataBlock& data) override;
+        void observeLoadMiss(Addr address, Addr pc) override;
+
+    private:
+        /**
+         * Train the DCPT with an access and request its candidates
+         * @param key PC or page number identifying the delta stream
+         * @param address address of the access
+         * @param type type of the prefetches
+         */
+        void train(Addr key, Addr address, const RubyRequestType& type);
+
+        /** Whether the deltas are tracked by PC or by page */
+        const bool pcIndexed;
+
+        /** DCPT object */
+        DeltaCorrelatingPredictionTables &dcpt;
+
+        /** Scratch space for the candidates of the DCPT */
+        std::vector<QueuedPrefetcher::AddrPriority> candidates;
+};
+
+#endif // __MEM_RUBY_STRUCTURES_RUBYDELTAPREFETCHER_HH__
@@ -30,6 +30,10 @@ from m5.SimObject import SimObject
 from m5.params import *
 from m5.proxy import *
 
+from m5.objects.IndexingPolicies import *
+from m5.objects.Prefetcher import DeltaCorrelatingPredictionTables
+from m5.objects.Prefetcher import IndirectMemoryPredictor
+from m5.objects.ReplacementPolicies import *
 from m5.objects.System import System
 
 class Prefetcher(SimObject):
@@ -49,3 +53,59 @@ class Prefetcher(SimObject):
     cross_page = Param.Bool(False, """True if prefetched address can be on a
             page different from the observed address""")
     sys = Param.System(Parent.any, "System this prefetcher belongs to")
+    queue_size = Param.UInt32(16,
+        "Number of prefetches waiting to be sent to the controller")
+    issue_width = Param.UInt32(0,
+        "Number of prefetches sent to the controller per cycle (0 for "
+        "no limit)")
+    throttle_buffer = Param.MessageBuffer(NULL,
+        "Prefetches are held back while this buffer is busy")
+    throttle_occupancy = Param.UInt32(4,
+        "Number of messages that makes the throttle buffer busy")
+
+class RubyIndirectPrefetcher(Prefetcher):
+    type = 'RubyIndirectPrefetcher'
+    cxx_class = 'IndirectPrefetcher'
+    cxx_header = "mem/ruby/structures/IndirectPrefetcher.hh"
+
+    imp = Param.IndirectMemoryPredictor(IndirectMemoryPredictor(),
+        "Indirect Memory Prefetcher object")
+
+class RubyStridePrefetcher(Prefetcher):
+    type = 'RubyStridePrefetcher'
+    cxx_class = 'RubyStridePrefetcher'
+    cxx_header = "mem/ruby/structures/RubyStridePrefetcher.hh"
+
+    pc_indexed = Param.Bool(True, "Track the strides of the load PCs "
+        "(False to track the miss stream of each page)")
+
+    max_conf = Param.Int(7, "Maximum confidence level")
+    thresh_conf = Param.Int(4, "Threshold confidence level")
+    min_conf = Param.Int(0, "Minimum confidence level")
+    start_conf = Param.Int(4, "Starting confidence for new entries")
+
+    degree = Param.Unsigned(2, "Number of lines prefetched per access")
+    distance = Param.Unsigned(1,
+        "Number of strides between an access and its first prefetch")
+
+    table_entries = Param.MemorySize("64", "Number of entries of the table")
+    table_assoc = Param.Unsigned(4, "Associativity of the table")
+    table_indexing_policy = Param.BaseIndexingPolicy(
+        SetAssociative(entry_size = 1, assoc = Parent.table_assoc,
+        size = Parent.table_entries),
+        "Indexing policy of the table")
+    table_replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy of the table")
+
+class RubyDeltaPrefetcher(Prefetcher):
+    type = 'RubyDeltaPrefetcher'
+    cxx_class = 'RubyDeltaPrefetcher'
+    cxx_header = "mem/ruby/structures/RubyDeltaPrefetcher.hh"
+
+    pc_indexed = Param.Bool(True, "Track the deltas of the load PCs "
+        "(False to track the miss stream of each page)")
+
+    dcpt = Param.DeltaCorrelatingPredictionTables(
+        DeltaCorrelatingPredictionTables(delta_bits = 16,
+        delta_mask_bits = 6),
+        "Delta Correlating Prediction Tables object")
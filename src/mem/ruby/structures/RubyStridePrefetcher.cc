@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/ruby/structures/RubyStridePrefetcher.hh"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "debug/RubyPrefetcher.hh"
+#include "mem/cache/prefetch/associative_set_impl.hh"
+#include "mem/ruby/system/RubySystem.hh"
+
+RubyStridePrefetcher*
+RubyStridePrefetcherParams::create()
+{
+    return new RubyStridePrefetcher(this);
+}
+
+void
+RubyStridePrefetcher::StrideEntry::reset()
+{
+    lastAddr = 0;
+    stride = 0;
+    confidence = 0;
+    lastPrefetch = 0;
+    type = RubyRequestType_LD;
+}
+
+RubyStridePrefetcher::RubyStridePrefetcher(const Params *p)
+    : Prefetcher(p), pcIndexed(p->pc_indexed), maxConf(p->max_conf),
+      threshConf(p->thresh_conf), minConf(p->min_conf),
+      startConf(p->start_conf), degree(p->degree), distance(p->distance),
+      table(p->table_assoc, p->table_entries, p->table_indexing_policy,
+            p->table_replacement_policy)
+{
+    fatal_if(degree == 0, "%s: degree must be positive", name());
+}
+
+void
+RubyStridePrefetcher::observeMiss(Addr address, const RubyRequestType& type)
+{
+    DPRINTF(RubyPrefetcher, "Observed miss for %#x\n", address);
+    numMissObserved++;
+    if (!pcIndexed) {
+        train(address >> m_page_shift, address, type);
+    }
+}
+
+void
+RubyStridePrefetcher::observePfHit(Addr address)
+{
+    Prefetcher::observePfHit(address);
+    // A hit on a prefetched line is a miss that was avoided
+    if (!pcIndexed) {
+        train(address >> m_page_shift, address, RubyRequestType_LD);
+    }
+}
+
+void
+RubyStridePrefetcher::observePfMiss(Addr address)
+{
+    Prefetcher::observePfMiss(address);
+    if (!pcIndexed) {
+        train(address >> m_page_shift, address, RubyRequestType_LD);
+    }
+}
+
+void
+RubyStridePrefetcher::observeLoadHit(Addr address, Addr pc, int size,
+                                     const DataBlock& data)
+{
+    if (pcIndexed && pc != 0) {
+        train(pc, address, RubyRequestType_LD);
+    }
+}
+
+void
+RubyStridePrefetcher::observeLoadMiss(Addr address, Addr pc)
+{
+    if (pcIndexed && pc != 0) {
+        train(pc, address, RubyRequestType_LD);
+    }
+}
+
+void
+RubyStridePrefetcher::train(Addr key, Addr address,
+                            const RubyRequestType& type)
+{
+    StrideEntry *entry = table.findEntry(key, false);
+    if (entry == nullptr) {
+        entry = table.findVictim(key);
+        table.insertEntry(key, false, entry);
+        entry->lastAddr = address;
+        entry->confidence = startConf;
+        entry->type = type;
+        return;
+    }
+    table.accessEntry(entry);
+
+    const int64_t stride = address - entry->lastAddr;
+    if (stride == 0) {
+        return;
+    }
+    entry->lastAddr = address;
+
+    if (stride == entry->stride) {
+        entry->confidence = std::min(entry->confidence + 1, maxConf);
+    } else {
+        entry->confidence = std::max(entry->confidence - 1, minConf);
+        if (entry->confidence < threshConf) {
+            entry->stride = stride;
+            entry->lastPrefetch = 0;
+        }
+    }
+
+    if (entry->confidence < threshConf) {
+        return;
+    }
+
+    // Strides shorter than a line prefetch the following lines
+    const int64_t block_size = RubySystem::getBlockSizeBytes();
+    int64_t step = entry->stride;
+    if (std::abs(step) < block_size) {
+        step = step > 0 ? block_size : -block_size;
+    }
+    auto ahead = [step](Addr a, Addr b) { return step > 0 ? a > b : a < b; };
+
+    // The lines up to the last prefetch of the stream were requested
+    // by a previous access, unless the stream jumped away from them
+    const Addr line_addr = makeLineAddress(address);
+    const Addr last_pf = entry->lastPrefetch;
+    const Addr furthest =
+        makeLineAddress(address + step * (distance + degree - 1));
+    const bool in_window = ahead(last_pf, line_addr) &&
+                           !ahead(last_pf, furthest);
+
+    for (unsigned d = distance; d < distance + degree; d++) {
+        Addr pf_addr = makeLineAddress(address + step * d);
+        if (pf_addr == line_addr || (in_window && !ahead(pf_addr, last_pf))) {
+            continue;
+        }
+
+        if (pageAddress(pf_addr) != pageAddress(address)) {
+            numPagesCrossed++;
+            if (!m_prefetch_cross_pages) {
+                break;
+            }
+        }
+
+        DPRINTF(RubyPrefetcher, "Stride %d from %#x, prefetching %#x\n",
+                entry->stride, address, pf_addr);
+        entry->lastPrefetch = pf_addr;
+        issuePrefetch(pf_addr, entry->type);
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_RUBY_STRUCTURES_RUBYSTRIDEPREFETCHER_HH__
+#define __MEM_RUBY_STRUCTURES_RUBYSTRIDEPREFETCHER_HH__
+
+// Stride prefetching for the Ruby caches
+
+#include "mem/cache/prefetch/associative_set.hh"
+#include "mem/ruby/structures/Prefetcher.hh"
+#include "params/RubyStridePrefetcher.hh"
+
+/**
+ * Detects constant strides and prefetches degree lines, starting
+ * distance strides ahead of the access. In the caches that see the PC
+ * of the loads (the L1s) the table is indexed by PC; elsewhere (e.g.,
+ * the L2) it is trained with the miss stream of each page.
+ */
+class RubyStridePrefetcher : public Prefetcher
+{
+    public:
+        typedef RubyStridePrefetcherParams Params;
+        RubyStridePrefetcher(const Params *p);
+
+        void observeMiss(Addr address, const RubyRequestType& type) override;
+        void observePfHit(Addr address) override;
+        void observePfMiss(Addr address) override;
+        void observeLoadHit(Addr address, Addr pc, int size,
+                            const DataBlock& data) override;
+        void observeLoadMiss(Addr address, Addr pc) override;
+
+    private:
+        /** Stride table entry */
+        struct StrideEntry : public TaggedEntry
+        {
+            /** Last address accessed by the stream */
+            Addr lastAddr;
+            /** Last stride seen, in bytes */
+            int64_t stride;
+            /** Confidence in the stride */
+            int confidence;
+            /** Last line prefetched for the stream */
+            Addr lastPrefetch;
+            /** Type of the prefetches of the stream */
+            RubyRequestType type;
+
+            StrideEntry() { reset(); }
+            void reset() override;
+        };
+
+        /**
+         * Train the entry of a stream with an access, and request the
+         * prefetches once its stride is confirmed.
+         * @param key PC or page number identifying the stream
+         * @param address address of the access
+         * @param type type of the access
+         */
+        void train(Addr key, Addr address, const RubyRequestType& type);
+
+        /** Whether the table is indexed by PC or by page */
+        const bool pcIndexed;
+
+        /** Confidence counter parameters */
+        const int maxConf;
+        const int threshConf;
+        const int minConf;
+        const int startConf;
+
+        /** Number of lines prefetched per access */
+        const unsigned degree;
+        /** Number of strides between the access and its first prefetch */
+        const unsigned distance;
+
+        /** Table of the strided streams */
+        AssociativeSet<StrideEntry> table;
+};
+
+#endif // __MEM_RUBY_STRUCTURES_RUBYSTRIDEPREFETCHER_HH__
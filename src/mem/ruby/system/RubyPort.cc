@@ -41,6 +41,9 @@
 
 #include "mem/ruby/system/RubyPort.hh"
 
+#include <cstring>
+#include <vector>
+
 #include "cpu/testers/rubytest/RubyTester.hh"
 #include "debug/Config.hh"
 #include "debug/Drain.hh"
@@ -85,6 +88,12 @@ RubyPort::init()
 {
     assert(m_controller != NULL);
     m_mandatory_q_ptr = m_controller->getMandatoryQueue();
+
+    // With the backing store enabled, functional accesses are served
+    // straight from it (see recvFunctional), so let the system bypass
+    // the ports for them altogether.
+    if (m_ruby_system->getAccessBackingStore())
+        system->setFunctionalBackdoor(m_ruby_system->getPhysMem());
 }
 
 BaseMasterPort &
@@ -320,9 +329,13 @@ Tick
 RubyPort::MemSlavePort::recvAtomic(PacketPtr pkt)
 {
     RubyPort *ruby_port = static_cast<RubyPort *>(&owner);
-    // Only atomic_noncaching mode supported!
-    if (!ruby_port->system->bypassCaches()) {
-        panic("Ruby supports atomic accesses only in noncaching mode\n");
+    RubySystem *rs = ruby_port->m_ruby_system;
+    // Only atomic_noncaching mode supported, unless the caches are being
+    // warmed functionally!
+    bool warming = !ruby_port->system->bypassCaches();
+    if (warming && !rs->getFunctionalWarming()) {
+        panic("Ruby supports atomic accesses only in noncaching mode "
+              "or with functional_warming enabled\n");
     }
 
     // Check for pio requests and directly send them to the dedicated
@@ -346,18 +359,97 @@ RubyPort::MemSlavePort::recvAtomic(PacketPtr pkt)
                RubySystem::getBlockSizeBytes());
     }
 
+    if (warming)
+        return warmingAccess(pkt);
+
     // Find appropriate directory for address
     // This assumes that protocols have a Directory machine,
     // which has its memPort hooked up to memory. This can
     // fail for some custom protocols.
     MachineID id = ruby_port->m_controller->mapAddressToMachine(
                     pkt->getAddr(), MachineType_Directory);
-    RubySystem *rs = ruby_port->m_ruby_system;
     AbstractController *directory =
         rs->m_abstract_controls[id.getType()][id.getNum()];
     return directory->recvAtomic(pkt);
 }
 
+/**
+ * Perform an atomic CPU access while Ruby is being warmed functionally.
+ * The data side goes through the functional path, so whatever copy the
+ * protocol currently holds is the one read and updated; the access is
+ * then handed to issueWarmingRequest() so the sequencer can bring the
+ * line into the caches in the background. Data is never taken from the
+ * warming requests themselves.
+ */
+Tick
+RubyPort::MemSlavePort::warmingAccess(PacketPtr pkt)
+{
+    RubyPort *ruby_port = static_cast<RubyPort *>(&owner);
+    RubySystem *rs = ruby_port->m_ruby_system;
+
+    if (pkt->cmd == MemCmd::MemFenceReq) {
+        if (pkt->needsResponse())
+            pkt->makeResponse();
+        return 0;
+    }
+
+    Addr line = makeLineAddress(pkt->getAddr());
+    ContextID ctx = pkt->req->hasContextId() ?
+        pkt->req->contextId() : InvalidContextID;
+    unsigned size = pkt->getSize();
+
+    DPRINTF(RubyPort, "Warming %s for address %#x\n", pkt->cmdString(),
+            pkt->getAddr());
+
+    std::vector<uint8_t> old_val(size);
+    if (pkt->isRead()) {
+        Packet rd_pkt(pkt->req, MemCmd::ReadReq);
+        rd_pkt.dataStatic(old_val.data());
+        recvFunctional(&rd_pkt);
+    }
+
+    bool do_write = pkt->isWrite();
+    std::vector<uint8_t> new_val(size);
+    if (pkt->cmd == MemCmd::SwapReq) {
+        if (pkt->isAtomicOp()) {
+            new_val = old_val;
+            (*(pkt->getAtomicOp()))(new_val.data());
+        } else {
+            pkt->writeData(new_val.data());
+            if (pkt->req->isCondSwap()) {
+                uint64_t cond = pkt->req->getExtraData();
+                panic_if(size > sizeof(cond),
+                         "Invalid size for conditional read/write\n");
+                do_write = !std::memcmp(&cond, old_val.data(), size);
+            }
+        }
+    } else if (pkt->isWrite()) {
+        pkt->writeData(new_val.data());
+        if (pkt->isLLSC()) {
+            do_write = rs->warmingStoreConditional(ctx, line);
+            pkt->req->setExtraData(do_write ? 1 : 0);
+        }
+    } else if (pkt->isLLSC()) {
+        rs->warmingLoadLinked(ctx, line);
+    }
+
+    if (do_write) {
+        Packet wr_pkt(pkt->req, MemCmd::WriteReq);
+        wr_pkt.dataStatic(new_val.data());
+        recvFunctional(&wr_pkt);
+        rs->warmingClearLocks(line);
+    }
+
+    ruby_port->issueWarmingRequest(pkt);
+
+    if (pkt->needsResponse()) {
+        if (pkt->isRead())
+            pkt->setData(old_val.data());
+        pkt->makeResponse();
+    }
+    return 0;
+}
+
 void
 RubyPort::MemSlavePort::addToRetryList()
 {
@@ -100,6 +100,7 @@ class RubyPort : public MemObject
 
       private:
         bool isPhysMemAddress(Addr addr) const;
+        Tick warmingAccess(PacketPtr pkt);
     };
 
     class PioMasterPort : public QueuedMasterPort
@@ -158,6 +159,15 @@ class RubyPort : public MemObject
     virtual bool isDeadlockEventScheduled() const = 0;
     virtual void descheduleDeadlockEvent() = 0;
 
+    /**
+     * Hook for functional warming. Called with every atomic CPU request
+     * that has already been performed functionally, before it is turned
+     * into a response; ports that front a cache may replay it in the
+     * background to warm the protocol state. The packet remains owned
+     * by the caller.
+     */
+    virtual void issueWarmingRequest(PacketPtr pkt) {}
+
     //
     // Called by the controller to give the sequencer a pointer.
     // A pointer to the controller is needed for atomic support.
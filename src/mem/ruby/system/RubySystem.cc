@@ -58,6 +58,7 @@ bool RubySystem::m_cooldown_enabled = false;
 
 RubySystem::RubySystem(const Params *p)
     : ClockedObject(p), m_access_backing_store(p->access_backing_store),
+      m_functional_warming(p->functional_warming),
       m_cache_recorder(NULL)
 {
     m_randomization = p->randomization;
@@ -412,25 +413,38 @@ RubySystem::functionalRead(PacketPtr pkt)
     unsigned int num_backing_store = 0;
     unsigned int num_invalid = 0;
 
+    // The first controllers found holding a readable copy and holding
+    // the block in backing store. Remembering them here means each
+    // controller is only polled once per functional read.
+    AbstractController *readable_cntrl = nullptr;
+    AbstractController *backing_store_cntrl = nullptr;
+
     // In this loop we count the number of controllers that have the given
     // address in read only, read write and busy states.
     for (unsigned int i = 0; i < num_controllers; ++i) {
         access_perm = m_abs_cntrl_vec[i]-> getAccessPermission(line_address);
-        if (access_perm == AccessPermission_Read_Only)
-            num_ro++;
-        else if (access_perm == AccessPermission_Read_Write)
-            num_rw++;
-        else if (access_perm == AccessPermission_Busy)
+        if (access_perm == AccessPermission_Read_Only ||
+            access_perm == AccessPermission_Read_Write) {
+            if (access_perm == AccessPermission_Read_Only)
+                num_ro++;
+            else
+                num_rw++;
+            if (!readable_cntrl)
+                readable_cntrl = m_abs_cntrl_vec[i];
+        } else if (access_perm == AccessPermission_Busy) {
             num_busy++;
-        else if (access_perm == AccessPermission_Backing_Store)
+        } else if (access_perm == AccessPermission_Backing_Store) {
             // See RubySlicc_Exports.sm for details, but Backing_Store is meant
             // to represent blocks in memory *for Broadcast/Snooping protocols*,
             // where memory has no idea whether it has an exclusive copy of data
             // or not.
             num_backing_store++;
-        else if (access_perm == AccessPermission_Invalid ||
-                 access_perm == AccessPermission_NotPresent)
+            if (!backing_store_cntrl)
+                backing_store_cntrl = m_abs_cntrl_vec[i];
+        } else if (access_perm == AccessPermission_Invalid ||
+                   access_perm == AccessPermission_NotPresent) {
             num_invalid++;
+        }
     }
     assert(num_rw <= 1);
 
@@ -444,13 +458,8 @@ RubySystem::functionalRead(PacketPtr pkt)
     // it only if it's not in the cache hierarchy at all.
     if (num_invalid == (num_controllers - 1) && num_backing_store == 1) {
         DPRINTF(RubySystem, "only copy in Backing_Store memory, read from it\n");
-        for (unsigned int i = 0; i < num_controllers; ++i) {
-            access_perm = m_abs_cntrl_vec[i]->getAccessPermission(line_address);
-            if (access_perm == AccessPermission_Backing_Store) {
-                m_abs_cntrl_vec[i]->functionalRead(line_address, pkt);
-                return true;
-            }
-        }
+        backing_store_cntrl->functionalRead(line_address, pkt);
+        return true;
     } else if (num_ro > 0 || num_rw == 1) {
         // In Broadcast/Snoop protocols, this covers if you know the block
         // exists somewhere in the caching hierarchy, then you want to read any
@@ -458,17 +467,10 @@ RubySystem::functionalRead(PacketPtr pkt)
         // to read any valid readable copy of the block.
         DPRINTF(RubySystem, "num_busy = %d, num_ro = %d, num_rw = %d\n",
                 num_busy, num_ro, num_rw);
-        // In this loop, we try to figure which controller has a read only or
-        // a read write copy of the given address. Any valid copy would suffice
-        // for a functional read.
-        for (unsigned int i = 0;i < num_controllers;++i) {
-            access_perm = m_abs_cntrl_vec[i]->getAccessPermission(line_address);
-            if (access_perm == AccessPermission_Read_Only ||
-                access_perm == AccessPermission_Read_Write) {
-                m_abs_cntrl_vec[i]->functionalRead(line_address, pkt);
-                return true;
-            }
-        }
+        // Any valid copy would suffice for a functional read, so use the
+        // first one found above.
+        readable_cntrl->functionalRead(line_address, pkt);
+        return true;
     } else {
         // None of the controller has read access of the data. This may
         // be because of all controllers are in transient states so that
@@ -534,6 +536,37 @@ RubySystem::functionalWrite(PacketPtr pkt)
     return true;
 }
 
+void
+RubySystem::warmingLoadLinked(ContextID ctx, Addr line)
+{
+    DPRINTF(RubySystem, "Warming LL by context %d on %#x\n", ctx, line);
+    m_warming_locks[ctx] = line;
+}
+
+bool
+RubySystem::warmingStoreConditional(ContextID ctx, Addr line)
+{
+    auto it = m_warming_locks.find(ctx);
+    bool success = it != m_warming_locks.end() && it->second == line;
+    if (it != m_warming_locks.end())
+        m_warming_locks.erase(it);
+
+    DPRINTF(RubySystem, "Warming SC by context %d on %#x %s\n", ctx, line,
+            success ? "succeeded" : "failed");
+    return success;
+}
+
+void
+RubySystem::warmingClearLocks(Addr line)
+{
+    for (auto it = m_warming_locks.begin(); it != m_warming_locks.end(); ) {
+        if (it->second == line)
+            it = m_warming_locks.erase(it);
+        else
+            ++it;
+    }
+}
+
 #ifdef CHECK_COHERENCE
 // This code will check for cases if the given cache block is exclusive in
 // one node and shared in another-- a coherence violation
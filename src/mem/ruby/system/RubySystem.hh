@@ -35,6 +35,8 @@
 #ifndef __MEM_RUBY_SYSTEM_RUBYSYSTEM_HH__
 #define __MEM_RUBY_SYSTEM_RUBYSYSTEM_HH__
 
+#include <unordered_map>
+
 #include "base/callback.hh"
 #include "base/output.hh"
 #include "mem/packet.hh"
@@ -65,6 +67,7 @@ class RubySystem : public ClockedObject
     SimpleMemory *getPhysMem() { return m_phys_mem; }
     Cycles getStartCycle() { return m_start_cycle; }
     bool getAccessBackingStore() { return m_access_backing_store; }
+    bool getFunctionalWarming() const { return m_functional_warming; }
 
     // Public Methods
     Profiler*
@@ -90,6 +93,16 @@ class RubySystem : public ClockedObject
     bool functionalRead(Packet *ptr);
     bool functionalWrite(Packet *ptr);
 
+    /**
+     * LL/SC reservations for atomic CPUs running in functional warming
+     * mode. The protocols track reservations in their L1 controllers,
+     * which only see timing requests, so while warming we keep one
+     * reservation per context here instead.
+     */
+    void warmingLoadLinked(ContextID ctx, Addr line);
+    bool warmingStoreConditional(ContextID ctx, Addr line);
+    void warmingClearLocks(Addr line);
+
     void registerNetwork(Network*);
     void registerAbstractController(AbstractController*);
 
@@ -129,6 +142,8 @@ class RubySystem : public ClockedObject
     static bool m_cooldown_enabled;
     SimpleMemory *m_phys_mem;
     const bool m_access_backing_store;
+    const bool m_functional_warming;
+    std::unordered_map<ContextID, Addr> m_warming_locks;
 
     Network* m_network;
     std::vector<AbstractController *> m_abs_cntrl_vec;
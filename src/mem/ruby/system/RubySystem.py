@@ -48,6 +48,10 @@ class RubySystem(ClockedObject):
     access_backing_store = Param.Bool(False, "Use phys_mem as the functional \
         store and only use ruby for timing.")
 
+    functional_warming = Param.Bool(False, "Accept atomic accesses from \
+        the CPUs while caching is enabled: they are performed functionally \
+        and replayed through the sequencers to warm the cache hierarchy.")
+
     # Profiler related configuration variables
     hot_lines = Param.Bool(False, "")
     all_instructions = Param.Bool(False, "")
@@ -74,6 +74,9 @@ Sequencer::Sequencer(const Params *p)
     assert(m_inst_cache_hit_latency > 0);
 
     m_runningGarnetStandalone = p->garnet_standalone;
+
+    m_warming_master_id = system->getMasterId(this, "warming");
+    m_warming_filter.assign(std::max(p->warming_filter_entries, 1U), 0);
 }
 
 Sequencer::~Sequencer()
@@ -137,6 +140,7 @@ void Sequencer::resetStats()
     m_latencyHist.reset();
     m_hitLatencyHist.reset();
     m_missLatencyHist.reset();
+    m_missLatencyLogHist.reset();
     for (int i = 0; i < RubyRequestType_NUM; i++) {
         m_typeLatencyHist[i]->reset();
         m_hitTypeLatencyHist[i]->reset();
@@ -326,6 +330,7 @@ Sequencer::recordMissLatency(const Cycles cycles, const RubyRequestType type,
 
     if (isExternalHit) {
         m_missLatencyHist.sample(cycles);
+        m_missLatencyLogHist.sample(cycles);
         m_missTypeLatencyHist[type]->sample(cycles);
 
         if (respondingMach != MachineType_NUM) {
@@ -461,6 +466,18 @@ Sequencer::hitCallback(SequencerRequest* srequest, DataBlock& data,
     assert(curCycle() >= issued_time);
     Cycles total_latency = curCycle() - issued_time;
 
+    // Functional warming requests only exist to move the line into the
+    // caches: the data was already supplied functionally, so they carry
+    // nothing back and are not profiled.
+    if (pkt->req->masterId() == m_warming_master_id) {
+        DPRINTF(RubySequencer, "warming %s done for %#x\n",
+                pkt->cmdString(), request_address);
+        delete srequest;
+        delete pkt;
+        testDrainComplete();
+        return;
+    }
+
     // Profile the latency for all demand accesses.
     recordMissLatency(total_latency, type, mach, externalHit, issued_time,
                       initialRequestTime, forwardRequestTime,
@@ -548,6 +565,48 @@ Sequencer::hitCallback(SequencerRequest* srequest, DataBlock& data,
     }
 }
 
+void
+Sequencer::issueWarmingRequest(PacketPtr pkt)
+{
+    if (pkt->isFlush() || pkt->req->isUncacheable())
+        return;
+
+    Addr line = makeLineAddress(pkt->getAddr());
+    bool is_write = pkt->isWrite();
+    Addr &filter = m_warming_filter[(line >> RubySystem::getBlockSizeBits()) %
+                                    m_warming_filter.size()];
+    if (filter == (line | is_write) || filter == (line | 1)) {
+        ++m_warming_filtered;
+        return;
+    }
+
+    if (m_outstanding_count >= m_max_outstanding_requests ||
+        m_writeRequestTable.count(line) || m_readRequestTable.count(line)) {
+        ++m_warming_dropped;
+        return;
+    }
+
+    auto req = std::make_shared<Request>(
+        line, RubySystem::getBlockSizeBytes(),
+        pkt->req->isInstFetch() ? Request::INST_FETCH : 0,
+        m_warming_master_id);
+    PacketPtr warm_pkt = new Packet(req, is_write ? MemCmd::WriteReq :
+                                    MemCmd::ReadReq);
+    warm_pkt->allocate();
+
+    RequestStatus status = makeRequest(warm_pkt);
+    if (status != RequestStatus_Issued) {
+        delete warm_pkt;
+        ++m_warming_dropped;
+        return;
+    }
+
+    DPRINTF(RubySequencer, "Issued warming %s for %#x\n",
+            warm_pkt->cmdString(), line);
+    filter = line | is_write;
+    ++m_warming_issued;
+}
+
 bool
 Sequencer::empty() const
 {
@@ -767,6 +826,19 @@ Sequencer::regStats()
         .desc("Number of times a load aliased with a pending store")
         .flags(Stats::nozero);
 
+    m_warming_issued
+        .name(name() + ".warming_issued")
+        .desc("Number of functional warming requests replayed")
+        .flags(Stats::nozero);
+    m_warming_filtered
+        .name(name() + ".warming_filtered")
+        .desc("Number of functional warming requests filtered as recent")
+        .flags(Stats::nozero);
+    m_warming_dropped
+        .name(name() + ".warming_dropped")
+        .desc("Number of functional warming requests dropped when busy")
+        .flags(Stats::nozero);
+
     // These statistical variables are not for display.
     // The profiler will collate these across different
     // sequencers and display those collated statistics.
@@ -774,6 +846,7 @@ Sequencer::regStats()
     m_latencyHist.init(10);
     m_hitLatencyHist.init(10);
     m_missLatencyHist.init(10);
+    m_missLatencyLogHist.init(5, 1 << 24);
 
     for (int i = 0; i < RubyRequestType_NUM; i++) {
         m_typeLatencyHist.push_back(new Stats::Histogram());
@@ -84,6 +84,7 @@ class Sequencer : public RubyPort
                       const Cycles firstResponseTime = Cycles(0));
 
     RequestStatus makeRequest(PacketPtr pkt);
+    void issueWarmingRequest(PacketPtr pkt) override;
     bool empty() const;
     int outstandingCount() const { return m_outstanding_count; }
 
@@ -120,6 +121,8 @@ class Sequencer : public RubyPort
 
     Stats::Histogram& getMissLatencyHist()
     { return m_missLatencyHist; }
+    Stats::LogHistogram& getMissLatencyLogHist()
+    { return m_missLatencyLogHist; }
     Stats::Histogram& getMissTypeLatencyHist(uint32_t t)
     { return *m_missTypeLatencyHist[t]; }
 
@@ -204,6 +207,17 @@ class Sequencer : public RubyPort
 
     bool m_runningGarnetStandalone;
 
+    //! Functional warming: master id of the replayed requests, and a
+    //! direct-mapped filter of recently warmed lines (line address with
+    //! bit 0 set for writes) that keeps hot lines from being replayed
+    //! on every access.
+    MasterID m_warming_master_id;
+    std::vector<Addr> m_warming_filter;
+
+    Stats::Scalar m_warming_issued;
+    Stats::Scalar m_warming_filtered;
+    Stats::Scalar m_warming_dropped;
+
     //! Histogram for number of outstanding requests per cycle.
     Stats::Histogram m_outstandReqHist;
 
@@ -226,6 +240,10 @@ class Sequencer : public RubyPort
     Stats::Histogram m_missLatencyHist;
     std::vector<Stats::Histogram *> m_missTypeLatencyHist;
 
+    //! Log-linear histogram of the miss latencies for their percentiles,
+    //! m_missLatencyHist has too few buckets to resolve the tail.
+    Stats::LogHistogram m_missLatencyLogHist;
+
     //! Histograms for profiling the latencies for requests that
     //! required external messages.
     std::vector<Stats::Histogram *> m_missMachLatencyHist;
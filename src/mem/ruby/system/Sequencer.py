@@ -74,6 +74,8 @@ class RubySequencer(RubyPort):
    deadlock_threshold = Param.Cycles(500000,
        "max outstanding cycles for a request before deadlock/livelock declared")
    garnet_standalone = Param.Bool(False, "")
+   warming_filter_entries = Param.Unsigned(64,
+       "recently warmed lines not replayed again during functional warming")
    # id used by protocols that support multiple sequencers per controller
    # 99 is the dummy default value
    coreid = Param.Int(99, "CorePair core id")
@@ -44,10 +44,13 @@
 
 #include "mem/se_translating_port_proxy.hh"
 
+#include <cstring>
 #include <string>
+#include <vector>
 
 #include "arch/isa_traits.hh"
 #include "base/chunk_generator.hh"
+#include "base/time.hh"
 #include "config/the_isa.hh"
 #include "mem/page_table.hh"
 #include "sim/process.hh"
@@ -55,6 +58,51 @@
 
 using namespace TheISA;
 
+namespace
+{
+
+/**
+ * Charges the host time and the bytes of one functional access to
+ * the syscall statistics of the process, if the access is made while
+ * the process is emulating a system call.
+ */
+class SyscallMemAccount
+{
+  private:
+    Process *process;
+    Time start;
+
+  public:
+    Addr bytes;
+    Addr hostBytes;
+
+    SyscallMemAccount(Process *p)
+        : process(p->inSyscall ? p : nullptr), bytes(0), hostBytes(0)
+    {
+        if (process)
+            start.setTimer();
+    }
+
+    ~SyscallMemAccount()
+    {
+        if (process) {
+            Time end;
+            end.setTimer();
+            process->recordSyscallMemAccess(bytes, hostBytes, end - start);
+        }
+    }
+
+    void
+    add(int size, bool host)
+    {
+        bytes += size;
+        if (host)
+            hostBytes += size;
+    }
+};
+
+} // anonymous namespace
+
 SETranslatingPortProxy::SETranslatingPortProxy(MasterPort& port, Process *p,
                                            AllocType alloc)
     : PortProxy(port, p->system->cacheLineSize()), pTable(p->pTable),
@@ -64,18 +112,59 @@ SETranslatingPortProxy::SETranslatingPortProxy(MasterPort& port, Process *p,
 SETranslatingPortProxy::~SETranslatingPortProxy()
 { }
 
+bool
+SETranslatingPortProxy::readPage(Addr paddr, uint8_t *p, int size) const
+{
+    const uint8_t *host = process->system->functionalHostAddr(paddr, size);
+    if (host) {
+        std::memcpy(p, host, size);
+        return true;
+    }
+
+    PortProxy::readBlobPhys(paddr, 0, p, size);
+    return false;
+}
+
+bool
+SETranslatingPortProxy::writePage(Addr paddr, const uint8_t *p,
+                                  int size) const
+{
+    uint8_t *host = process->system->functionalHostAddr(paddr, size);
+    if (host) {
+        std::memcpy(host, p, size);
+        return true;
+    }
+
+    PortProxy::writeBlobPhys(paddr, 0, p, size);
+    return false;
+}
+
+bool
+SETranslatingPortProxy::memsetPage(Addr paddr, uint8_t val, int size) const
+{
+    uint8_t *host = process->system->functionalHostAddr(paddr, size);
+    if (host) {
+        std::memset(host, val, size);
+        return true;
+    }
+
+    PortProxy::memsetBlobPhys(paddr, 0, val, size);
+    return false;
+}
+
 bool
 SETranslatingPortProxy::tryReadBlob(Addr addr, uint8_t *p, int size) const
 {
+    SyscallMemAccount account(process);
     int prevSize = 0;
 
     for (ChunkGenerator gen(addr, size, PageBytes); !gen.done(); gen.next()) {
         Addr paddr;
 
-        if (!pTable->translate(gen.addr(),paddr))
+        if (!pTable->translate(gen.addr(), paddr, &transCache))
             return false;
 
-        PortProxy::readBlobPhys(paddr, 0, p + prevSize, gen.size());
+        account.add(gen.size(), readPage(paddr, p + prevSize, gen.size()));
         prevSize += gen.size();
     }
 
@@ -94,12 +183,13 @@ bool
 SETranslatingPortProxy::tryWriteBlob(Addr addr, const uint8_t *p,
                                      int size) const
 {
+    SyscallMemAccount account(process);
     int prevSize = 0;
 
     for (ChunkGenerator gen(addr, size, PageBytes); !gen.done(); gen.next()) {
         Addr paddr;
 
-        if (!pTable->translate(gen.addr(), paddr)) {
+        if (!pTable->translate(gen.addr(), paddr, &transCache)) {
             if (allocating == Always) {
                 process->allocateMem(roundDown(gen.addr(), PageBytes),
                                      PageBytes);
@@ -111,10 +201,10 @@ SETranslatingPortProxy::tryWriteBlob(Addr addr, const uint8_t *p,
             } else {
                 return false;
             }
-            pTable->translate(gen.addr(), paddr);
+            pTable->translate(gen.addr(), paddr, &transCache);
         }
 
-        PortProxy::writeBlobPhys(paddr, 0, p + prevSize, gen.size());
+        account.add(gen.size(), writePage(paddr, p + prevSize, gen.size()));
         prevSize += gen.size();
     }
 
@@ -132,20 +222,22 @@ SETranslatingPortProxy::writeBlob(Addr addr, const uint8_t *p, int size) const
 bool
 SETranslatingPortProxy::tryMemsetBlob(Addr addr, uint8_t val, int size) const
 {
+    SyscallMemAccount account(process);
+
     for (ChunkGenerator gen(addr, size, PageBytes); !gen.done(); gen.next()) {
         Addr paddr;
 
-        if (!pTable->translate(gen.addr(), paddr)) {
+        if (!pTable->translate(gen.addr(), paddr, &transCache)) {
             if (allocating == Always) {
                 process->allocateMem(roundDown(gen.addr(), PageBytes),
                                      PageBytes);
-                pTable->translate(gen.addr(), paddr);
+                pTable->translate(gen.addr(), paddr, &transCache);
             } else {
                 return false;
             }
         }
 
-        PortProxy::memsetBlobPhys(paddr, 0, val, gen.size());
+        account.add(gen.size(), memsetPage(paddr, val, gen.size()));
     }
 
     return true;
@@ -162,19 +254,22 @@ SETranslatingPortProxy::memsetBlob(Addr addr, uint8_t val, int size) const
 bool
 SETranslatingPortProxy::tryWriteString(Addr addr, const char *str) const
 {
-    uint8_t c;
-
-    Addr vaddr = addr;
+    SyscallMemAccount account(process);
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(str);
+    const int size = std::strlen(str) + 1;
+    int prevSize = 0;
 
-    do {
-        c = *str++;
+    // Translate once per page rather than once per character; unlike
+    // writeBlob this never allocates missing pages.
+    for (ChunkGenerator gen(addr, size, PageBytes); !gen.done(); gen.next()) {
         Addr paddr;
 
-        if (!pTable->translate(vaddr++, paddr))
+        if (!pTable->translate(gen.addr(), paddr, &transCache))
             return false;
 
-        PortProxy::writeBlob(paddr, &c, 1);
-    } while (c);
+        account.add(gen.size(), writePage(paddr, p + prevSize, gen.size()));
+        prevSize += gen.size();
+    }
 
     return true;
 }
@@ -189,24 +284,50 @@ SETranslatingPortProxy::writeString(Addr addr, const char *str) const
 bool
 SETranslatingPortProxy::tryReadString(std::string &str, Addr addr) const
 {
-    uint8_t c;
+    SyscallMemAccount account(process);
+    const unsigned line_size = process->system->cacheLineSize();
+    std::vector<uint8_t> buf(line_size);
 
     Addr vaddr = addr;
 
     while (true) {
         Addr paddr;
 
-        if (!pTable->translate(vaddr++, paddr))
+        if (!pTable->translate(vaddr, paddr, &transCache))
             return false;
 
-        PortProxy::readBlob(paddr, &c, 1);
-        if (c == '\0')
-            break;
+        const Addr page_left = roundDown(vaddr, PageBytes) + PageBytes - vaddr;
+
+        // Scan the rest of the page in place if it is host backed.
+        const uint8_t *host =
+            process->system->functionalHostAddr(paddr, page_left);
+        if (host) {
+            const uint8_t *end =
+                static_cast<const uint8_t *>(std::memchr(host, 0, page_left));
+            const int len = end ? end - host : page_left;
+            str.append(reinterpret_cast<const char *>(host), len);
+            account.add(end ? len + 1 : len, true);
+            if (end)
+                return true;
+            vaddr += page_left;
+            continue;
+        }
 
-        str += c;
+        // Otherwise fetch a line at a time until the terminator shows up.
+        for (ChunkGenerator gen(paddr, page_left, line_size); !gen.done();
+             gen.next()) {
+            PortProxy::readBlobPhys(gen.addr(), 0, buf.data(), gen.size());
+            account.add(gen.size(), false);
+
+            const uint8_t *end = static_cast<const uint8_t *>(
+                std::memchr(buf.data(), 0, gen.size()));
+            const int len = end ? end - buf.data() : gen.size();
+            str.append(reinterpret_cast<const char *>(buf.data()), len);
+            if (end)
+                return true;
+        }
+        vaddr += page_left;
     }
-
-    return true;
 }
 
 void
@@ -215,4 +336,3 @@ SETranslatingPortProxy::readString(std::string &str, Addr addr) const
     if (!tryReadString(str, addr))
         fatal("readString(0x%x, ...) failed", addr);
 }
-
@@ -45,9 +45,9 @@
 #ifndef __MEM_SE_TRANSLATING_PORT_PROXY_HH__
 #define __MEM_SE_TRANSLATING_PORT_PROXY_HH__
 
+#include "mem/page_table.hh"
 #include "mem/port_proxy.hh"
 
-class EmulationPageTable;
 class Process;
 
 /**
@@ -79,6 +79,22 @@ class SETranslatingPortProxy : public PortProxy
     Process *process;
     AllocType allocating;
 
+    /** Recent translations, private to the thread using this proxy. */
+    mutable EmulationPageTable::TranslationCache transCache;
+
+    /** @{ */
+    /**
+     * Access a block of physical memory that does not cross a page
+     * boundary. The access goes straight to host memory when the
+     * system allows it, and through the port otherwise.
+     *
+     * @return Whether the access was served from host memory
+     */
+    bool readPage(Addr paddr, uint8_t *p, int size) const;
+    bool writePage(Addr paddr, const uint8_t *p, int size) const;
+    bool memsetPage(Addr paddr, uint8_t val, int size) const;
+    /** @} */
+
   public:
     SETranslatingPortProxy(MasterPort& port, Process* p, AllocType alloc);
     ~SETranslatingPortProxy();
@@ -44,22 +44,118 @@
 
 #include "mem/snoop_filter.hh"
 
+#include <algorithm>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/SnoopFilter.hh"
 #include "sim/system.hh"
 
+SnoopFilter::SnoopFilter(const SnoopFilterParams *p)
+    : SimObject(p), reqLookupResult(nullptr), retryItem{0, 0},
+      linesize(p->system->cacheLineSize()), lookupLatency(p->lookup_latency),
+      maxEntryCount(p->max_capacity / p->system->cacheLineSize()),
+      assoc(p->assoc), numSets(maxEntryCount / std::max(assoc, 1U)),
+      setShift(floorLog2(linesize)), touchCounter(0),
+      evictionPending(false)
+{
+    fatal_if(assoc == 0 || maxEntryCount < assoc,
+             "%s: associativity must be between 1 and %d\n",
+             name(), maxEntryCount);
+    fatal_if(!isPowerOf2(numSets),
+             "%s: number of sets (%d) must be a power of 2\n",
+             name(), numSets);
+
+    entries.resize(numSets * assoc, SnoopEntry{0, {0, 0}, 0, false});
+}
+
 void
-SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
+SnoopFilter::eraseIfNullEntry(SnoopEntry* sf_entry)
 {
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = sf_entry->item;
     if (!(sf_item.requested | sf_item.holder)) {
-        cachedLocations.erase(sf_it);
+        sf_entry->valid = false;
         DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
                 __func__);
     }
 }
 
+SnoopFilter::SnoopEntry*
+SnoopFilter::findEntry(Addr line_addr)
+{
+    SnoopEntry* set = &entries[((line_addr >> setShift) & (numSets - 1)) *
+                               assoc];
+    for (unsigned way = 0; way < assoc; ++way) {
+        SnoopEntry& entry = set[way];
+        if (entry.valid && entry.lineAddr == line_addr) {
+            entry.lastTouch = ++touchCounter;
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+SnoopFilter::SnoopEntry*
+SnoopFilter::allocateEntry(Addr line_addr)
+{
+    SnoopEntry* set = &entries[((line_addr >> setShift) & (numSets - 1)) *
+                               assoc];
+    SnoopEntry* victim = nullptr;
+    for (unsigned way = 0; way < assoc; ++way) {
+        SnoopEntry& entry = set[way];
+        if (!entry.valid) {
+            victim = &entry;
+            break;
+        }
+        // lines with in-flight requests cannot be evicted as the
+        // responses still need to find their entry
+        if (entry.item.requested)
+            continue;
+        if (!victim || entry.lastTouch < victim->lastTouch)
+            victim = &entry;
+    }
+
+    panic_if(!victim, "%s: all %d ways of the set for %#x have in-flight "
+             "requests, increase the snoop filter associativity\n",
+             name(), assoc, line_addr);
+
+    if (victim->valid) {
+        // only one allocation happens per lookupRequest and the
+        // crossbar collects the eviction straight after
+        assert(!evictionPending);
+        evictions++;
+        evictedHolders += popCount(victim->item.holder);
+        DPRINTF(SnoopFilter, "%s:   Evicting %#x SF value %x.%x\n",
+                __func__, victim->lineAddr, victim->item.requested,
+                victim->item.holder);
+
+        pendingEviction.addr = victim->lineAddr & ~Addr(LineSecure);
+        pendingEviction.isSecure = victim->lineAddr & LineSecure;
+        pendingEviction.holders = maskToPortList(victim->item.holder);
+        evictionPending = true;
+    }
+
+    victim->lineAddr = line_addr;
+    victim->item = SnoopItem{0, 0};
+    victim->lastTouch = ++touchCounter;
+    victim->valid = true;
+    return victim;
+}
+
+bool
+SnoopFilter::takeEviction(Eviction& eviction)
+{
+    if (!evictionPending)
+        return false;
+
+    eviction = pendingEviction;
+    pendingEviction.holders.clear();
+    evictionPending = false;
+    return true;
+}
+
 std::pair<SnoopFilter::SnoopList, Cycles>
 SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
 {
@@ -74,19 +170,26 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
         line_addr |= LineSecure;
     }
     SnoopMask req_port = portToMask(slave_port);
-    reqLookupResult = cachedLocations.find(line_addr);
-    bool is_hit = (reqLookupResult != cachedLocations.end());
+    reqLookupResult = findEntry(line_addr);
+    bool is_hit = (reqLookupResult != nullptr);
+
+    if (is_hit)
+        hits++;
+    else
+        misses++;
 
     // If the snoop filter has no entry, and we should not allocate,
     // do not create a new snoop filter entry, simply return a NULL
-    // portlist.
-    if (!is_hit && !allocate)
+    // portlist. The same holds for evictions of lines that have
+    // already been back-invalidated, the line is no longer tracked
+    // and there is nobody left to inform.
+    if (!is_hit && (!allocate || cpkt->isEviction()))
         return snoopDown(lookupLatency);
 
-    // If no hit in snoop filter create a new element and update iterator
+    // If no hit in snoop filter create a new element
     if (!is_hit)
-        reqLookupResult = cachedLocations.emplace(line_addr, SnoopItem()).first;
-    SnoopItem& sf_item = reqLookupResult->second;
+        reqLookupResult = allocateEntry(line_addr);
+    SnoopItem& sf_item = reqLookupResult->item;
     SnoopMask interested = sf_item.holder | sf_item.requested;
 
     // Store unmodified value of snoop filter item in temp storage in
@@ -152,25 +255,26 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
 void
 SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
 {
-    if (reqLookupResult != cachedLocations.end()) {
+    if (reqLookupResult) {
         // since we rely on the caller, do a basic check to ensure
         // that finishRequest is being called following lookupRequest
         Addr line_addr = (addr & ~(Addr(linesize - 1)));
         if (is_secure) {
             line_addr |= LineSecure;
         }
-        assert(reqLookupResult->first == line_addr);
+        assert(reqLookupResult->lineAddr == line_addr);
         if (will_retry) {
             // Undo any changes made in lookupRequest to the snoop filter
             // entry if the request will come again. retryItem holds
             // the previous value of the snoopfilter entry.
-            reqLookupResult->second = retryItem;
+            reqLookupResult->item = retryItem;
 
             DPRINTF(SnoopFilter, "%s:   restored SF value %x.%x\n",
                     __func__,  retryItem.requested, retryItem.holder);
         }
 
         eraseIfNullEntry(reqLookupResult);
+        reqLookupResult = nullptr;
     }
 }
 
@@ -185,12 +289,13 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
+    SnoopEntry* sf_entry = findEntry(line_addr);
+    bool is_hit = (sf_entry != nullptr);
 
-    panic_if(!is_hit && (cachedLocations.size() >= maxEntryCount),
-             "snoop filter exceeded capacity of %d cache blocks\n",
-             maxEntryCount);
+    if (is_hit)
+        hits++;
+    else
+        misses++;
 
     // If the snoop filter has no entry, simply return a NULL
     // portlist, there is no point creating an entry only to remove it
@@ -198,7 +303,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (!is_hit)
         return snoopDown(lookupLatency);
 
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = sf_entry->item;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__, sf_item.requested, sf_item.holder);
@@ -229,7 +334,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
         sf_item.holder = 0;
     }
 
-    eraseIfNullEntry(sf_it);
+    eraseIfNullEntry(sf_entry);
     DPRINTF(SnoopFilter, "%s:   new SF value %x.%x interest: %x \n",
             __func__, sf_item.requested, sf_item.holder, interested);
 
@@ -260,7 +365,12 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     }
     SnoopMask rsp_mask = portToMask(rsp_port);
     SnoopMask req_mask = portToMask(req_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    SnoopEntry* sf_entry = findEntry(line_addr);
+
+    // The requester has an outstanding request, and entries with
+    // outstanding requests are never evicted
+    panic_if(!sf_entry, "SF has no entry for %#x\n", line_addr);
+    SnoopItem& sf_item = sf_entry->item;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -306,14 +416,13 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = sf_it != cachedLocations.end();
+    SnoopEntry* sf_entry = findEntry(line_addr);
 
     // Nothing to do if it is not a hit
-    if (!is_hit)
+    if (!sf_entry)
         return;
 
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = sf_entry->item;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -326,7 +435,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     }
     DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
             __func__, sf_item.requested, sf_item.holder);
-    eraseIfNullEntry(sf_it);
+    eraseIfNullEntry(sf_entry);
 
 }
 
@@ -348,12 +457,12 @@ SnoopFilter::updateResponse(const Packet* cpkt, const SlavePort& slave_port)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    if (sf_it == cachedLocations.end())
+    SnoopEntry* sf_entry = findEntry(line_addr);
+    if (!sf_entry)
         return;
 
     SnoopMask slave_mask = portToMask(slave_port);
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = sf_entry->item;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -371,7 +480,7 @@ SnoopFilter::updateResponse(const Packet* cpkt, const SlavePort& slave_port)
         if (cpkt->isInvalidate()) {
             sf_item.holder &= ~slave_mask;
         }
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(sf_entry);
     } else {
         // Any other response implies that a cache above will have the
         // block.
@@ -414,6 +523,26 @@ SnoopFilter::regStats()
         .name(name() + ".hit_multi_snoops")
         .desc("Number of snoops hitting in the snoop filter with multiple "\
               "(>1) holders of the requested data.");
+
+    hits
+        .name(name() + ".hits")
+        .desc("Number of requests and snoops finding an entry in the "\
+              "snoop filter.");
+
+    misses
+        .name(name() + ".misses")
+        .desc("Number of requests and snoops not finding an entry in the "\
+              "snoop filter.");
+
+    evictions
+        .name(name() + ".evictions")
+        .desc("Number of snoop filter entries evicted to make room for "\
+              "new lines.");
+
+    evictedHolders
+        .name(name() + ".evicted_holders")
+        .desc("Number of holders of evicted lines that need a "\
+              "back-invalidation.");
 }
 
 SnoopFilter *
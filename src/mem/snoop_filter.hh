@@ -45,8 +45,8 @@
 #ifndef __MEM_SNOOP_FILTER_HH__
 #define __MEM_SNOOP_FILTER_HH__
 
-#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "mem/packet.hh"
 #include "mem/port.hh"
@@ -67,6 +67,15 @@
  * allows the snoop filter to model cache-line residency by snooping
  * the messages.
  *
+ * The filter is organised as a set-associative structure with a
+ * bounded number of entries (max_capacity / line size). When a new
+ * line needs to be tracked and its set is full, the least recently
+ * used entry without in-flight requests is evicted. As the filter has
+ * to remain a superset of the lines cached above, the holders of the
+ * victim are back-invalidated by the crossbar (see
+ * takeEviction). Entries with outstanding requests are never
+ * evicted.
+ *
  * The tracking happens in two fields to be able to distinguish
  * between in-flight requests (in requested) and already pulled in
  * lines (in holder). This distinction is used for producing tighter
@@ -88,12 +97,7 @@ class SnoopFilter : public SimObject {
   public:
     typedef std::vector<QueuedSlavePort*> SnoopList;
 
-    SnoopFilter (const SnoopFilterParams *p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()), retryItem{0, 0},
-        linesize(p->system->cacheLineSize()), lookupLatency(p->lookup_latency),
-        maxEntryCount(p->max_capacity / p->system->cacheLineSize())
-    {
-    }
+    SnoopFilter (const SnoopFilterParams *p);
 
     /**
      * Init a new snoop filter and tell it about all the slave ports
@@ -192,6 +196,30 @@ class SnoopFilter : public SimObject {
      */
     void updateResponse(const Packet *cpkt, const SlavePort& slave_port);
 
+    /**
+     * A line evicted from the filter to make room for a new one. The
+     * holders of the line have to be back-invalidated so that the
+     * filter remains a superset of the lines cached above.
+     */
+    struct Eviction {
+        /** Line address of the victim */
+        Addr addr;
+        /** Is the victim in the secure address space */
+        bool isSecure;
+        /** Slave ports that hold a copy of the line */
+        SnoopList holders;
+    };
+
+    /**
+     * Retrieve the eviction caused by the last call to lookupRequest,
+     * if any. The caller is responsible for issuing the
+     * back-invalidations to the returned holders.
+     *
+     * @param eviction Filled in with the victim line and its holders
+     * @return True if there was an eviction pending
+     */
+    bool takeEviction(Eviction& eviction);
+
     virtual void regStats();
 
   protected:
@@ -201,7 +229,7 @@ class SnoopFilter : public SimObject {
      * limits the number of snooping ports supported per crossbar. For
      * the moment it is an uint64_t to offer maximum
      * scalability. However, it is possible to use e.g. a uint16_t or
-     * uint32_to slim down the footprint of the hash map (and
+     * uint32_to slim down the footprint of the filter storage (and
      * ultimately improve the simulation performance).
      */
     typedef uint64_t SnoopMask;
@@ -216,9 +244,16 @@ class SnoopFilter : public SimObject {
         SnoopMask holder;
     };
     /**
-     * HashMap of SnoopItems indexed by line address
+     * A way in the set-associative storage of the filter. The line
+     * address includes the LineSecure bit.
      */
-    typedef std::unordered_map<Addr, SnoopItem> SnoopFilterCache;
+    struct SnoopEntry {
+        Addr lineAddr;
+        SnoopItem item;
+        /** Time stamp of the last access, used for LRU replacement */
+        uint64_t lastTouch;
+        bool valid;
+    };
 
     /**
      * Simple factory methods for standard return values.
@@ -256,15 +291,35 @@ class SnoopFilter : public SimObject {
     /**
      * Removes snoop filter items which have no requesters and no holders.
      */
-    void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
+    void eraseIfNullEntry(SnoopEntry* sf_entry);
+
+    /**
+     * Find the entry tracking a line and update its replacement
+     * state.
+     *
+     * @param line_addr Line address, including the LineSecure bit
+     * @return The matching entry or nullptr on a miss
+     */
+    SnoopEntry* findEntry(Addr line_addr);
 
-    /** Simple hash set of cached addresses. */
-    SnoopFilterCache cachedLocations;
     /**
-     * Iterator used to store the result from lookupRequest until we
+     * Allocate an entry for a line that missed in the filter. If the
+     * set is full, the least recently used entry that has no
+     * outstanding requests is evicted and recorded so that the
+     * crossbar can back-invalidate its holders.
+     *
+     * @param line_addr Line address, including the LineSecure bit
+     * @return The newly allocated (empty) entry
+     */
+    SnoopEntry* allocateEntry(Addr line_addr);
+
+    /** Flat set-associative storage, numSets x assoc entries. */
+    std::vector<SnoopEntry> entries;
+    /**
+     * Entry used to store the result from lookupRequest until we
      * call finishRequest.
      */
-    SnoopFilterCache::iterator reqLookupResult;
+    SnoopEntry* reqLookupResult;
     /**
      * Variable to temporarily store value of snoopfilter entry
      * incase finishRequest needs to undo changes made in lookupRequest
@@ -279,8 +334,19 @@ class SnoopFilter : public SimObject {
     const unsigned linesize;
     /** Latency for doing a lookup in the filter */
     const Cycles lookupLatency;
-    /** Max capacity in terms of cache blocks tracked, for sanity checking */
+    /** Max capacity in terms of cache blocks tracked */
     const unsigned maxEntryCount;
+    /** Number of ways per set */
+    const unsigned assoc;
+    /** Number of sets, maxEntryCount / assoc */
+    const unsigned numSets;
+    /** Number of bits to shift a line address to get the set index */
+    const unsigned setShift;
+    /** Monotonically increasing counter used to time stamp accesses */
+    uint64_t touchCounter;
+    /** Victim of the last allocation awaiting back-invalidation */
+    bool evictionPending;
+    Eviction pendingEviction;
 
     /**
      * Use the lower bits of the address to keep track of the line status
@@ -298,6 +364,11 @@ class SnoopFilter : public SimObject {
     Stats::Scalar totSnoops;
     Stats::Scalar hitSingleSnoops;
     Stats::Scalar hitMultiSnoops;
+
+    Stats::Scalar hits;
+    Stats::Scalar misses;
+    Stats::Scalar evictions;
+    Stats::Scalar evictedHolders;
 };
 
 inline SnoopFilter::SnoopMask
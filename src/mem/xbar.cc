@@ -61,6 +61,7 @@ BaseXBar::BaseXBar(const BaseXBarParams *p)
       forwardLatency(p->forward_latency),
       responseLatency(p->response_latency),
       width(p->width),
+      lazyLayerRelease(p->lazy_layer_release),
       gotAddrRanges(p->port_default_connection_count +
                           p->port_master_connection_count, false),
       gotAllAddrRanges(false), defaultPortID(InvalidPortID),
@@ -146,7 +147,7 @@ BaseXBar::calcPacketTiming(PacketPtr pkt, Tick header_delay)
 template <typename SrcType, typename DstType>
 BaseXBar::Layer<SrcType,DstType>::Layer(DstType& _port, BaseXBar& _xbar,
                                        const std::string& _name) :
-    port(_port), xbar(_xbar), _name(_name), state(IDLE),
+    port(_port), xbar(_xbar), _name(_name), state(IDLE), busyUntil(0),
     waitingForPeer(NULL), releaseEvent([this]{ releaseLayer(); }, name())
 {
 }
@@ -162,7 +163,16 @@ void BaseXBar::Layer<SrcType,DstType>::occupyLayer(Tick until)
 
     // until should never be 0 as express snoops never occupy the layer
     assert(until != 0);
-    xbar.schedule(releaseEvent, until);
+
+    // if nobody is waiting for the layer, there is nobody to tell
+    // when it is free again, and we can leave it to the next user
+    // to notice that the occupancy has expired
+    if (xbar.lazyLayerRelease && waitingForLayer.empty() &&
+        waitingForPeer == NULL && drainState() != DrainState::Draining) {
+        busyUntil = until;
+    } else {
+        xbar.schedule(releaseEvent, until);
+    }
 
     // account for the occupied ticks
     occupancy += until - curTick();
@@ -171,10 +181,28 @@ void BaseXBar::Layer<SrcType,DstType>::occupyLayer(Tick until)
             curTick(), until);
 }
 
+template <typename SrcType, typename DstType>
+void
+BaseXBar::Layer<SrcType,DstType>::checkLazyRelease(bool need_release)
+{
+    if (state != BUSY || releaseEvent.scheduled())
+        return;
+
+    if (curTick() >= busyUntil) {
+        // the occupancy ended while nobody was looking
+        state = IDLE;
+    } else if (need_release) {
+        xbar.schedule(releaseEvent, busyUntil);
+    }
+}
+
 template <typename SrcType, typename DstType>
 bool
 BaseXBar::Layer<SrcType,DstType>::tryTiming(SrcType* src_port)
 {
+    if (xbar.lazyLayerRelease)
+        checkLazyRelease(true);
+
     // if we are in the retry state, we will not see anything but the
     // retrying port (or in the case of the snoop ports the snoop
     // response port that mirrors the actual slave port) as we leave
@@ -311,6 +339,9 @@ BaseXBar::Layer<SrcType,DstType>::recvRetry()
     // we are no longer waiting for the peer
     waitingForPeer = NULL;
 
+    if (xbar.lazyLayerRelease)
+        checkLazyRelease(true);
+
     // if the layer is idle, retry this port straight away, if we
     // are busy, then simply let the port wait for its turn
     if (state == IDLE) {
@@ -583,6 +614,9 @@ template <typename SrcType, typename DstType>
 DrainState
 BaseXBar::Layer<SrcType,DstType>::drain()
 {
+    if (xbar.lazyLayerRelease)
+        checkLazyRelease(true);
+
     //We should check that we're not "doing" anything, and that noone is
     //waiting. We might be idle but have someone waiting if the device we
     //contacted for a retry didn't actually retry.
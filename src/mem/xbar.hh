@@ -52,12 +52,13 @@
 #define __MEM_XBAR_HH__
 
 #include <deque>
-#include <unordered_map>
+#include <vector>
 
 #include "base/addr_range_map.hh"
 #include "base/types.hh"
 #include "mem/mem_object.hh"
 #include "mem/qport.hh"
+#include "mem/xbar_route_table.hh"
 #include "params/BaseXBar.hh"
 #include "sim/stats.hh"
 
@@ -157,6 +158,17 @@ class BaseXBar : public MemObject
         /** Occupy the layer until until */
         void occupyLayer(Tick until);
 
+        /**
+         * With lazy release, an uncontended layer is occupied without
+         * scheduling the release event. Check if such an occupancy
+         * has expired and return the layer to idle if so, or schedule
+         * the release event if someone now needs to be told when the
+         * layer becomes free.
+         *
+         * @param need_release True if a port is waiting or we drain
+         */
+        void checkLazyRelease(bool need_release);
+
         /**
          * Send a retry to the port at the head of waitingForLayer. The
          * caller must ensure that the list is not empty.
@@ -217,6 +229,12 @@ class BaseXBar : public MemObject
         /** track the state of the layer */
         State state;
 
+        /**
+         * End of the current occupancy when the layer is busy without
+         * a scheduled release event (lazy release only).
+         */
+        Tick busyUntil;
+
         /**
          * A deque of ports that retry should be called on because
          * the original send was delayed due to a busy layer.
@@ -318,6 +336,8 @@ class BaseXBar : public MemObject
     const Cycles responseLatency;
     /** the width of the xbar in bytes */
     const uint32_t width;
+    /** Occupy uncontended layers without scheduling release events */
+    const bool lazyLayerRelease;
 
     AddrRangeMap<PortID, 3> portMap;
 
@@ -327,7 +347,7 @@ class BaseXBar : public MemObject
      * the underlying Request pointer inside the Packet stays
      * constant.
      */
-    std::unordered_map<RequestPtr, PortID> routeTo;
+    RouteTable routeTo;
 
     /** all contigous ranges seen by this crossbar */
     AddrRangeList xbarRanges;
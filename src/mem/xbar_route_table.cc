@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/xbar_route_table.hh"
+
+#include <cassert>
+
+RouteTable::RouteTable()
+    : slots(64, Slot{nullptr, InvalidPortID}), mask(63), shift(64 - 6),
+      count(0)
+{
+}
+
+void
+RouteTable::insert(const RequestPtr& req, PortID port)
+{
+    // keep the load factor at or below one half
+    if (2 * (count + 1) > slots.size())
+        grow();
+
+    size_t i = index(req.get());
+    while (slots[i].req) {
+        assert(slots[i].req != req);
+        i = (i + 1) & mask;
+    }
+    slots[i] = Slot{req, port};
+    ++count;
+}
+
+PortID
+RouteTable::find(const RequestPtr& req) const
+{
+    size_t i = index(req.get());
+    while (slots[i].req) {
+        if (slots[i].req == req)
+            return slots[i].port;
+        i = (i + 1) & mask;
+    }
+    return InvalidPortID;
+}
+
+void
+RouteTable::erase(const RequestPtr& req)
+{
+    size_t i = index(req.get());
+    while (slots[i].req != req) {
+        assert(slots[i].req);
+        i = (i + 1) & mask;
+    }
+
+    // shift back any following entries that would otherwise no
+    // longer be reachable from their home slot
+    size_t hole = i;
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        if (!slots[j].req)
+            break;
+        size_t home = index(slots[j].req.get());
+        // move the entry if its home is not cyclically in (hole, j]
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            slots[hole] = std::move(slots[j]);
+            hole = j;
+        }
+    }
+    slots[hole] = Slot{nullptr, InvalidPortID};
+    --count;
+}
+
+void
+RouteTable::grow()
+{
+    std::vector<Slot> old_slots(2 * slots.size(),
+                                Slot{nullptr, InvalidPortID});
+    old_slots.swap(slots);
+    mask = slots.size() - 1;
+    --shift;
+
+    for (auto& slot : old_slots) {
+        if (slot.req) {
+            size_t i = index(slot.req.get());
+            while (slots[i].req)
+                i = (i + 1) & mask;
+            slots[i] = std::move(slot);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_XBAR_ROUTE_TABLE_HH__
+#define __MEM_XBAR_ROUTE_TABLE_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/request.hh"
+
+/**
+ * A flat, open-addressed table mapping outstanding requests to a
+ * port id. The number of outstanding requests through a crossbar
+ * is small, so a power-of-two array of slots with linear probing
+ * avoids the node allocation and pointer chasing of a hash map on
+ * every request/response pair. Deletion uses backward shifting so
+ * no tombstones are needed.
+ */
+class RouteTable
+{
+  public:
+
+    RouteTable();
+
+    /**
+     * Remember the port for a request, which must not already
+     * be present.
+     */
+    void insert(const RequestPtr& req, PortID port);
+
+    /**
+     * Look up the port for a request.
+     *
+     * @return The port id, or InvalidPortID if not present
+     */
+    PortID find(const RequestPtr& req) const;
+
+    /** Forget a request, which must be present. */
+    void erase(const RequestPtr& req);
+
+    /** Number of outstanding requests in the table */
+    size_t size() const { return count; }
+
+  private:
+
+    /**
+     * The slot holds a reference to the request so that it
+     * cannot be freed, and its address reused by a new request,
+     * while the request is routed.
+     */
+    struct Slot {
+        RequestPtr req;
+        PortID port;
+    };
+
+    /** Home slot of a request in the current table */
+    size_t index(const Request* req) const
+    {
+        // requests are heap allocated, so drop the alignment
+        // bits and mix the rest with a Fibonacci hash
+        return ((reinterpret_cast<uintptr_t>(req) >> 4) *
+                0x9E3779B97F4A7C15ULL) >> shift;
+    }
+
+    /** Double the number of slots and rehash */
+    void grow();
+
+    std::vector<Slot> slots;
+    size_t mask;
+    unsigned shift;
+    size_t count;
+};
+
+#endif //__MEM_XBAR_ROUTE_TABLE_HH__
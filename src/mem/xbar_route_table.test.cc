@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "mem/xbar_route_table.hh"
+
+/** A table without routes finds no port for any request */
+TEST(RouteTableTest, Empty)
+{
+    RouteTable table;
+    RequestPtr req = std::make_shared<Request>();
+
+    EXPECT_EQ(table.size(), 0);
+    EXPECT_EQ(table.find(req), InvalidPortID);
+}
+
+TEST(RouteTableTest, InsertFindErase)
+{
+    RouteTable table;
+    RequestPtr a = std::make_shared<Request>();
+    RequestPtr b = std::make_shared<Request>();
+
+    table.insert(a, 3);
+    table.insert(b, 0);
+    EXPECT_EQ(table.size(), 2);
+    EXPECT_EQ(table.find(a), 3);
+    EXPECT_EQ(table.find(b), 0);
+
+    table.erase(a);
+    EXPECT_EQ(table.size(), 1);
+    EXPECT_EQ(table.find(a), InvalidPortID);
+    EXPECT_EQ(table.find(b), 0);
+}
+
+/** Routes survive the table growing past its initial slots */
+TEST(RouteTableTest, Grow)
+{
+    RouteTable table;
+    std::vector<RequestPtr> reqs;
+    for (int i = 0; i < 1000; i++) {
+        reqs.push_back(std::make_shared<Request>());
+        table.insert(reqs.back(), i % 7);
+    }
+
+    EXPECT_EQ(table.size(), reqs.size());
+    for (size_t i = 0; i < reqs.size(); i++)
+        EXPECT_EQ(table.find(reqs[i]), i % 7);
+}
+
+/** The table holds on to a request until its route is erased */
+TEST(RouteTableTest, KeepsRequestAlive)
+{
+    RouteTable table;
+    RequestPtr req = std::make_shared<Request>();
+    std::weak_ptr<Request> weak = req;
+
+    table.insert(req, 1);
+    req.reset();
+    EXPECT_FALSE(weak.expired());
+
+    table.erase(weak.lock());
+    EXPECT_TRUE(weak.expired());
+}
+
+/**
+ * Random inserts and erases give the same routes as the hash map the
+ * crossbar used before, including for requests whose routes were
+ * erased, so that backward shifting never loses a colliding entry.
+ */
+TEST(RouteTableTest, MatchesHashMap)
+{
+    RouteTable table;
+    std::unordered_map<RequestPtr, PortID> ref;
+    std::vector<RequestPtr> live;
+    std::vector<RequestPtr> erased;
+    std::mt19937 rng(1);
+
+    for (int step = 0; step < 100000; step++) {
+        // keep a few hundred requests outstanding, like a busy xbar
+        if (live.empty() || rng() % 512 >= live.size()) {
+            RequestPtr req = std::make_shared<Request>();
+            PortID port = rng() % 16;
+            table.insert(req, port);
+            ref[req] = port;
+            live.push_back(req);
+        } else {
+            size_t i = rng() % live.size();
+            table.erase(live[i]);
+            ref.erase(live[i]);
+            erased.push_back(live[i]);
+            live[i] = live.back();
+            live.pop_back();
+            if (erased.size() > 64)
+                erased.erase(erased.begin());
+        }
+
+        if (step % 97 == 0) {
+            ASSERT_EQ(table.size(), ref.size());
+            for (auto &req : live)
+                ASSERT_EQ(table.find(req), ref[req]);
+            for (auto &req : erased)
+                ASSERT_EQ(table.find(req), InvalidPortID);
+        }
+    }
+}
@@ -105,6 +105,11 @@ def parse_options():
     group("Statistics Options")
     option("--stats-file", metavar="FILE", default="stats.txt",
         help="Sets the output file for statistics [Default: %default]")
+    option("--stats-server", metavar="PATH", default=None,
+        help="Serve live stats on a Unix socket at PATH, relative to the " \
+             "output directory. Started also when --listener-mode=auto " \
+             "disables the other listeners, but not with " \
+             "--listener-mode=off [Default: off]")
 
     # Configuration Options
     group("Configuration Options")
@@ -120,6 +125,13 @@ def parse_options():
 
     # Debugging options
     group("Debugging Options")
+    option("--event-profile", metavar="NAME", default=None,
+        help="Profile host time per event and write NAME.txt and " \
+             "NAME.folded (flamegraph input) to the output directory " \
+             "[Default: off]")
+    option("--event-profile-period", metavar="N", type='int', default=16,
+        help="Time one in N events on average when profiling; 1 times " \
+             "every event [Default: %default]")
     option("--debug-break", metavar="TICK[,TICK]", action='append', split=',',
         help="Create breakpoint(s) at TICK(s) " \
              "(kills process if no debugger attached)")
@@ -131,8 +143,18 @@ def parse_options():
         help="Start debug output at TICK")
     option("--debug-end", metavar="TICK", type='int',
         help="End debug output at TICK")
-    option("--debug-file", metavar="FILE", default="cout",
-        help="Sets the output file for debug [Default: %default]")
+    option("--debug-file", metavar="FILE", default=None,
+        help="Sets the output file for debug [Default: cout, or " \
+             "trace.bin for the binary formats]")
+    option("--debug-format", metavar="FORMAT", default="text",
+        choices=["text", "binary", "flight"],
+        help="Format of the debug output: text, binary (decode with " \
+             "util/decode_trace.py) or flight (binary, keeping only the " \
+             "last records of each thread until exit or abort) " \
+             "[Default: %default]")
+    option("--debug-flight-records", metavar="N", type='int', default=10000,
+        help="Records kept per thread by --debug-format=flight " \
+             "[Default: %default]")
     option("--debug-ignore", metavar="EXPR", action='append', split=':',
         help="Ignore EXPR sim objects")
     option("--remote-gdb-port", type='int', default=7000,
@@ -211,7 +233,7 @@ def main(*args):
     import stats
     import trace
 
-    from util import inform, fatal, panic, isInteractive
+    from util import inform, warn, fatal, panic, isInteractive
 
     if len(args) == 0:
         options, arguments = parse_options()
@@ -346,6 +368,14 @@ def main(*args):
 
     # set stats options
     stats.addStatVisitor(options.stats_file)
+    # An explicit --stats-server enables its listener even when the
+    # auto listener mode disables the others below, as batch runs
+    # without a terminal are the ones that need it
+    if options.stats_server:
+        if options.listener_mode == "off":
+            warn("Listeners are off, not starting the stats server.")
+        else:
+            stats.startServer(options.stats_server)
 
     # Disable listeners unless running interactively or explicitly
     # enabled
@@ -400,7 +430,21 @@ def main(*args):
         e = event.create(trace.disable, event.Event.Debug_Enable_Pri)
         event.mainq.schedule(e, options.debug_end)
 
-    trace.output(options.debug_file)
+    debug_file = options.debug_file
+    if options.debug_format == "text":
+        debug_file = debug_file or "cout"
+    elif not debug_file:
+        debug_file = "trace.bin"
+    elif debug_file in ("cout", "stdout", "cerr", "stderr"):
+        fatal("--debug-format=%s needs a --debug-file, binary output " \
+              "cannot go to %s", options.debug_format, debug_file)
+
+    if options.debug_format == "text":
+        trace.output(debug_file)
+    elif options.debug_format == "binary":
+        trace.outputBinary(debug_file, 0)
+    else:
+        trace.outputBinary(debug_file, options.debug_flight_records)
 
     for ignore in options.debug_ignore:
         _check_tracing()
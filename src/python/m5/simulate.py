@@ -49,6 +49,8 @@ import sys
 # import the wrapped C++ functions
 import _m5.drain
 import _m5.core
+import _m5.event
+import _m5.trace
 from _m5.stats import updateEvents as updateStatEvents
 
 import stats
@@ -148,6 +150,11 @@ def instantiate(ckpt_dir=None):
     else:
         for obj in root.descendants(): obj.initState()
 
+    # Measure the host time spent in each event if requested
+    if options.event_profile:
+        _m5.event.enableProfiling(options.event_profile,
+                                  options.event_profile_period)
+
     # Check to see if any of the stat events are in the past after resuming from
     # a checkpoint, If so, this call will shift them to be at a valid time.
     updateStatEvents()
@@ -346,6 +353,10 @@ def fork(simout="%(parent)s.f%(fork_seq)i"):
 
     drain()
 
+    # Write out buffered output, so the child starts from complete
+    # copies of the output files and nothing is written twice
+    _m5.core.flushOutput()
+
     try:
         pid = os.fork()
     except OSError as e:
@@ -363,11 +374,61 @@ def fork(simout="%(parent)s.f%(fork_seq)i"):
                 "pid" : os.getpid(),
                 }
         _m5.core.setOutputDir(options.outdir)
+        _m5.trace.notifyFork()
     else:
         fork_count += 1
 
     return pid
 
+def forkSweep(points, max_children=1, simout="%(parent)s.%(name)s"):
+    """Fork one child per design point from the current simulator state.
+
+    The simulator is drained once and forked for every point, so all
+    children share the warmed state of the parent copy-on-write. At
+    most max_children children run at the same time; the parent waits
+    for all of them before returning.
+
+    Arguments:
+      points -- List of (name, value) pairs, one per child.
+
+    Keyword Arguments:
+      max_children -- Number of children running concurrently.
+      simout -- Output directory of a child. In addition to the keys
+                accepted by fork(), "name" expands to the point name.
+
+    Return Value:
+      (name, value) of the point in a child; (None, status) in the
+      parent, where status maps each point name to its exit status as
+      returned by os.waitpid().
+    """
+    if max_children < 1:
+        raise ValueError("forkSweep needs at least one child slot")
+
+    running = {}
+    status = {}
+
+    def reap():
+        pid, code = os.waitpid(-1, 0)
+        name = running.pop(pid)
+        status[name] = code
+        print("Fork sweep: %s (pid %d) finished with status %d" %
+              (name, pid, code))
+
+    for name, value in points:
+        while len(running) >= max_children:
+            reap()
+
+        out = simout.replace("%(name)s", str(name).replace("%", "%%"))
+        pid = fork(out)
+        if pid == 0:
+            return name, value
+        running[pid] = name
+
+    while running:
+        reap()
+
+    return None, status
+
 from _m5.core import disableAllListeners, listenersDisabled
 from _m5.core import listenersLoopbackOnly
 from _m5.core import curTick
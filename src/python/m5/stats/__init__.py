@@ -119,11 +119,27 @@ def _textFactory(fn, desc=True):
 
     return _m5.stats.initText(fn, desc)
 
+@_url_factory
+def _binaryFactory(fn, compress=False):
+    """Output stats in a binary columnar format.
+
+    The stat names and shapes are written once and every dump then
+    only adds the raw values, which makes frequent periodic dumps much
+    cheaper than text. Dumps can be compressed with zlib by setting the
+    compress parameter to True. m5.stats.binary reads the files.
+
+    Example: binary://stats.bin?compress=True
+
+    """
+
+    return _m5.stats.initBinary(fn, compress)
+
 factories = {
     # Default to the text factory if we're given a naked path
     "" : _textFactory,
     "file" : _textFactory,
     "text" : _textFactory,
+    "binary" : _binaryFactory,
 }
 
 def addStatVisitor(url):
@@ -158,6 +174,16 @@ def initSimStats():
     _m5.stats.initSimStats()
     _m5.stats.registerPythonStatsHandlers()
 
+server_path = None
+def startServer(path):
+    '''Serve live stats snapshots on a Unix domain socket. The server
+    starts once the statistics package is enabled.'''
+
+    global server_path
+    server_path = path
+    if _m5.stats.enabled():
+        _m5.stats.startStatsServer(path)
+
 names = []
 stats_dict = {}
 stats_list = []
@@ -182,14 +208,17 @@ def enable():
         stats_dict[stat.name] = stat
         stat.enable()
 
+    _m5.stats.setDumpOrder(stats_list)
     _m5.stats.enable();
 
+    if server_path:
+        _m5.stats.startStatsServer(server_path)
+
 def prepare():
     '''Prepare all stats for data access.  This must be done before
     dumping and serialization.'''
 
-    for stat in stats_list:
-        stat.prepare()
+    _m5.stats.prepareAll()
 
 lastDump = 0
 def dump():
@@ -210,8 +239,7 @@ def dump():
     for output in outputList:
         if output.valid():
             output.begin()
-            for stat in stats_list:
-                stat.visit(output)
+            _m5.stats.visitAll(output)
             output.end()
 
 def reset():
@@ -0,0 +1,317 @@
+# Copyright (c) 2019 Georgia Institute of Technology
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""Reader for the binary stats written by binary:// stat visitors.
+
+The file starts with the magic "gem5sts1", followed by records:
+
+    uint8  type        'S' schema or 'D' dump
+    uint8  flags       bit 0: payload compressed with zlib
+    uint16 padding
+    uint32 stored size of the payload
+    uint32 uncompressed size of the payload
+    payload
+
+The schema comes once, ahead of the first dump:
+
+    uint32 stats, uint32 fixed values, uint32 variable stats
+    for every stat:
+        uint8 kind, uint8 padding, uint16 flags, int32 precision,
+        uint32 offset, uint32 count, string name, string desc
+        vector, formula: strings subnames, strings subdescs
+        vector dist:     uint32 size, strings subnames, strings subdescs
+        2d vector:       uint32 x, uint32 y, strings subnames,
+                         strings subdescs, strings y_subnames
+
+where a string is a uint32 length and its bytes, and strings are a
+uint32 count and that many strings. Stats with a count hold that many
+values at offset in the fixed part of every dump, the others are
+variable and offset is their index among the variable stats.
+
+A dump is the uint64 tick, the fixed values (doubles), then for every
+variable stat a uint32 count and that many doubles. A distribution is
+type, min, max, bucket_size, min_val, max_val, underflow, overflow, sum,
+squares, logs, samples, the number of buckets and the buckets; a vector
+of distributions is its distributions one after the other. A sparse
+histogram is the number of samples and then value, count pairs.
+
+This module only depends on the Python standard library, so it can
+also be run outside gem5:
+
+    python src/python/m5/stats/binary.py m5out/stats.bin --list
+    python src/python/m5/stats/binary.py m5out/stats.bin \\
+        --stat system.cpu.ipc --stat sim_insts
+"""
+
+from __future__ import print_function
+
+import struct
+import zlib
+
+MAGIC = b"gem5sts1"
+RECORD = "=BBHII"
+COMPRESSED = 0x1
+
+KINDS = [ "scalar", "vector", "dist", "vector_dist", "vector2d",
+          "formula", "sparse_hist" ]
+DIST_FIELDS = [ "type", "min", "max", "bucket_size", "min_val", "max_val",
+                "underflow", "overflow", "sum", "squares", "logs",
+                "samples" ]
+
+class StatsError(Exception):
+    pass
+
+class _Buffer(object):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def unpack(self, fmt):
+        size = struct.calcsize(fmt)
+        if self.pos + size > len(self.data):
+            raise StatsError("truncated stats record")
+        values = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += size
+        return values
+
+    def string(self):
+        length, = self.unpack("=I")
+        data = self.data[self.pos:self.pos + length]
+        self.pos += length
+        return data.decode("utf-8", "replace")
+
+    def strings(self):
+        count, = self.unpack("=I")
+        return [ self.string() for i in range(count) ]
+
+class Stat(object):
+    """Name, kind and shape of a stat in the schema"""
+
+    def __init__(self, buf):
+        (kind, pad, self.flags, self.precision, self.offset,
+         self.count) = buf.unpack("=BBHiII")
+        self.kind = KINDS[kind]
+        self.name = buf.string()
+        self.desc = buf.string()
+        self.subnames = []
+        self.subdescs = []
+        self.size = self.count
+        if self.kind in ("vector", "formula"):
+            self.subnames = buf.strings()
+            self.subdescs = buf.strings()
+        elif self.kind == "vector_dist":
+            self.size, = buf.unpack("=I")
+            self.subnames = buf.strings()
+            self.subdescs = buf.strings()
+        elif self.kind == "vector2d":
+            self.x, self.y = buf.unpack("=II")
+            self.subnames = buf.strings()
+            self.subdescs = buf.strings()
+            self.y_subnames = buf.strings()
+
+    @property
+    def fixed(self):
+        return self.count > 0
+
+    def __repr__(self):
+        return "Stat(%s, %s)" % (self.name, self.kind)
+
+def _decode_dists(values):
+    dists = []
+    pos = 0
+    while pos < len(values):
+        dist = dict(zip(DIST_FIELDS, values[pos:pos + len(DIST_FIELDS)]))
+        pos += len(DIST_FIELDS)
+        buckets = int(values[pos])
+        dist["buckets"] = list(values[pos + 1:pos + 1 + buckets])
+        pos += 1 + buckets
+        dists.append(dist)
+    return dists
+
+def _decode(stat, values):
+    if stat.kind == "scalar":
+        return values[0]
+    if stat.kind == "dist":
+        return _decode_dists(values)[0]
+    if stat.kind == "vector_dist":
+        return _decode_dists(values)
+    if stat.kind == "sparse_hist":
+        return { "samples" : values[0],
+                 "buckets" : list(zip(values[1::2], values[2::2])) }
+    return list(values)
+
+class StatsFile(object):
+    """A binary stats file. stats lists the stats of the schema, ticks
+    the tick of every dump."""
+
+    def __init__(self, filename):
+        self.file = open(filename, "rb")
+        if self.file.read(len(MAGIC)) != MAGIC:
+            raise StatsError("%s is not a binary stats file" % filename)
+
+        self.stats = []
+        self.by_name = {}
+        self.ticks = []
+        # (file offset of the payload, flags, stored size) per dump
+        self._dumps = []
+        self._cache = (None, None)
+
+        while True:
+            head = self.file.read(struct.calcsize(RECORD))
+            if not head:
+                break
+            if len(head) != struct.calcsize(RECORD):
+                raise StatsError("truncated stats file")
+            kind, flags, pad, stored, size = struct.unpack(RECORD, head)
+            offset = self.file.tell()
+            if kind == ord("S"):
+                self._read_schema(self._payload(offset, flags, stored))
+            elif kind == ord("D"):
+                data = self.file.read(min(stored, 8))
+                if flags & COMPRESSED:
+                    data = self._payload(offset, flags, stored)
+                if len(data) < 8:
+                    raise StatsError("truncated stats file")
+                self.ticks.append(struct.unpack_from("=Q", data)[0])
+                self._dumps.append((offset, flags, stored))
+            else:
+                raise StatsError("unknown record type %d" % kind)
+            self.file.seek(offset + stored)
+
+    def _payload(self, offset, flags, stored):
+        self.file.seek(offset)
+        data = self.file.read(stored)
+        if len(data) != stored:
+            raise StatsError("truncated stats file")
+        if flags & COMPRESSED:
+            data = zlib.decompress(data)
+        return data
+
+    def _read_schema(self, data):
+        buf = _Buffer(data)
+        count, self.fixed_values, self.variable_stats = buf.unpack("=III")
+        self.stats = [ Stat(buf) for i in range(count) ]
+        self.by_name = dict((s.name, s) for s in self.stats)
+        self.variable = [ s for s in self.stats if not s.fixed ]
+
+    def _dump(self, index):
+        if self._cache[0] != index:
+            self._cache = (index, self._payload(*self._dumps[index]))
+        return self._cache[1]
+
+    def stat(self, name):
+        try:
+            return self.by_name[name]
+        except KeyError:
+            raise StatsError("no stat named %s" % name)
+
+    def _raw(self, stat, index):
+        offset, flags, stored = self._dumps[index]
+        if stat.fixed and not flags & COMPRESSED:
+            # Uncompressed fixed values can be read in place
+            self.file.seek(offset + 8 + 8 * stat.offset)
+            data = self.file.read(8 * stat.count)
+            return struct.unpack("=%dd" % stat.count, data)
+
+        data = self._dump(index)
+        if stat.fixed:
+            return struct.unpack_from("=%dd" % stat.count, data,
+                                      8 + 8 * stat.offset)
+
+        pos = 8 + 8 * self.fixed_values
+        for var in self.variable:
+            count, = struct.unpack_from("=I", data, pos)
+            pos += 4
+            if var is stat:
+                return struct.unpack_from("=%dd" % count, data, pos)
+            pos += 8 * count
+        raise StatsError("stat %s is missing from dump %d" %
+                         (stat.name, index))
+
+    def value(self, name, index=-1):
+        """Value of a stat in a dump, the last one by default. Scalars are
+        numbers, vectors lists, distributions dicts."""
+        if not self._dumps:
+            raise StatsError("no dumps")
+        if index < 0:
+            index += len(self._dumps)
+        stat = self.stat(name)
+        return _decode(stat, self._raw(stat, index))
+
+    def series(self, name):
+        """Values of a stat in every dump"""
+        return [ self.value(name, i) for i in range(len(self._dumps)) ]
+
+    def __len__(self):
+        return len(self._dumps)
+
+    def close(self):
+        self.file.close()
+
+def main():
+    from argparse import ArgumentParser
+
+    parser = ArgumentParser(description="Read binary gem5 stats")
+    parser.add_argument("stats", help="file written by a binary:// visitor")
+    parser.add_argument("--list", action="store_true",
+                        help="list the stats in the file")
+    parser.add_argument("--stat", action="append", default=[],
+                        help="print this stat for every dump as CSV")
+    args = parser.parse_args()
+
+    stats = StatsFile(args.stats)
+    if args.list:
+        for stat in stats.stats:
+            print("%-60s %-12s %s" % (stat.name, stat.kind, stat.desc))
+        return
+
+    if not args.stat:
+        print("%d stats, %d dumps" % (len(stats.stats), len(stats)))
+        return
+
+    columns = [ "tick" ]
+    for name in args.stat:
+        stat = stats.stat(name)
+        if stat.kind == "scalar":
+            columns.append(name)
+        elif stat.fixed:
+            for i in range(stat.count):
+                sub = stat.subnames[i] if i < len(stat.subnames) else ""
+                columns.append("%s::%s" % (name, sub or i))
+        else:
+            raise StatsError("%s is a %s, only fixed stats are printed" %
+                             (name, stat.kind))
+    print(",".join(columns))
+    for i, tick in enumerate(stats.ticks):
+        row = [ str(tick) ]
+        for name in args.stat:
+            value = stats.value(name, i)
+            row += [ repr(v) for v in
+                     (value if isinstance(value, list) else [ value ]) ]
+        print(",".join(row))
+
+if __name__ == "__main__":
+    main()
@@ -237,6 +237,7 @@ pybind_init_core(py::module &m_native)
     m_core
         .def("setLogLevel", &Logger::setLevel)
         .def("setOutputDir", &setOutputDir)
+        .def("flushOutput", &flushOutput)
         .def("doExitCleanup", &doExitCleanup)
 
         .def("disableAllListeners", &ListenSocket::disableAll)
@@ -45,12 +45,14 @@
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
 
+#include <iostream>
 #include <map>
 #include <vector>
 
 #include "base/debug.hh"
 #include "base/output.hh"
 #include "base/trace.hh"
+#include "base/trace_binary.hh"
 #include "sim/debug.hh"
 
 namespace py = pybind11;
@@ -70,6 +72,26 @@ output(const char *filename)
     Trace::setDebugLogger(new Trace::OstreamLogger(*file_stream->stream()));
 }
 
+static void
+outputBinary(const char *filename, size_t flight_records)
+{
+    OutputStream *file_stream = simout.find(filename);
+
+    if (!file_stream)
+        file_stream = simout.create(filename, true);
+
+    // Standard output cannot be reopened when gem5 aborts
+    std::string name;
+    if (file_stream->stream() != &std::cout &&
+        file_stream->stream() != &std::cerr) {
+        name = filename;
+    }
+
+    Trace::setDebugLogger(
+        new Trace::BinaryLogger(*file_stream->stream(), name,
+                                flight_records));
+}
+
 static void
 ignore(const char *expr)
 {
@@ -112,8 +134,10 @@ pybind_init_debug(py::module &m_native)
     py::module m_trace = m_native.def_submodule("trace");
     m_trace
         .def("output", &output)
+        .def("outputBinary", &outputBinary)
         .def("ignore", &ignore)
         .def("enable", &Trace::enable)
         .def("disable", &Trace::disable)
+        .def("notifyFork", []() { Trace::getDebugLogger()->notifyFork(); })
         ;
 }
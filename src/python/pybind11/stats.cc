@@ -45,9 +45,11 @@
 #include "pybind11/stl.h"
 
 #include "base/statistics.hh"
+#include "base/stats/binary.hh"
 #include "base/stats/text.hh"
 #include "sim/stat_control.hh"
 #include "sim/stat_register.hh"
+#include "sim/stats_server.hh"
 
 namespace py = pybind11;
 
@@ -67,6 +69,33 @@ pythonReset()
     m.attr("reset")();
 }
 
+/**
+ * The stats in the order m5.stats dumps them. Preparing and visiting
+ * them from here rather than one call from Python per stat keeps
+ * frequent periodic dumps cheap.
+ */
+std::vector<Info *> dumpOrder;
+
+void
+setDumpOrder(const std::vector<Info *> &order)
+{
+    dumpOrder = order;
+}
+
+void
+prepareAll()
+{
+    for (auto info : dumpOrder)
+        info->prepare();
+}
+
+void
+visitAll(Output &output)
+{
+    for (auto info : dumpOrder)
+        info->visit(output);
+}
+
 }
 
 void
@@ -77,16 +106,22 @@ pybind_init_stats(py::module &m_native)
     m
         .def("initSimStats", &Stats::initSimStats)
         .def("initText", &Stats::initText, py::return_value_policy::reference)
+        .def("initBinary", &Stats::initBinary,
+             py::return_value_policy::reference)
         .def("registerPythonStatsHandlers",
              &Stats::registerPythonStatsHandlers)
         .def("schedStatEvent", &Stats::schedStatEvent)
         .def("periodicStatDump", &Stats::periodicStatDump)
         .def("updateEvents", &Stats::updateEvents)
+        .def("startStatsServer", &Stats::startStatsServer)
         .def("processResetQueue", &Stats::processResetQueue)
         .def("processDumpQueue", &Stats::processDumpQueue)
         .def("enable", &Stats::enable)
         .def("enabled", &Stats::enabled)
         .def("statsList", &Stats::statsList)
+        .def("setDumpOrder", &Stats::setDumpOrder)
+        .def("prepareAll", &Stats::prepareAll)
+        .def("visitAll", &Stats::visitAll)
         ;
 
     py::class_<Stats::Output>(m, "Output")
@@ -67,6 +67,12 @@ class Root(SimObject):
     # Simulation Quantum for multiple main event queue simulation.
     # Needs to be set explicitly for a multi-eventq simulation.
     sim_quantum = Param.Tick(0, "simulation quantum")
+    # With adaptive synchronization the quantum is the lookahead, i.e.
+    # the minimum latency of any interaction between event queues, and
+    # windows start at the earliest pending event so idle stretches
+    # need no barriers. Deterministic, like the fixed quantum.
+    sim_quantum_adaptive = Param.Bool(False,
+        "synchronize in adaptive windows of sim_quantum lookahead")
 
     full_system = Param.Bool("if this is a full system simulation")
 
@@ -51,6 +51,8 @@ from m5.objects.SimpleMemory import *
 class MemoryMode(Enum): vals = ['invalid', 'atomic', 'timing',
                                 'atomic_noncaching']
 
+class MemImageFormat(Enum): vals = ['gzip', 'chunked', 'sparse']
+
 class System(MemObject):
     type = 'System'
     cxx_header = "sim/system.hh"
@@ -76,6 +78,18 @@ class System(MemObject):
     mmap_using_noreserve = Param.Bool(False, "mmap the backing store " \
                                           "without reserving swap")
 
+    # Layout of the backing store images in checkpoints. gzip is a single
+    # compressed stream, chunked is compressed and decompressed by several
+    # host threads, and sparse is stored uncompressed with holes and mapped
+    # copy-on-write on restore (the checkpoint must then stay in place for
+    # the whole simulation). Checkpoints of any layout can be restored.
+    checkpoint_mem_format = Param.MemImageFormat('gzip',
+        "Layout of the memory images written to checkpoints")
+    checkpoint_mem_threads = Param.Unsigned(0, "Host threads used to "
+        "write and read chunked or sparse memory images (0: one per core)")
+    checkpoint_mem_chunk = Param.MemorySize('4MB', "Chunk size of chunked "
+        "and sparse memory images")
+
     # The memory ranges are to be populated when creating the system
     # such that these can be passed from the I/O subsystem through an
     # I/O bridge or cache
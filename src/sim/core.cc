@@ -40,6 +40,7 @@
 #include "base/cprintf.hh"
 #include "base/logging.hh"
 #include "base/output.hh"
+#include "base/trace.hh"
 #include "sim/eventq.hh"
 
 using namespace std;
@@ -126,6 +127,13 @@ setOutputDir(const string &dir)
     simout.setDirectory(dir);
 }
 
+void
+flushOutput()
+{
+    Trace::getDebugLogger()->flush();
+    simout.flush();
+}
+
 /**
  * Queue of C++ callbacks to invoke on simulator exit.
  */
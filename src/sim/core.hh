@@ -100,6 +100,9 @@ Tick getClockFrequency(); // Ticks per second.
 
 void setOutputDir(const std::string &dir);
 
+/** Write out buffered debug output and output file contents */
+void flushOutput();
+
 class Callback;
 void registerExitCallback(Callback *callback);
 void doExitCleanup();
@@ -699,10 +699,8 @@ CxxConfigManager::setParam(const std::string &object_name,
         throw Exception(object_name, csprintf("Bad parameter value:"
             " .%s=X=\"%s\"", param_name, param_value));
     } else {
-        std::string instance_name = rename(object_name);
-
         DPRINTF(CxxConfig, "Setting parameter %s.%s=%s\n",
-            instance_name, param_name, param_value);
+            rename(object_name), param_name, param_value);
     }
 }
 
@@ -717,10 +715,8 @@ CxxConfigManager::setParamVector(const std::string &object_name,
         throw Exception(object_name, csprintf("Bad vector parameter value:"
             " .%s=X=\"%s\"", param_name, formatParamList(param_values)));
     } else {
-        std::string instance_name = rename(object_name);
-
         DPRINTF(CxxConfig, "Setting parameter %s.%s=\"%s\"\n",
-            instance_name, param_name, formatParamList(param_values));
+            rename(object_name), param_name, formatParamList(param_values));
     }
 }
 
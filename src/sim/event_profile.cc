@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/event_profile.hh"
+
+#include <algorithm>
+#include <map>
+#include <ostream>
+
+#include "base/callback.hh"
+#include "base/cprintf.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "sim/core.hh"
+#include "sim/eventq.hh"
+
+using namespace std;
+
+double
+EventProfile::Entry::seconds() const
+{
+    if (!sampled)
+        return 0;
+    return chrono::duration<double>(time).count() * count / sampled;
+}
+
+EventProfile::EventProfile(unsigned sample_period)
+    : samplePeriod(sample_period), untilSample(1),
+      rngState(0x9e3779b97f4a7c15ULL), maxPerTick(0), lastTick(MaxTick),
+      tickEvents(0)
+{
+    fatal_if(samplePeriod == 0, "The event profile sample period must "
+             "be at least 1.\n");
+}
+
+void
+EventProfile::process(Event *event)
+{
+    Entry *entry = lookup(event);
+    ++entry->count;
+
+    if (--untilSample) {
+        event->process();
+        return;
+    }
+
+    // Pick the next timed event uniformly within twice the period,
+    // which avoids aliasing with periodic event patterns.
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 7;
+    rngState ^= rngState << 17;
+    untilSample = 1 + rngState % (2 * samplePeriod - 1);
+
+    Clock::time_point start = Clock::now();
+    event->process();
+    entry->time += Clock::now() - start;
+    ++entry->sampled;
+}
+
+EventProfile::Entry *
+EventProfile::lookup(const Event *event)
+{
+    if (event->when() != lastTick) {
+        endTick();
+        lastTick = event->when();
+    }
+    ++tickEvents;
+
+    const char *desc = event->description();
+    const void *owner = event->nameOwner();
+    // The description guards against a deleted event's or owner's
+    // address being reused by an event of another kind.
+    if (!event->isAutoDelete()) {
+        auto it = known.find(event);
+        if (it != known.end() && it->second->description == desc)
+            return it->second;
+    } else if (owner) {
+        auto it = owners.find(owner);
+        if (it != owners.end() && it->second->description == desc)
+            return it->second;
+    } else {
+        auto it = unnamed.find(desc);
+        if (it != unnamed.end())
+            return it->second;
+    }
+
+    // Events that do not override Event::name() get a name unique to
+    // the instance, which would make an entry per event
+    string name = event->name();
+    bool is_unnamed = !owner && name.compare(0, 6, "Event_") == 0;
+    if (is_unnamed)
+        name = "unnamed";
+
+    string key = name + '\t' + desc;
+    auto it = entries.find(key);
+    if (it == entries.end()) {
+        Entry entry = { name, desc, 0, 0, Clock::duration::zero() };
+        it = entries.emplace(key, entry).first;
+    }
+
+    if (!event->isAutoDelete())
+        known[event] = &it->second;
+    else if (owner)
+        owners[owner] = &it->second;
+    else if (is_unnamed)
+        unnamed[desc] = &it->second;
+
+    return &it->second;
+}
+
+void
+EventProfile::endTick()
+{
+    if (!tickEvents)
+        return;
+
+    unsigned bucket = floorLog2(tickEvents);
+    if (perTick.size() <= bucket)
+        perTick.resize(bucket + 1, 0);
+    ++perTick[bucket];
+    maxPerTick = max(maxPerTick, tickEvents);
+    tickEvents = 0;
+}
+
+namespace {
+
+struct Total
+{
+    Counter count;
+    double seconds;
+};
+
+typedef vector<pair<string, Total>> Table;
+
+Table
+sorted(const map<string, Total> &totals)
+{
+    Table table(totals.begin(), totals.end());
+    sort(table.begin(), table.end(),
+         [](const Table::value_type &a, const Table::value_type &b) {
+             return a.second.seconds > b.second.seconds;
+         });
+    return table;
+}
+
+void
+printTable(ostream &os, const char *title, const Table &table,
+           double seconds)
+{
+    ccprintf(os, "\n%s\n", title);
+    ccprintf(os, "%7s %12s %14s %10s  %s\n",
+             "%time", "seconds", "events", "ns/event", "name");
+    for (const auto &row : table) {
+        const Total &total = row.second;
+        ccprintf(os, "%7.2f %12.6f %14d %10.1f  %s\n",
+                 seconds > 0 ? 100 * total.seconds / seconds : 0,
+                 total.seconds, total.count,
+                 total.count ? 1e9 * total.seconds / total.count : 0,
+                 row.first);
+    }
+}
+
+/** A frame of a folded stack; ';' separates frames. */
+string
+frame(const string &name)
+{
+    string f(name);
+    replace(f.begin(), f.end(), ';', ':');
+    return f;
+}
+
+} // anonymous namespace
+
+void
+EventProfile::dump(const string &base)
+{
+    map<string, Total> byName, byDesc, byEvent;
+    vector<Counter> perTick;
+    Counter events = 0, ticks = 0, max_per_tick = 0;
+    double seconds = 0;
+    unsigned sample_period = 1;
+
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        EventProfile *profile = mainEventQueue[i]->profile();
+        if (!profile)
+            continue;
+
+        profile->endTick();
+        sample_period = profile->samplePeriod;
+        for (const auto &item : profile->entries) {
+            const Entry &entry = item.second;
+            double s = entry.seconds();
+            for (auto *total : { &byName[entry.name],
+                                 &byDesc[entry.description],
+                                 &byEvent[item.first] }) {
+                total->count += entry.count;
+                total->seconds += s;
+            }
+            events += entry.count;
+            seconds += s;
+        }
+
+        if (perTick.size() < profile->perTick.size())
+            perTick.resize(profile->perTick.size(), 0);
+        for (int b = 0; b < profile->perTick.size(); ++b) {
+            perTick[b] += profile->perTick[b];
+            ticks += profile->perTick[b];
+        }
+        max_per_tick = max(max_per_tick, profile->maxPerTick);
+    }
+
+    OutputStream *txt = simout.create(base + ".txt");
+    ostream &os = *txt->stream();
+    ccprintf(os, "# Host time spent in event handlers\n");
+    ccprintf(os, "# events %d, estimated handler time %.6f s, "
+             "event queues %d, one in %d events timed\n",
+             events, seconds, numMainEventQueues, sample_period);
+    ccprintf(os, "# simulated ticks with events %d, events per tick: "
+             "mean %.2f, max %d\n", ticks,
+             ticks ? (double)events / ticks : 0, max_per_tick);
+
+    printTable(os, "By event description:", sorted(byDesc), seconds);
+    printTable(os, "By event name:", sorted(byName), seconds);
+
+    ccprintf(os, "\nEvents per simulated tick:\n");
+    ccprintf(os, "%21s %14s\n", "events", "ticks");
+    for (int b = 0; b < perTick.size(); ++b) {
+        ccprintf(os, "%9d-%-11d %14d\n",
+                 (Counter)1 << b, ((Counter)2 << b) - 1, perTick[b]);
+    }
+    simout.close(txt);
+
+    // Folded stacks: the SimObject path of the event's name, with the
+    // description as the leaf frame, weighted by nanoseconds.
+    OutputStream *folded = simout.create(base + ".folded");
+    ostream &fs = *folded->stream();
+    for (const auto &row : byEvent) {
+        const string &key = row.first;
+        size_t tab = key.find('\t');
+        string stack = frame(key.substr(0, tab));
+        replace(stack.begin(), stack.end(), '.', ';');
+        ccprintf(fs, "%s;%s %d\n", stack, frame(key.substr(tab + 1)),
+                 (uint64_t)(row.second.seconds * 1e9));
+    }
+    simout.close(folded);
+}
+
+namespace {
+
+class ProfileDump : public Callback
+{
+  private:
+    string base;
+
+  public:
+    ProfileDump(const string &_base) : base(_base) {}
+    void process() override { EventProfile::dump(base); }
+};
+
+} // anonymous namespace
+
+void
+enableEventProfiling(const string &base, unsigned sample_period)
+{
+    static bool enabled = false;
+    if (enabled) {
+        warn("Event profiling is already enabled.\n");
+        return;
+    }
+    enabled = true;
+
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        EventQueue *eq = mainEventQueue[i];
+        if (!eq->profile())
+            eq->profile(new EventProfile(sample_period));
+    }
+
+    registerExitCallback(new ProfileDump(base));
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Host-time profiling of event handlers.
+ *
+ * When enabled, every event queue counts the events it services by
+ * event name, which for most events identifies the owning SimObject,
+ * and by event description, and records how many events are serviced
+ * per simulated tick. Events without a name of their own are
+ * accounted by description only. The host time spent in process() is
+ * measured for a random sample of the events, one in every
+ * samplePeriod on average, since reading the host clock costs about
+ * as much as a small event handler. Each name's time is then
+ * estimated from its exact count and its sampled mean. The profile is
+ * written at exit as a flat text profile and as folded stacks that
+ * flamegraph tools accept, with the SimObject hierarchy as the call
+ * stack.
+ */
+
+#ifndef __SIM_EVENT_PROFILE_HH__
+#define __SIM_EVENT_PROFILE_HH__
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/types.hh"
+
+class Event;
+
+class EventProfile
+{
+  public:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Entry
+    {
+        std::string name;
+        const char *description;
+        Counter count;
+        /** Events of this entry that were timed, and their time. */
+        Counter sampled;
+        Clock::duration time;
+
+        /** Estimated host seconds spent in all events of the entry. */
+        double seconds() const;
+    };
+
+    EventProfile(unsigned sample_period);
+
+    /** Process an event, accounting for it in the profile. */
+    void process(Event *event);
+
+    /** Write the merged profile of all event queues. */
+    static void dump(const std::string &base);
+
+  private:
+    /**
+     * Find the entry an event is accounted to. This is done before the
+     * event is processed, since its handler may delete it.
+     */
+    Entry *lookup(const Event *event);
+
+    /** Average number of events between two timed ones. */
+    const unsigned samplePeriod;
+    /** Events left until the next timed one. */
+    unsigned untilSample;
+    /** xorshift state for choosing the sampled events. */
+    uint64_t rngState;
+
+    /** Aggregated entries, keyed by name and description. */
+    std::unordered_map<std::string, Entry> entries;
+
+    /**
+     * Entries of events that are not deleted after being processed,
+     * so that the name of long-lived events is only built once.
+     */
+    std::unordered_map<const Event *, Entry *> known;
+
+    /**
+     * Entries of short-lived events by the object their name is
+     * derived from (see Event::nameOwner()), and by description for
+     * events without a name of their own.
+     */
+    std::unordered_map<const void *, Entry *> owners;
+    std::unordered_map<const char *, Entry *> unnamed;
+
+    /** Events serviced per simulated tick, in power-of-two buckets. */
+    std::vector<Counter> perTick;
+    Counter maxPerTick;
+    Tick lastTick;
+    Counter tickEvents;
+
+    void endTick();
+};
+
+/**
+ * Start profiling all main event queues. The profile is written to
+ * base.txt and base.folded in the output directory at exit.
+ * @param sample_period Average number of events per timed event; 1
+ * times every event.
+ */
+void enableEventProfiling(const std::string &base,
+                          unsigned sample_period);
+
+#endif // __SIM_EVENT_PROFILE_HH__
@@ -43,11 +43,13 @@
 #include "cpu/smt.hh"
 #include "debug/Checkpoint.hh"
 #include "sim/core.hh"
+#include "sim/event_profile.hh"
 #include "sim/eventq_impl.hh"
 
 using namespace std;
 
 Tick simQuantum = 0;
+bool simAdaptiveQuantum = false;
 
 //
 // Main Event Queues
@@ -225,7 +227,12 @@ EventQueue::serviceOne()
         // forward current cycle to the time when this event occurs.
         setCurTick(event->when());
 
-        event->process();
+        if (_profile) {
+            _profile->process(event);
+        } else {
+            event->process();
+        }
+
         if (event->isExitEvent()) {
             assert(!event->flags.isSet(Event::Managed) ||
                    !event->flags.isSet(Event::IsMainQueue)); // would be silly
@@ -414,28 +421,78 @@ Event::dump() const
 }
 
 EventQueue::EventQueue(const string &n)
-    : objName(n), head(NULL), _curTick(0)
+    : objName(n), head(NULL), _curTick(0), asyncHead(nullptr),
+      asyncReceived(0), asyncBatches(0), asyncMaxBatch(0),
+      barrierWaitTime(0), _profile(NULL)
 {
 }
 
 void
 EventQueue::asyncInsert(Event *event)
 {
-    async_queue_mutex.lock();
-    async_queue.push_back(event);
-    async_queue_mutex.unlock();
+    Event *top = asyncHead.load(std::memory_order_relaxed);
+    do {
+        event->nextBin = top;
+    } while (!asyncHead.compare_exchange_weak(top, event,
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
 }
 
 void
 EventQueue::handleAsyncInsertions()
 {
     assert(this == curEventQueue());
-    async_queue_mutex.lock();
 
-    while (!async_queue.empty()) {
-        insert(async_queue.front());
-        async_queue.pop_front();
+    // Avoid the read-modify-write when nothing has been added, which
+    // is the common case at most quantum boundaries
+    if (!asyncHead.load(std::memory_order_relaxed))
+        return;
+
+    Event *stack = asyncHead.exchange(nullptr, std::memory_order_acquire);
+
+    // The stack holds the most recent event first. Reverse it so that
+    // events are inserted in the order they were scheduled, which
+    // global events rely on to keep a total order (see
+    // BaseGlobalEvent::schedule()).
+    Event *pending = nullptr;
+    Counter batch = 0;
+    while (stack) {
+        Event *next = stack->nextBin;
+        stack->nextBin = pending;
+        pending = stack;
+        stack = next;
+        ++batch;
+    }
+
+    while (pending) {
+        Event *next = pending->nextBin;
+        insert(pending);
+        pending = next;
+    }
+
+    asyncReceived += batch;
+    ++asyncBatches;
+    asyncMaxBatch = std::max(asyncMaxBatch, batch);
+}
+
+Tick
+EventQueue::nextPendingTick() const
+{
+    Tick next = empty() ? MaxTick : nextTick();
+
+    for (Event *event = asyncHead.load(std::memory_order_acquire); event;
+         event = event->nextBin) {
+        next = std::min(next, event->when());
     }
 
-    async_queue_mutex.unlock();
+    return next;
+}
+
+void
+EventQueue::resetAsyncStats()
+{
+    asyncReceived = 0;
+    asyncBatches = 0;
+    asyncMaxBatch = 0;
+    barrierWaitTime = 0;
 }
@@ -39,6 +39,7 @@
 #define __SIM_EVENTQ_HH__
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <climits>
 #include <functional>
@@ -54,6 +55,7 @@
 
 class EventQueue;       // forward declaration
 class BaseGlobalEvent;
+class EventProfile;
 
 //! Simulation Quantum for multiple eventq simulation.
 //! The quantum value is the period length after which the queues
@@ -62,6 +64,12 @@ class BaseGlobalEvent;
 //! Queue B should be at least simQuantum ticks away in future.
 extern Tick simQuantum;
 
+//! Synchronize multiple eventqs in adaptive time windows rather than
+//! every simQuantum. A window then starts at the earliest pending
+//! event of any queue and lasts simQuantum, which acts as the
+//! lookahead (the minimum latency between queues).
+extern bool simAdaptiveQuantum;
+
 //! Current number of allocated main event queues.
 extern uint32_t numMainEventQueues;
 
@@ -360,6 +368,12 @@ class Event : public EventBase, public Serializable
     virtual ~Event();
     virtual const std::string name() const;
 
+    /// Return the object the name of the event is derived from, if
+    /// any. Events of the same owner and description have the same
+    /// name, which lets the event profiler avoid building the name of
+    /// every short-lived event.
+    virtual const void *nameOwner() const { return nullptr; }
+
     /// Return a C string describing the event.  This string should
     /// *not* be dynamically allocated; just a const char array
     /// describing the event class.
@@ -482,7 +496,7 @@ operator!=(const Event &l, const Event &r)
  * schedule() method with the 'global' parameter set to true. Unlike
  * the previous queue migration strategy, this strategy is fully
  * deterministic. This causes the event to be inserted in a separate
- * queue of asynchronous events (async_queue), which is merged main
+ * lock-free inbox of asynchronous events, which is merged into the main
  * event queue at the end of each simulation quantum (by calling the
  * handleAsyncInsertions() method). Note that this implies that such
  * events must happen at least one simulation quantum into the future,
@@ -496,11 +510,28 @@ class EventQueue
     Event *head;
     Tick _curTick;
 
-    //! Mutex to protect async queue.
-    std::mutex async_queue_mutex;
+    /**
+     * Events added by other threads to this event queue.
+     *
+     * This is a lock-free multi-producer, single-consumer stack
+     * linked through Event::nextBin, which is unused until the event
+     * is inserted into the main queue. Producers push with a CAS, the
+     * owning thread takes the whole stack with a single exchange and
+     * reverses it to restore the insertion order.
+     */
+    std::atomic<Event *> asyncHead;
 
-    //! List of events added by other threads to this event queue.
-    std::list<Event*> async_queue;
+    /**
+     * Cross-queue traffic and synchronization counters, only updated
+     * by the thread owning the queue.
+     */
+    Counter asyncReceived;
+    Counter asyncBatches;
+    Counter asyncMaxBatch;
+    double barrierWaitTime;
+
+    /** Host-time profile of serviced events, NULL when not profiling. */
+    EventProfile *_profile;
 
     /**
      * Lock protecting event handling.
@@ -623,6 +654,13 @@ class EventQueue
     void reschedule(Event *event, Tick when, bool always = false);
 
     Tick nextTick() const { return head->when(); }
+
+    /**
+     * Earliest tick of any event on the queue, including the events
+     * waiting in the async inbox. Only safe to call while all threads
+     * are stopped, e.g. from a global event.
+     */
+    Tick nextPendingTick() const;
     void setCurTick(Tick newVal) { _curTick = newVal; }
     Tick getCurTick() const { return _curTick; }
     Event *getHead() const { return head; }
@@ -657,9 +695,27 @@ class EventQueue
 
     bool debugVerify() const;
 
-    //! Function for moving events from the async_queue to the main queue.
+    //! Function for moving events from the async queue to the main queue.
     void handleAsyncInsertions();
 
+    /**@{*/
+    /**
+     * Statistics on events received from other threads and on the
+     * host time the owning thread spent waiting on global barriers.
+     *
+     * @see Root::regStats()
+     */
+    Counter asyncInsertions() const { return asyncReceived; }
+    Counter asyncDrains() const { return asyncBatches; }
+    Counter asyncLargestDrain() const { return asyncMaxBatch; }
+    double barrierWait() const { return barrierWaitTime; }
+    void addBarrierWait(double seconds) { barrierWaitTime += seconds; }
+    void resetAsyncStats();
+    /**@}*/
+
+    EventProfile *profile() const { return _profile; }
+    void profile(EventProfile *p) { _profile = p; }
+
     /**
      *  Function to signal that the event loop should be woken up because
      *  an event has been scheduled by an agent outside the gem5 event
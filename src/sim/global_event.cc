@@ -155,10 +155,23 @@ void
 GlobalSyncEvent::process()
 {
     if (repeat) {
-        schedule(curTick() + repeat);
+        schedule(adaptive ? nextWindow() : curTick() + repeat);
     }
 }
 
+Tick
+GlobalSyncEvent::nextWindow() const
+{
+    // Called by the one thread processing the event while all others
+    // wait on the barrier, so every queue can be inspected
+    Tick earliest = MaxTick;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        earliest = std::min(earliest, mainEventQueue[i]->nextPendingTick());
+
+    Tick start = std::max(curTick(), earliest);
+    return start < MaxTick - repeat ? start + repeat : MaxTick;
+}
+
 const char *
 GlobalSyncEvent::description() const
 {
@@ -32,6 +32,7 @@
 #ifndef __SIM_GLOBAL_EVENT_HH__
 #define __SIM_GLOBAL_EVENT_HH__
 
+#include <chrono>
 #include <mutex>
 #include <vector>
 
@@ -99,8 +100,16 @@ class BaseGlobalEvent : public EventBase
             // locked when entering this method. We need to unlock it
             // while waiting on the barrier to prevent deadlocks if
             // another thread wants to lock the event queue.
-            EventQueue::ScopedRelease release(curEventQueue());
-            return _globalEvent->barrier.wait();
+            EventQueue *eq = curEventQueue();
+            EventQueue::ScopedRelease release(eq);
+
+            auto start = std::chrono::steady_clock::now();
+            bool last = _globalEvent->barrier.wait();
+            std::chrono::duration<double> waited =
+                std::chrono::steady_clock::now() - start;
+            eq->addBarrierWait(waited.count());
+
+            return last;
         }
 
       public:
@@ -219,11 +228,12 @@ class GlobalSyncEvent : public BaseGlobalEventTemplate<GlobalSyncEvent>
     };
 
     GlobalSyncEvent(Priority p, Flags f)
-        : Base(p, f), repeat(0)
+        : Base(p, f), repeat(0), adaptive(false)
     { }
 
-    GlobalSyncEvent(Tick when, Tick _repeat, Priority p, Flags f)
-        : Base(p, f), repeat(_repeat)
+    GlobalSyncEvent(Tick when, Tick _repeat, Priority p, Flags f,
+                    bool _adaptive = false)
+        : Base(p, f), repeat(_repeat), adaptive(_adaptive)
     {
         schedule(when);
     }
@@ -232,7 +242,18 @@ class GlobalSyncEvent : public BaseGlobalEventTemplate<GlobalSyncEvent>
 
     const char *description() const;
 
+    /**
+     * End of the next adaptive window. No queue has anything to do
+     * before its earliest pending event, and an event can only affect
+     * another queue repeat ticks later, so all queues can safely run
+     * until the earliest pending event plus repeat. This skips the
+     * synchronizations of idle stretches, and it only depends on
+     * simulated state, so it is deterministic.
+     */
+    Tick nextWindow() const;
+
     Tick repeat;
+    bool adaptive;
 };
 
 
@@ -58,6 +58,7 @@
 #include "base/atomicio.hh"
 #include "base/cprintf.hh"
 #include "base/logging.hh"
+#include "base/trace.hh"
 #include "sim/async.hh"
 #include "sim/backtrace.hh"
 #include "sim/core.hh"
@@ -153,6 +154,10 @@ abortHandler(int sigtype)
         STATIC_ERR("Program aborted\n\n");
     }
 
+    // Buffered trace output (e.g. a flight recorder) holds the events
+    // that led up to the panic
+    Trace::getDebugLogger()->flushFromSignal();
+
     print_backtrace();
     raiseFatalSignal(sigtype);
 }
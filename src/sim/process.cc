@@ -59,6 +59,7 @@
 #include "base/loader/object_file.hh"
 #include "base/loader/symtab.hh"
 #include "base/statistics.hh"
+#include "base/time.hh"
 #include "config/the_isa.hh"
 #include "cpu/thread_context.hh"
 #include "mem/page_table.hh"
@@ -104,6 +105,7 @@ using namespace TheISA;
 Process::Process(ProcessParams *params, EmulationPageTable *pTable,
                  ObjectFile *obj_file)
     : SimObject(params), system(params->system),
+      inSyscall(false),
       useArchPT(params->useArchPT),
       kvmInSE(params->kvmInSE),
       pTable(pTable),
@@ -257,6 +259,35 @@ Process::regStats()
         .name(name() + ".numSyscalls")
         .desc("Number of system calls")
         ;
+
+    syscallSeconds
+        .name(name() + ".syscallSeconds")
+        .desc("Host seconds spent emulating system calls")
+        ;
+
+    syscallMemSeconds
+        .name(name() + ".syscallMemSeconds")
+        .desc("Host seconds spent in functional memory accesses "
+              "made by system calls")
+        ;
+
+    syscallMemFraction
+        .name(name() + ".syscallMemFraction")
+        .desc("Fraction of system call time spent accessing memory")
+        .precision(6)
+        ;
+    syscallMemFraction = syscallMemSeconds / syscallSeconds;
+
+    syscallMemBytes
+        .name(name() + ".syscallMemBytes")
+        .desc("Bytes of guest memory accessed by system calls")
+        ;
+
+    syscallMemHostBytes
+        .name(name() + ".syscallMemHostBytes")
+        .desc("Bytes of syscall memory accesses served straight from "
+              "host memory")
+        ;
 }
 
 ThreadContext *
@@ -420,7 +451,16 @@ Process::syscall(int64_t callnum, ThreadContext *tc, Fault *fault)
     if (desc == nullptr)
         fatal("Syscall %d out of range", callnum);
 
+    Time start;
+    start.setTimer();
+
+    inSyscall = true;
     desc->doSyscall(callnum, this, tc, fault);
+    inSyscall = false;
+
+    Time end;
+    end.setTimer();
+    syscallSeconds += end - start;
 }
 
 RegVal
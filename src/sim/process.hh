@@ -172,6 +172,38 @@ class Process : public SimObject
 
     Stats::Scalar numSyscalls;  // track how many system calls are executed
 
+    /** @{ */
+    /**
+     * Breakdown of the host time spent emulating system calls: the
+     * total, and the part of it spent in functional accesses to guest
+     * memory (path names, I/O buffers, structures).
+     */
+    Stats::Scalar syscallSeconds;
+    Stats::Scalar syscallMemSeconds;
+    Stats::Formula syscallMemFraction;
+    Stats::Scalar syscallMemBytes;
+    Stats::Scalar syscallMemHostBytes;
+    /** @} */
+
+    /** True while a system call is being emulated. */
+    bool inSyscall;
+
+    /**
+     * Account a functional memory access made while emulating a
+     * system call.
+     *
+     * @param bytes Number of bytes accessed
+     * @param host_bytes Number of those served straight from host memory
+     * @param seconds Host time spent on the access
+     */
+    void
+    recordSyscallMemAccess(Addr bytes, Addr host_bytes, double seconds)
+    {
+        syscallMemBytes += bytes;
+        syscallMemHostBytes += host_bytes;
+        syscallMemSeconds += seconds;
+    }
+
     bool useArchPT; // flag for using architecture specific page table
     bool kvmInSE;   // running KVM requires special initialization
 
@@ -31,6 +31,7 @@
  *          Gabe Black
  */
 
+#include "base/callback.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "config/the_isa.hh"
@@ -116,6 +117,7 @@ Root::Root(RootParams *p)
     lastTime.setTimer();
 
     simQuantum = p->sim_quantum;
+    simAdaptiveQuantum = p->sim_quantum_adaptive;
 }
 
 void
@@ -124,6 +126,74 @@ Root::startup()
     timeSyncEnable(params()->time_sync_enable);
 }
 
+void
+Root::regStats()
+{
+    SimObject::regStats();
+
+    eventqAsyncInsertions
+        .init(numMainEventQueues)
+        .name(name() + ".eventq_async_insertions")
+        .desc("Events scheduled on the queue by other threads")
+        .flags(Stats::nozero)
+        ;
+
+    eventqAsyncDrains
+        .init(numMainEventQueues)
+        .name(name() + ".eventq_async_drains")
+        .desc("Batches of cross-thread events moved into the queue")
+        .flags(Stats::nozero)
+        ;
+
+    eventqLargestDrain
+        .init(numMainEventQueues)
+        .name(name() + ".eventq_largest_drain")
+        .desc("Largest batch of cross-thread events moved into the queue")
+        .flags(Stats::nozero)
+        ;
+
+    eventqBarrierWait
+        .init(numMainEventQueues)
+        .name(name() + ".eventq_barrier_wait")
+        .desc("Host seconds the queue's thread waited on global barriers")
+        .flags(Stats::nozero)
+        ;
+
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        const std::string &eq_name = mainEventQueue[i]->name();
+        eventqAsyncInsertions.subname(i, eq_name);
+        eventqAsyncDrains.subname(i, eq_name);
+        eventqLargestDrain.subname(i, eq_name);
+        eventqBarrierWait.subname(i, eq_name);
+    }
+
+    // The counters live in the event queues, where they are updated
+    // without synchronization by the owning thread
+    Stats::registerDumpCallback(
+        new MakeCallback<Root, &Root::updateEventqStats>(this, true));
+}
+
+void
+Root::updateEventqStats()
+{
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        const EventQueue *eq = mainEventQueue[i];
+        eventqAsyncInsertions[i] = eq->asyncInsertions();
+        eventqAsyncDrains[i] = eq->asyncDrains();
+        eventqLargestDrain[i] = eq->asyncLargestDrain();
+        eventqBarrierWait[i] = eq->barrierWait();
+    }
+}
+
+void
+Root::resetStats()
+{
+    SimObject::resetStats();
+
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->resetAsyncStats();
+}
+
 void
 Root::serialize(CheckpointOut &cp) const
 {
@@ -41,6 +41,7 @@
 #ifndef __SIM_ROOT_HH__
 #define __SIM_ROOT_HH__
 
+#include "base/statistics.hh"
 #include "base/time.hh"
 #include "params/Root.hh"
 #include "sim/eventq.hh"
@@ -62,6 +63,14 @@ class Root : public SimObject
     void timeSync();
     EventFunctionWrapper syncEvent;
 
+    /** Per event queue statistics for parallel simulation. */
+    Stats::Vector eventqAsyncInsertions;
+    Stats::Vector eventqAsyncDrains;
+    Stats::Vector eventqLargestDrain;
+    Stats::Vector eventqBarrierWait;
+
+    void updateEventqStats();
+
   public:
     /**
      * Use this function to get a pointer to the single Root object in the
@@ -107,6 +116,9 @@ class Root : public SimObject
      */
     void startup() override;
 
+    void regStats() override;
+    void resetStats() override;
+
     void serialize(CheckpointOut &cp) const override;
 };
 
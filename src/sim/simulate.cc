@@ -120,7 +120,8 @@ simulate(Tick num_cycles)
         }
 
         quantum_event = new GlobalSyncEvent(curTick() + simQuantum, simQuantum,
-                            EventBase::Progress_Event_Pri, 0);
+                            EventBase::Progress_Event_Pri, 0,
+                            simAdaptiveQuantum);
 
         inParallelMode = true;
     }
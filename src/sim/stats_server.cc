@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/stats_server.hh"
+
+#include <fnmatch.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+#include "base/callback.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "base/statistics.hh"
+#include "base/stats/text.hh"
+#include "base/str.hh"
+#include "debug/StatsServer.hh"
+#include "sim/core.hh"
+#include "sim/eventq.hh"
+#include "sim/global_event.hh"
+
+using namespace std;
+
+namespace Stats {
+
+namespace {
+
+StatsServer *server = NULL;
+
+/** Displayed stats whose names match any of the patterns, by name. */
+vector<Info *>
+matching(const vector<string> &patterns)
+{
+    vector<Info *> found;
+    for (auto *info : statsList()) {
+        if (!info->flags.isSet(display))
+            continue;
+        for (const auto &pattern : patterns) {
+            if (fnmatch(pattern.c_str(), info->name.c_str(), 0) == 0) {
+                found.push_back(info);
+                break;
+            }
+        }
+    }
+
+    sort(found.begin(), found.end(), [](const Info *a, const Info *b) {
+        return a->name < b->name;
+    });
+    return found;
+}
+
+/**
+ * Takes a snapshot for one client once all event queues have reached
+ * the same tick. Scheduled with simQuantum of slack for the same
+ * reason as the regular stat dump event.
+ */
+class SnapshotEvent : public GlobalEvent
+{
+  private:
+    StatsServer &server;
+    int client;
+    vector<string> patterns;
+
+  public:
+    SnapshotEvent(StatsServer &_server, int _client,
+                  const vector<string> &_patterns)
+        : GlobalEvent(curTick() + simQuantum, Stat_Event_Pri,
+                      Event::AutoDelete),
+          server(_server), client(_client), patterns(_patterns)
+    {
+    }
+
+    void
+    process() override
+    {
+        server.snapshot(client, patterns);
+    }
+
+    const char *description() const override
+    {
+        return "GlobalStatsSnapshotEvent";
+    }
+};
+
+} // anonymous namespace
+
+StatsServer::ListenEvent::ListenEvent(StatsServer *s, int fd, int e)
+    : PollEvent(fd, e), server(s)
+{
+}
+
+void
+StatsServer::ListenEvent::process(int revent)
+{
+    server->accept();
+}
+
+StatsServer::ClientEvent::ClientEvent(StatsServer *s, int _id, int fd, int e)
+    : PollEvent(fd, e), server(s), id(_id)
+{
+}
+
+void
+StatsServer::ClientEvent::process(int revent)
+{
+    if (revent & POLLIN)
+        server->data(id);
+    else if (revent & (POLLHUP | POLLERR | POLLNVAL))
+        server->detach(id);
+}
+
+StatsServer::StatsServer(const string &_path)
+    : path(_path), listen_fd(-1), listenEvent(NULL), nextId(0)
+{
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    fatal_if(path.size() >= sizeof(addr.sun_path),
+             "Stats server socket path '%s' is too long.\n", path);
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    panic_if(listen_fd < 0, "Can't create stats server socket: %s\n",
+             strerror(errno));
+
+    // A stale socket from an earlier run would make bind() fail.
+    ::unlink(path.c_str());
+
+    if (::bind(listen_fd, (sockaddr *)&addr, sizeof(addr)) < 0 ||
+        ::listen(listen_fd, 4) < 0) {
+        fatal("Can't listen for stats requests on %s: %s\n", path,
+              strerror(errno));
+    }
+
+    listenEvent = new ListenEvent(this, listen_fd, POLLIN);
+    pollQueue.schedule(listenEvent);
+
+    inform("Stats server listening on %s\n", path);
+}
+
+StatsServer::~StatsServer()
+{
+    close();
+}
+
+void
+StatsServer::close()
+{
+    while (!clients.empty())
+        detach(clients.begin()->first);
+
+    if (listenEvent) {
+        delete listenEvent;
+        listenEvent = NULL;
+    }
+
+    if (listen_fd != -1) {
+        ::close(listen_fd);
+        ::unlink(path.c_str());
+        listen_fd = -1;
+    }
+}
+
+void
+StatsServer::accept()
+{
+    int fd = ::accept(listen_fd, NULL, NULL);
+    if (fd < 0) {
+        warn("Stats server failed to accept a connection: %s\n",
+             strerror(errno));
+        return;
+    }
+
+    int id = nextId++;
+    Client &client = clients[id];
+    client.fd = fd;
+    client.event = new ClientEvent(this, id, fd, POLLIN);
+    pollQueue.schedule(client.event);
+
+    DPRINTF(StatsServer, "client %d connected\n", id);
+}
+
+void
+StatsServer::detach(int id)
+{
+    auto it = clients.find(id);
+    if (it == clients.end())
+        return;
+
+    pollQueue.remove(it->second.event);
+    delete it->second.event;
+    ::close(it->second.fd);
+    clients.erase(it);
+
+    DPRINTF(StatsServer, "client %d disconnected\n", id);
+}
+
+void
+StatsServer::data(int id)
+{
+    auto it = clients.find(id);
+    assert(it != clients.end());
+
+    char buf[1024];
+    ssize_t len = ::read(it->second.fd, buf, sizeof(buf));
+    if (len <= 0) {
+        detach(id);
+        return;
+    }
+
+    string &pending = it->second.pending;
+    pending.append(buf, len);
+
+    // Handle every complete line; the client may be detached by a
+    // request (quit), so look it up again after each one.
+    size_t eol;
+    while ((eol = pending.find('\n')) != string::npos) {
+        string line = pending.substr(0, eol);
+        pending.erase(0, eol + 1);
+        request(id, line);
+
+        it = clients.find(id);
+        if (it == clients.end())
+            return;
+    }
+
+    if (pending.size() > 65536) {
+        reply(id, "error: request too long\n");
+        it->second.pending.clear();
+    }
+}
+
+void
+StatsServer::request(int id, const string &line)
+{
+    vector<string> args;
+    tokenize(args, line, ' ', true);
+    if (args.empty())
+        return;
+
+    string cmd = args[0];
+    args.erase(args.begin());
+    DPRINTF(StatsServer, "client %d: %s\n", id, line);
+
+    if (cmd == "get") {
+        if (args.empty()) {
+            reply(id, "error: get needs at least one pattern\n");
+            return;
+        }
+        // The reply is sent once all event queues reach the snapshot.
+        new SnapshotEvent(*this, id, args);
+    } else if (cmd == "list") {
+        if (args.empty())
+            args.push_back("*");
+
+        stringstream ss;
+        for (auto *info : matching(args))
+            ss << info->name << "\n";
+        reply(id, ss.str());
+    } else if (cmd == "tick") {
+        reply(id, csprintf("%d\n", curTick()));
+    } else if (cmd == "quit") {
+        detach(id);
+    } else {
+        reply(id, csprintf("error: unknown request '%s'\n", cmd));
+    }
+}
+
+void
+StatsServer::reply(int id, const string &text)
+{
+    auto it = clients.find(id);
+    if (it == clients.end())
+        return;
+
+    string msg = text + ".\n";
+    const char *p = msg.data();
+    size_t left = msg.size();
+    while (left > 0) {
+        // MSG_NOSIGNAL: a vanished client must not kill the simulator.
+        ssize_t n = ::send(it->second.fd, p, left, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0) {
+            detach(id);
+            return;
+        }
+        p += n;
+        left -= n;
+    }
+}
+
+void
+StatsServer::snapshot(int id, const vector<string> &patterns)
+{
+    if (clients.find(id) == clients.end())
+        return;
+
+    stringstream ss;
+    ccprintf(ss, "tick %d\n", curTick());
+
+    Text text(ss);
+    for (auto *info : matching(patterns)) {
+        info->prepare();
+        info->visit(text);
+    }
+
+    reply(id, ss.str());
+}
+
+void
+startStatsServer(const string &path)
+{
+    if (server) {
+        warn("Stats server already running on %s.\n",
+             server->socketPath());
+        return;
+    }
+
+    server = new StatsServer(simout.resolve(path));
+    registerExitCallback(
+        new MakeCallback<StatsServer, &StatsServer::close>(server));
+}
+
+} // namespace Stats
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019 Georgia Institute of Technology
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * A live statistics endpoint on a local Unix domain socket.
+ *
+ * External tools connect to the socket and issue line-oriented
+ * requests for snapshots of the statistics database while the
+ * simulation keeps running. Requests are read from the poll queue,
+ * and snapshots are taken from a global event so that every event
+ * queue is quiescent while the values are read. Snapshots never
+ * reset the statistics, so the regular stats dumps are unaffected.
+ *
+ * Protocol (one request per line, every reply ends with a line
+ * holding a single "."):
+ *   get PATTERN...   values of all stats whose names match any glob
+ *   list [PATTERN...] names of matching stats
+ *   tick             the current simulated tick
+ *   quit             close the connection
+ * Errors are reported as a single "error: ..." line before the
+ * terminator.
+ */
+
+#ifndef __SIM_STATS_SERVER_HH__
+#define __SIM_STATS_SERVER_HH__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/pollevent.hh"
+
+namespace Stats {
+
+class StatsServer
+{
+  protected:
+    class ListenEvent : public PollEvent
+    {
+      protected:
+        StatsServer *server;
+
+      public:
+        ListenEvent(StatsServer *s, int fd, int e);
+        void process(int revent);
+    };
+
+    class ClientEvent : public PollEvent
+    {
+      protected:
+        StatsServer *server;
+        int id;
+
+      public:
+        ClientEvent(StatsServer *s, int id, int fd, int e);
+        void process(int revent);
+    };
+
+    struct Client
+    {
+        int fd;
+        ClientEvent *event;
+        /** Partial request line received so far. */
+        std::string pending;
+    };
+
+    friend class ListenEvent;
+    friend class ClientEvent;
+
+    std::string path;
+    int listen_fd;
+    ListenEvent *listenEvent;
+
+    /** Connected clients, keyed by a never-reused id so that a
+     * snapshot outliving its client is simply dropped. */
+    std::map<int, Client> clients;
+    int nextId;
+
+    void accept();
+    void data(int id);
+    void detach(int id);
+    void request(int id, const std::string &line);
+    void reply(int id, const std::string &text);
+
+  public:
+    StatsServer(const std::string &path);
+    ~StatsServer();
+
+    /** Disconnect all clients and remove the socket. */
+    void close();
+
+    const std::string &socketPath() const { return path; }
+
+    /**
+     * Write the current value of every displayed stat matching one of
+     * the patterns to a client. Called from the snapshot event.
+     */
+    void snapshot(int id, const std::vector<std::string> &patterns);
+};
+
+/**
+ * Start the stats server on a Unix domain socket. Unlike the other
+ * listeners it is only started on request, so it does not check
+ * whether listeners have been disabled.
+ * @param path Socket path; relative paths are placed in the output
+ * directory.
+ */
+void startStatsServer(const std::string &path);
+
+} // namespace Stats
+
+#endif // __SIM_STATS_SERVER_HH__
@@ -102,7 +102,10 @@ System::System(Params *p)
 #else
       kvmVM(nullptr),
 #endif
-      physmem(name() + ".physmem", p->memories, p->mmap_using_noreserve),
+      physmem(name() + ".physmem", p->memories, p->mmap_using_noreserve,
+              p->checkpoint_mem_format, p->checkpoint_mem_threads,
+              p->checkpoint_mem_chunk),
+      functionalBackdoor(nullptr),
       memoryMode(p->mem_mode),
       _cacheLineSize(p->cache_line_size),
       workItemsBegin(0),
@@ -407,6 +410,20 @@ System::isMemAddr(Addr addr) const
     return physmem.isMemAddr(addr);
 }
 
+uint8_t *
+System::functionalHostAddr(Addr addr, Addr size) const
+{
+    if (functionalBackdoor) {
+        if (functionalBackdoor->isNull() ||
+            !RangeSize(addr, size).isSubset(
+                functionalBackdoor->getAddrRange()))
+            return nullptr;
+        return functionalBackdoor->toHostAddr(addr);
+    }
+
+    return bypassCaches() ? physmem.hostAddr(addr, size) : nullptr;
+}
+
 void
 System::drainResume()
 {
@@ -75,6 +75,7 @@
 
 #endif
 
+class AbstractMemory;
 class BaseRemoteGDB;
 class KvmVM;
 class ObjectFile;
@@ -281,6 +282,30 @@ class System : public MemObject
      */
     bool isMemAddr(Addr addr) const;
 
+    /**
+     * Register a memory whose backing store holds the authoritative
+     * copy of all data, e.g. the Ruby backing store when Ruby is
+     * configured to access it. Functional accesses to its range may
+     * then bypass the memory system.
+     *
+     * @param mem Memory to use for functional host accesses
+     */
+    void setFunctionalBackdoor(AbstractMemory *mem)
+    { functionalBackdoor = mem; }
+
+    /**
+     * Get a host pointer for a functional access to a block of
+     * physical memory. This only succeeds when no cache can hold a
+     * more recent copy of the block than the backing store, i.e. when
+     * a functional backdoor has been registered or when the caches
+     * are bypassed. Callers fall back to the port otherwise.
+     *
+     * @param addr Physical start address of the block
+     * @param size Size of the block in bytes
+     * @return Pointer into host memory, or nullptr
+     */
+    uint8_t *functionalHostAddr(Addr addr, Addr size) const;
+
     /**
      * Get the architecture.
      */
@@ -307,6 +332,9 @@ class System : public MemObject
 
     PhysicalMemory physmem;
 
+    /** Memory registered for functional host accesses, if any. */
+    AbstractMemory *functionalBackdoor;
+
     Enums::MemoryMode memoryMode;
 
     const unsigned int _cacheLineSize;
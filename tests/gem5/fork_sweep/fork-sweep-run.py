@@ -0,0 +1,111 @@
+# Copyright (c) 2019 Georgia Institute of Technology
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Warm a small garnet2.0 mesh with random traffic, then fork one child
+# per link latency while packets are still in the network. Forking
+# drains the network first, so the children must be able to change the
+# link latency and keep simulating.
+
+from __future__ import print_function
+
+import m5
+from m5.objects import *
+from m5.util import fatal
+import os, optparse, sys
+
+m5.util.addToPath('../../../configs/')
+
+from common import Options
+from network import Network
+from ruby import Ruby
+
+config_path = os.path.dirname(os.path.abspath(__file__))
+config_root = os.path.join(config_path, '../../../configs')
+
+parser = optparse.OptionParser()
+Options.addNoISAOptions(parser)
+Ruby.define_options(parser)
+execfile(os.path.join(config_root, "common", "Options.py"))
+
+(options, args) = parser.parse_args()
+
+options.num_cpus = 4
+options.num_dirs = 4
+options.network = "garnet2.0"
+options.topology = "Mesh_XY"
+options.mesh_rows = 2
+
+warmup = 20000
+sweep = 20000
+
+cpus = [ PyTrafficGen() for i in xrange(options.num_cpus) ]
+
+system = System(cpu = cpus,
+                mem_ranges = [AddrRange(options.mem_size)])
+
+system.voltage_domain = VoltageDomain(voltage = options.sys_voltage)
+system.clk_domain = SrcClockDomain(clock = options.sys_clock,
+                                   voltage_domain = system.voltage_domain)
+
+Ruby.create_system(options, False, system)
+
+system.ruby.clk_domain = SrcClockDomain(clock = options.ruby_clock,
+                                        voltage_domain = system.voltage_domain)
+
+for (i, cpu) in enumerate(cpus):
+    cpu.port = system.ruby._cpu_ports[i].slave
+
+root = Root( full_system = False, system = system )
+root.system.mem_mode = 'timing'
+
+m5.ticks.setGlobalFrequency('1ns')
+m5.disableAllListeners()
+m5.instantiate()
+
+for cpu in cpus:
+    cpu.start([ cpu.createRandom(warmup + sweep, 0, 0x100000, 64, 2, 10,
+                                 50, 0) ])
+
+m5.simulate(warmup)
+
+network = system.ruby.network.getCCObject()
+if network.getPacketsInFlight() == 0:
+    fatal("No packets in flight before forking the sweep")
+
+name, value = m5.forkSweep([ ("lat%d" % l, l) for l in (1, 4) ])
+
+if name is None:
+    failed = [ n for n, s in value.items() if s != 0 ]
+    if failed:
+        fatal("Fork sweep children failed: %s", ", ".join(failed))
+    sys.exit(0)
+
+Network.apply_overrides(options, system.ruby.network,
+                        { "chiplet_link_latency" : value })
+
+exit_event = m5.simulate(sweep)
+print('Exiting @ tick', m5.curTick(), 'because', exit_event.getCause())
+sys.exit(0)
@@ -0,0 +1,109 @@
+#!/usr/bin/env python2.7
+
+# Copyright (c) 2019 Georgia Institute of Technology
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# This script is used to dump protobuf prefetch traces, as captured by
+# the trace_file parameter of the queued prefetchers, to ASCII
+# format. Every line holds one observed access followed by the
+# prefetch candidates generated for it:
+#
+# tick,addr,pc,master_id,flags[,pf_addr:priority]*
+#
+# where the pc is empty if unknown and the flags are a combination of
+# 'w' (write), 'i' (instruction fetch) and 's' (secure).
+
+import os
+import protolib
+import subprocess
+import sys
+
+util_dir = os.path.dirname(os.path.realpath(__file__))
+# Make sure the proto definitions are up to date.
+subprocess.check_call(['make', '--quiet', '-C', util_dir,
+                       'prefetch_trace_pb2.py'])
+import prefetch_trace_pb2
+
+def main():
+    if len(sys.argv) != 3:
+        print "Usage: ", sys.argv[0], " <protobuf input> <ASCII output>"
+        exit(-1)
+
+    # Open the file in read mode
+    proto_in = protolib.openFileRd(sys.argv[1])
+
+    try:
+        ascii_out = open(sys.argv[2], 'w')
+    except IOError:
+        print "Failed to open ", sys.argv[2], " for writing"
+        exit(-1)
+
+    # Read the magic number in 4-byte Little Endian
+    magic_number = proto_in.read(4)
+
+    if magic_number != "gem5":
+        print "Unrecognized file", sys.argv[1]
+        exit(-1)
+
+    print "Parsing prefetch trace header"
+
+    header = prefetch_trace_pb2.PrefetchTraceHeader()
+    protolib.decodeMessage(proto_in, header)
+
+    print "Object id:", header.obj_id
+    print "Tick frequency:", header.tick_freq
+    print "Block size:", header.block_size
+
+    print "Parsing accesses"
+
+    num_accesses = 0
+    num_candidates = 0
+    access = prefetch_trace_pb2.PrefetchTrace()
+
+    # Decode the messages until we hit the end of the file
+    while protolib.decodeMessage(proto_in, access):
+        num_accesses += 1
+        num_candidates += len(access.pf_addr)
+
+        pc = access.pc if access.HasField('pc') else ''
+        flags = ('w' if access.write else '') + \
+                ('i' if access.inst else '') + \
+                ('s' if access.secure else '')
+        ascii_out.write('%s,%s,%s,%s,%s' % (access.tick, access.addr, pc,
+                                            access.master_id, flags))
+        for addr, prio in zip(access.pf_addr, access.pf_priority):
+            ascii_out.write(',%s:%s' % (addr, prio))
+        ascii_out.write('\n')
+
+    print "Parsed accesses:", num_accesses
+    print "Prefetch candidates:", num_candidates
+
+    # We're done
+    ascii_out.close()
+    proto_in.close()
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,267 @@
+# Copyright (c) 2019 Georgia Institute of Technology
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Decoder for binary debug traces written with --debug-format=binary or
+# --debug-format=flight. Prints the messages in the same layout as the
+# text trace, optionally restricted to a tick range, to the objects
+# whose name matches a regular expression and to a set of debug flags.
+#
+# Example:
+#   util/decode_trace.py m5out/trace.bin --start 1000000 --end 2000000 \
+#       --name 'system.ruby.network.routers0[0-9]' --flag RubyNetwork
+
+from __future__ import print_function
+
+import re
+import struct
+import sys
+
+from argparse import ArgumentParser
+
+MAGIC = b"gem5trc1"
+MAX_TICK = 2**64 - 1
+
+# printf conversion as accepted by cprintf: flags, width, precision,
+# length modifiers (ignored by cprintf) and the conversion character
+SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?[hlLqjzt]*"
+                  r"([cdiouxXeEfFgGpsn%])")
+
+try:
+    string_types = (str, unicode)
+except NameError:
+    string_types = (str,)
+
+class TraceError(Exception):
+    pass
+
+class Reader(object):
+    """Iterates over the records of a binary trace file."""
+
+    def __init__(self, stream):
+        self.stream = stream
+        self.strings = { 0 : "" }
+        if self.stream.read(len(MAGIC)) != MAGIC:
+            raise TraceError("not a binary gem5 trace")
+
+    def read(self, fmt):
+        size = struct.calcsize(fmt)
+        data = self.stream.read(size)
+        if len(data) != size:
+            raise TraceError("truncated trace")
+        return struct.unpack(fmt, data)
+
+    def read_string(self):
+        length, = self.read("=I")
+        data = self.stream.read(length)
+        if len(data) != length:
+            raise TraceError("truncated trace")
+        return data.decode("utf-8", "replace")
+
+    def read_args(self):
+        nargs, = self.read("=B")
+        args = []
+        for i in range(nargs):
+            tag = self.stream.read(1)
+            if tag == b"i":
+                args.append(self.read("=q")[0])
+            elif tag == b"u":
+                args.append(self.read("=Q")[0])
+            elif tag == b"d":
+                args.append(self.read("=d")[0])
+            elif tag == b"c":
+                args.append(Char(self.read("=c")[0]))
+            elif tag == b"p":
+                args.append(Pointer(self.read("=Q")[0]))
+            elif tag == b"s":
+                args.append(self.read_string())
+            else:
+                raise TraceError("bad argument tag %r" % tag)
+        return args
+
+    def string(self, sid):
+        try:
+            return self.strings[sid]
+        except KeyError:
+            raise TraceError("undefined string id %d" % sid)
+
+    def __iter__(self):
+        while True:
+            kind = self.stream.read(1)
+            if not kind:
+                return
+            if kind == b"S":
+                sid, = self.read("=I")
+                self.strings[sid] = self.read_string()
+            elif kind == b"M":
+                tick, name, flag, fmt = self.read("=QIII")
+                args = self.read_args()
+                yield (tick, self.string(name), self.string(flag),
+                       self.string(fmt), args)
+            elif kind == b"T":
+                tick, name = self.read("=QI")
+                yield tick, self.string(name), "", None, self.read_string()
+            else:
+                raise TraceError("bad record type %r" % kind)
+
+class Char(object):
+    def __init__(self, byte):
+        self.value = ord(byte)
+
+class Pointer(object):
+    def __init__(self, value):
+        self.value = value
+
+def convert(flags, width, precision, conv, arg):
+    """Format one argument the way cprintf does."""
+    if isinstance(arg, Char):
+        if conv in "cs":
+            arg = chr(arg.value)
+            conv = "s"
+        else:
+            arg = arg.value
+    elif isinstance(arg, Pointer):
+        arg = arg.value
+        if conv in "ps":
+            flags += "#"
+            conv = "x"
+
+    if conv == "p":
+        flags += "#"
+        conv = "x"
+
+    if conv == "c":
+        conv = "s"
+        if not isinstance(arg, string_types):
+            arg = chr(int(arg) & 0xff)
+    elif conv in "diu":
+        conv = "d"
+        if isinstance(arg, string_types):
+            try:
+                arg = int(arg)
+            except ValueError:
+                conv = "s"
+        elif isinstance(arg, float):
+            conv = "g"
+    elif conv in "oxX":
+        if isinstance(arg, string_types):
+            try:
+                arg = int(arg, 0)
+            except ValueError:
+                conv = "s"
+        if isinstance(arg, float):
+            conv = "g"
+        elif conv != "s" and arg < 0:
+            arg &= MAX_TICK
+    elif conv in "eEfFgG":
+        try:
+            arg = float(arg)
+        except ValueError:
+            conv = "s"
+    elif conv == "s":
+        if isinstance(arg, float):
+            conv = "g"
+
+    spec = "%" + flags + width
+    if precision is not None:
+        spec += "." + precision
+    return (spec + conv) % arg
+
+def cformat(fmt, args):
+    args = list(args)
+    out = []
+    pos = 0
+    for m in SPEC.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        flags, width, precision, conv = m.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        if conv == "n":
+            continue
+        if width == "*":
+            width = str(args.pop(0)) if args else ""
+        if precision == "*":
+            precision = str(args.pop(0)) if args else ""
+        if not args:
+            out.append("<missing arg for %s>" % m.group(0))
+            continue
+        out.append(convert(flags, width or "", precision, conv,
+                           args.pop(0)))
+    out.append(fmt[pos:])
+    if args:
+        out.append("<extra arg>")
+    return "".join(out)
+
+def main():
+    parser = ArgumentParser(
+        description="Decode a binary gem5 debug trace")
+    parser.add_argument("trace", help="binary trace file")
+    parser.add_argument("--start", type=int, default=0,
+                        help="first tick to print")
+    parser.add_argument("--end", type=int, default=None,
+                        help="last tick to print")
+    parser.add_argument("--name", default=None,
+                        help="only print objects matching this regex")
+    parser.add_argument("--flag", action="append", default=[],
+                        help="only print messages of this debug flag "
+                             "(may be repeated)")
+    parser.add_argument("-o", "--output", default=None,
+                        help="output file [default: stdout]")
+    args = parser.parse_args()
+
+    name_re = re.compile(args.name) if args.name else None
+    flags = set(args.flag)
+    out = open(args.output, "w") if args.output else sys.stdout
+
+    with open(args.trace, "rb") as f:
+        try:
+            for tick, name, flag, fmt, msg in Reader(f):
+                # Untimed messages (DPRINTFR) are not filtered by tick
+                if tick != MAX_TICK:
+                    if tick < args.start:
+                        continue
+                    if args.end is not None and tick > args.end:
+                        continue
+                if name_re and not name_re.search(name):
+                    continue
+                if flags and flag not in flags:
+                    continue
+
+                if fmt is not None:
+                    msg = cformat(fmt, msg)
+
+                if tick != MAX_TICK:
+                    out.write("%7d: " % tick)
+                if name:
+                    out.write("%s: " % name)
+                out.write(msg)
+        except TraceError as e:
+            print("%s: %s" % (args.trace, e), file=sys.stderr)
+            sys.exit(1)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,154 @@
+# Copyright (c) 2019 Georgia Institute of Technology
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Scaling sweep for parallel simulation: runs
+# configs/example/eventq_scaling.py for a range of partition counts
+# with the fixed and the adaptive quantum, one run at a time so host
+# times are comparable, and writes scaling.csv (plus scaling.png when
+# matplotlib is available) to the output directory.
+#
+# Example:
+#   util/eventq_scaling.py --gem5 build/RISCV/gem5.opt --outdir m5out/scale \
+#       --partitions 1,2,4,8 -- --duty 0.1 --sim-time 2ms
+
+from __future__ import print_function
+
+import csv
+import os
+import re
+import subprocess
+import sys
+
+from argparse import ArgumentParser, REMAINDER
+
+STATS = {
+    'host_seconds' : re.compile(r'^host_seconds\s+(\S+)'),
+    'sim_seconds' : re.compile(r'^sim_seconds\s+(\S+)'),
+    # Summed over the event queues
+    'barrier_wait' :
+        re.compile(r'^\S*eventq_barrier_wait::MainEventQueue-\d+\s+(\S+)'),
+}
+
+def read_stats(path):
+    values = { 'barrier_wait' : 0.0 }
+    with open(path) as stats:
+        for line in stats:
+            if line.startswith('---------- End'):
+                break
+            for name, pattern in STATS.items():
+                m = pattern.match(line)
+                if m:
+                    values[name] = values.get(name, 0.0) + float(m.group(1))
+    return values
+
+def run(args, parts, mode):
+    outdir = os.path.join(args.outdir, '%s.%d' % (mode, parts))
+    if not os.path.isdir(outdir):
+        os.makedirs(outdir)
+    cmd = [args.gem5, '-d', outdir, args.config,
+           '--partitions', str(parts), '--quantum', args.quantum]
+    if mode == 'adaptive':
+        cmd.append('--adaptive-quantum')
+    cmd += args.config_args
+    print("Running", ' '.join(cmd))
+    with open(os.path.join(outdir, 'simout.log'), 'w') as log:
+        if subprocess.call(cmd, stdout=log, stderr=subprocess.STDOUT):
+            sys.exit("%s failed, see %s" % (' '.join(cmd), outdir))
+    return read_stats(os.path.join(outdir, 'stats.txt'))
+
+def plot(rows, path):
+    try:
+        import matplotlib
+        matplotlib.use('Agg')
+        import matplotlib.pyplot as plt
+    except ImportError:
+        print("matplotlib not found, skipping", path)
+        return
+
+    fig, ax = plt.subplots()
+    for mode in sorted(set(r['mode'] for r in rows)):
+        points = sorted((r['partitions'], r['throughput'])
+                        for r in rows if r['mode'] == mode)
+        ax.plot([p for p, _ in points], [t for _, t in points],
+                marker='o', label=mode)
+    ax.set_xlabel('partitions (event queues)')
+    ax.set_ylabel('simulated partition-seconds per host second')
+    ax.legend()
+    fig.savefig(path)
+
+def main():
+    parser = ArgumentParser(description="Parallel simulation scaling")
+    parser.add_argument("--gem5", required=True, help="gem5 binary")
+    parser.add_argument("--config",
+                        default="configs/example/eventq_scaling.py")
+    parser.add_argument("--outdir", required=True)
+    parser.add_argument("--partitions", default="1,2,4,8",
+                        help="comma separated partition counts")
+    parser.add_argument("--modes", default="fixed,adaptive",
+                        help="quantum modes to compare")
+    parser.add_argument("--quantum", default="100ns",
+                        help="quantum, the lookahead in adaptive mode")
+    parser.add_argument("config_args", nargs=REMAINDER,
+                        help="arguments for the config script, after '--'")
+    args = parser.parse_args()
+    if args.config_args and args.config_args[0] == '--':
+        args.config_args = args.config_args[1:]
+
+    modes = args.modes.split(',')
+    for mode in modes:
+        if mode not in ('fixed', 'adaptive'):
+            sys.exit("unknown quantum mode %s" % mode)
+
+    rows = []
+    for parts in [int(p) for p in args.partitions.split(',')]:
+        for mode in modes:
+            stats = run(args, parts, mode)
+            rows.append({
+                'partitions' : parts,
+                'mode' : mode,
+                'host_seconds' : stats['host_seconds'],
+                'sim_seconds' : stats['sim_seconds'],
+                'barrier_wait' : stats['barrier_wait'],
+                'throughput' :
+                    parts * stats['sim_seconds'] / stats['host_seconds'],
+            })
+
+    fields = ['partitions', 'mode', 'host_seconds', 'sim_seconds',
+              'barrier_wait', 'throughput']
+    with open(os.path.join(args.outdir, 'scaling.csv'), 'w') as out:
+        writer = csv.DictWriter(out, fieldnames=fields)
+        writer.writeheader()
+        writer.writerows(rows)
+
+    for row in rows:
+        print("%(partitions)3d %(mode)-8s host %(host_seconds)8.2fs "
+              "barrier wait %(barrier_wait)8.2fs "
+              "throughput %(throughput).3e" % row)
+
+    plot(rows, os.path.join(args.outdir, 'scaling.png'))
+
+if __name__ == '__main__':
+    main()
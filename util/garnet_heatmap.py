@@ -0,0 +1,254 @@
+# Copyright (c) 2019 Georgia Institute of Technology
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Heatmaps of the router and link telemetry that Garnet samples with
+# --network-telemetry. Routers are laid out row major on a grid per
+# chiplet, as the mesh topologies number them, and the time series is
+# split into phases that are shown one after the other, so transient
+# hotspots stand out from the run average.
+#
+# Example:
+#   util/garnet_heatmap.py m5out/telemetry.bin --metric buffered_flits \
+#       --phases 4 --cols 4 --links 10
+
+from __future__ import print_function
+
+import math
+import struct
+import sys
+
+from array import array
+from argparse import ArgumentParser
+
+MAGIC = b"gem5tel1"
+HEADER = "=8sQQIIII"
+NAME = "=24s"
+LINK = "=IIII"
+SHADES = " .:-=+*#%@"
+
+class TelemetryError(Exception):
+    pass
+
+def read_floats(stream, count):
+    values = array("f")
+    data = stream.read(4 * count)
+    if len(data) != 4 * count:
+        raise TelemetryError("truncated telemetry")
+    if hasattr(values, "frombytes"):
+        values.frombytes(data)
+    else:
+        values.fromstring(data)
+    return values
+
+class Telemetry(object):
+    """The series of a telemetry file, one list of values per column."""
+
+    def __init__(self, stream):
+        def read(fmt):
+            size = struct.calcsize(fmt)
+            data = stream.read(size)
+            if len(data) != size:
+                raise TelemetryError("truncated telemetry")
+            return struct.unpack(fmt, data)
+
+        (magic, self.clock_period, self.interval, self.routers,
+         self.num_links, router_metrics, link_metrics) = read(HEADER)
+        if magic != MAGIC:
+            raise TelemetryError("not a Garnet telemetry file")
+
+        def name():
+            return read(NAME)[0].split(b"\0")[0].decode()
+
+        self.router_metrics = [ name() for i in range(router_metrics) ]
+        self.link_metrics = [ name() for i in range(link_metrics) ]
+        self.chiplets = [ read("=i")[0] for i in range(self.routers) ]
+        self.links = [ read(LINK) for i in range(self.num_links) ]
+
+        columns = router_metrics * self.routers + \
+            link_metrics * self.num_links
+        self.ticks = []
+        self.columns = [ array("f") for i in range(columns) ]
+        while True:
+            head = stream.read(4)
+            if not head:
+                break
+            if len(head) != 4:
+                raise TelemetryError("truncated telemetry")
+            rows, = struct.unpack("=I", head)
+            self.ticks.extend(read("=%dQ" % rows))
+            for column in self.columns:
+                column.extend(read_floats(stream, rows))
+
+    def router_series(self, metric, router):
+        index = self.router_metrics.index(metric)
+        return self.columns[index * self.routers + router]
+
+    def link_series(self, metric, link):
+        index = self.link_metrics.index(metric)
+        return self.columns[len(self.router_metrics) * self.routers +
+                            index * self.num_links + link]
+
+def mean(values, start, end):
+    if end <= start:
+        return 0.0
+    return sum(values[start:end]) / float(end - start)
+
+def router_values(tel, metric, start, end):
+    """Mean of a metric per router over samples [start, end). Link
+    metrics are averaged over the links leaving the router."""
+    if metric in tel.router_metrics:
+        return [ mean(tel.router_series(metric, r), start, end)
+                 for r in range(tel.routers) ]
+
+    totals = [ 0.0 ] * tel.routers
+    counts = [ 0 ] * tel.routers
+    for i, (src, dest, interposer, link_id) in enumerate(tel.links):
+        totals[src] += mean(tel.link_series(metric, i), start, end)
+        counts[src] += 1
+    return [ t / c if c else 0.0 for t, c in zip(totals, counts) ]
+
+def print_grids(tel, values, cols, scale, out):
+    chiplets = sorted(set(tel.chiplets))
+    for chiplet in chiplets:
+        routers = [ r for r in range(tel.routers)
+                    if tel.chiplets[r] == chiplet ]
+        width = cols or int(math.ceil(math.sqrt(len(routers))))
+        print("  chiplet %d" % chiplet, file=out)
+        for row in range(0, len(routers), width):
+            cells = []
+            for r in routers[row:row + width]:
+                level = int(values[r] / scale * (len(SHADES) - 1)) \
+                    if scale else 0
+                cells.append("%s%4d %8.3f" %
+                             (SHADES[min(level, len(SHADES) - 1)] * 2, r,
+                              values[r]))
+            print("   " + "  ".join(cells), file=out)
+
+def print_links(tel, metric, start, end, count, out):
+    if metric not in tel.link_metrics:
+        metric = tel.link_metrics[0]
+    ranked = sorted(((mean(tel.link_series(metric, i), start, end), i)
+                     for i in range(tel.num_links)), reverse=True)
+    print("  busiest links by %s (* interposer)" % metric, file=out)
+    for value, i in ranked[:count]:
+        src, dest, interposer, link_id = tel.links[i]
+        print("   %s link %4d  router %4d -> %4d  %8.3f" %
+              ("*" if interposer else " ", link_id, src, dest, value),
+              file=out)
+
+def plot(tel, metric, phases, cols, filename):
+    import matplotlib
+    matplotlib.use("Agg")
+    import matplotlib.pyplot as plt
+
+    chiplets = sorted(set(tel.chiplets))
+    fig, axes = plt.subplots(len(phases), len(chiplets), squeeze=False,
+                             figsize=(3 * len(chiplets), 3 * len(phases)))
+    all_values = [ router_values(tel, metric, s, e) for s, e in phases ]
+    vmax = max(max(v) for v in all_values) or 1.0
+    for p, values in enumerate(all_values):
+        for c, chiplet in enumerate(chiplets):
+            routers = [ r for r in range(tel.routers)
+                        if tel.chiplets[r] == chiplet ]
+            width = cols or int(math.ceil(math.sqrt(len(routers))))
+            height = (len(routers) + width - 1) // width
+            grid = [ [ float("nan") ] * width for i in range(height) ]
+            for i, r in enumerate(routers):
+                grid[i // width][i % width] = values[r]
+            ax = axes[p][c]
+            ax.imshow(grid, vmin=0, vmax=vmax, cmap="hot",
+                      interpolation="nearest")
+            ax.set_title("chiplet %d, phase %d" % (chiplet, p), fontsize=8)
+            ax.set_xticks([])
+            ax.set_yticks([])
+    fig.suptitle(metric)
+    fig.savefig(filename)
+
+def main():
+    parser = ArgumentParser(description="Heatmaps of Garnet telemetry")
+    parser.add_argument("telemetry", help="file written by "
+                        "--network-telemetry")
+    parser.add_argument("--metric", default="buffered_flits",
+                        help="router metric, or link metric averaged over "
+                        "the links leaving each router")
+    parser.add_argument("--phases", type=int, default=1,
+                        help="split the run into this many phases")
+    parser.add_argument("--start", type=int, default=0,
+                        help="ignore samples before this tick")
+    parser.add_argument("--end", type=int, default=2**64 - 1,
+                        help="ignore samples after this tick")
+    parser.add_argument("--cols", type=int, default=0,
+                        help="routers per row, default square grids")
+    parser.add_argument("--links", type=int, default=0, metavar="N",
+                        help="also list the N busiest links per phase")
+    parser.add_argument("--png", default="",
+                        help="draw the heatmaps into this file "
+                        "(needs matplotlib)")
+    args = parser.parse_args()
+
+    try:
+        with open(args.telemetry, "rb") as stream:
+            tel = Telemetry(stream)
+    except (IOError, TelemetryError) as e:
+        sys.exit("%s: %s" % (args.telemetry, e))
+
+    if args.metric not in tel.router_metrics + tel.link_metrics:
+        sys.exit("Unknown metric %s, the file has %s" %
+                 (args.metric, ", ".join(tel.router_metrics +
+                                         tel.link_metrics)))
+
+    first = next((i for i, t in enumerate(tel.ticks) if t >= args.start),
+                 len(tel.ticks))
+    last = next((i for i, t in enumerate(tel.ticks) if t > args.end),
+                len(tel.ticks))
+    if last <= first:
+        sys.exit("No samples between ticks %d and %d" %
+                 (args.start, args.end))
+
+    phases = []
+    count = max(1, min(args.phases, last - first))
+    for p in range(count):
+        phases.append((first + (last - first) * p // count,
+                       first + (last - first) * (p + 1) // count))
+
+    values = [ router_values(tel, args.metric, s, e) for s, e in phases ]
+    scale = max(max(v) for v in values)
+
+    print("%d routers, %d links, %d samples every %d cycles" %
+          (tel.routers, tel.num_links, len(tel.ticks), tel.interval))
+    for (start, end), phase_values in zip(phases, values):
+        print("%s, ticks %d-%d" %
+              (args.metric, tel.ticks[start], tel.ticks[end - 1]))
+        print_grids(tel, phase_values, args.cols, scale, sys.stdout)
+        if args.links and tel.num_links:
+            print_links(tel, args.metric, start, end, args.links,
+                        sys.stdout)
+
+    if args.png:
+        plot(tel, args.metric, phases, args.cols, args.png)
+
+if __name__ == "__main__":
+    main()
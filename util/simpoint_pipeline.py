@@ -0,0 +1,402 @@
+# Copyright (c) 2019 Georgia Institute of Technology
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# End-to-end SimPoint flow built on the existing gem5 support: profile
+# basic block vectors with the SimPoint probe, cluster them in-tree, take
+# one checkpoint per simpoint in a single pass, restore every checkpoint
+# in parallel with a warmup interval, and combine the measured stats
+# using the simpoint weights.
+#
+# The clustering follows SimPoint 3.2: vectors are normalised, randomly
+# projected to a few dimensions, clustered with k-means for every k up to
+# --max-k, and the smallest k whose BIC score reaches 90% of the observed
+# range is picked. Each cluster is represented by the interval closest to
+# its centroid and weighted by its share of the intervals.
+#
+# Example (RISC-V, Ruby and Garnet):
+#   util/simpoint_pipeline.py run --gem5 build/RISCV/gem5.opt \
+#       --config configs/example/se.py --outdir m5out/sp \
+#       --interval 10000000 --warmup 1000000 --cpu-type DerivO3CPU -j 8 \
+#       -- -c bench --ruby --network=garnet2.0 --topology=Mesh_XY ...
+#
+# The stages can also be run on their own with the cluster and aggregate
+# sub-commands.
+
+from __future__ import print_function
+
+import gzip
+import math
+import os
+import random
+import re
+import subprocess
+import sys
+
+from argparse import ArgumentParser, REMAINDER
+from multiprocessing.pool import ThreadPool
+
+# Same layout as the checkpoint names written by takeSimpointCheckpoints()
+# in configs/common/Simulation.py, which also sorts them this way.
+cpt_expr = re.compile(r'cpt\.simpoint_(\d+)_inst_(\d+)' +
+                      r'_weight_([\d\.e\-]+)_interval_(\d+)_warmup_(\d+)')
+
+def read_bbv(filename):
+    """Read a SimPoint profile into one {bb: fraction} dict per interval."""
+    opener = gzip.open if filename.endswith('.gz') else open
+    vectors = []
+    with opener(filename, 'rt') as f:
+        for line in f:
+            if not line.startswith('T'):
+                continue
+            counts = {}
+            for field in line[1:].split():
+                _, bb, count = field.split(':')
+                counts[int(bb)] = float(count)
+            total = sum(counts.values())
+            if total:
+                vectors.append(dict((bb, c / total)
+                                    for bb, c in counts.items()))
+    return vectors
+
+def project(vectors, dims, rng):
+    """Random linear projection of the sparse vectors to dims dimensions.
+    Each basic block gets a row of uniform [-1, 1] weights."""
+    rows = {}
+    projected = []
+    for vec in vectors:
+        point = [0.0] * dims
+        for bb in sorted(vec):
+            row = rows.get(bb)
+            if row is None:
+                row = rows[bb] = [rng.uniform(-1.0, 1.0)
+                                  for _ in range(dims)]
+            frac = vec[bb]
+            for d in range(dims):
+                point[d] += frac * row[d]
+        projected.append(point)
+    return projected
+
+def dist2(a, b):
+    return sum((x - y) * (x - y) for x, y in zip(a, b))
+
+def kmeans(points, k, rng, max_iters):
+    """Lloyd's k-means with furthest-first seeding. Returns the centroids,
+    the assignment of every point and the sum of squared distances."""
+    centroids = [list(rng.choice(points))]
+    nearest = [dist2(p, centroids[0]) for p in points]
+    while len(centroids) < k:
+        far = max(range(len(points)), key=lambda i: nearest[i])
+        centroids.append(list(points[far]))
+        nearest = [min(d, dist2(p, centroids[-1]))
+                   for p, d in zip(points, nearest)]
+
+    assign = None
+    dims = len(points[0])
+    for _ in range(max_iters):
+        new_assign = [min(range(k), key=lambda c: dist2(p, centroids[c]))
+                      for p in points]
+        if new_assign == assign:
+            break
+        assign = new_assign
+        sums = [[0.0] * dims for _ in range(k)]
+        sizes = [0] * k
+        for p, c in zip(points, assign):
+            sizes[c] += 1
+            s = sums[c]
+            for d in range(dims):
+                s[d] += p[d]
+        for c in range(k):
+            if sizes[c]:
+                centroids[c] = [x / sizes[c] for x in sums[c]]
+
+    sse = sum(dist2(p, centroids[c]) for p, c in zip(points, assign))
+    return centroids, assign, sse
+
+def bic(points, k, assign, sse):
+    """BIC of a spherical Gaussian mixture, as used by X-means and
+    SimPoint."""
+    r = float(len(points))
+    dims = len(points[0])
+    if r <= k:
+        return float('-inf')
+    variance = sse / (dims * (r - k))
+    if variance <= 0:
+        return float('inf')
+    sizes = [0] * k
+    for c in assign:
+        sizes[c] += 1
+    likelihood = 0.0
+    for rn in sizes:
+        if rn == 0:
+            continue
+        likelihood += (rn * math.log(rn) - rn * math.log(r) -
+                       rn * dims / 2.0 * math.log(2 * math.pi * variance) -
+                       (rn - 1) * dims / 2.0)
+    params = (k - 1) + k * dims + 1
+    return likelihood - params / 2.0 * math.log(r)
+
+def cluster(vectors, max_k, dims, seeds, sample_size, max_iters, seed):
+    """Pick simpoints for the given interval vectors. Returns a list of
+    (interval, weight) tuples."""
+    rng = random.Random(seed)
+    points = project(vectors, dims, rng)
+
+    # Like SimPoint, cluster a sample of the intervals and then assign
+    # every interval to the closest centroid found.
+    sample = points
+    if sample_size and len(points) > sample_size:
+        sample = rng.sample(points, sample_size)
+
+    runs = []
+    for k in range(1, min(max_k, len(sample)) + 1):
+        best = None
+        for _ in range(seeds):
+            centroids, assign, sse = kmeans(sample, k, rng, max_iters)
+            if best is None or sse < best[2]:
+                best = (centroids, assign, sse)
+        runs.append((k, best[0], bic(sample, k, best[1], best[2])))
+
+    finite = [score for _, _, score in runs if not math.isinf(score)]
+    lo, hi = (min(finite), max(finite)) if finite else (0.0, 0.0)
+    threshold = lo + 0.9 * (hi - lo)
+    # With too few intervals every score can be -inf, so fall back to a
+    # single cluster
+    k, centroids, _ = next((run for run in runs if run[2] >= threshold),
+                           runs[0])
+
+    members = [[] for _ in range(k)]
+    for i, p in enumerate(points):
+        c = min(range(k), key=lambda c: dist2(p, centroids[c]))
+        members[c].append(i)
+
+    simpoints = []
+    for c in range(k):
+        if not members[c]:
+            continue
+        rep = min(members[c], key=lambda i: dist2(points[i], centroids[c]))
+        simpoints.append((rep, len(members[c]) / float(len(points))))
+    return sorted(simpoints)
+
+def write_simpoints(simpoints, simpoint_file, weight_file):
+    with open(simpoint_file, 'w') as sf, open(weight_file, 'w') as wf:
+        for idx, (interval, weight) in enumerate(simpoints):
+            sf.write('%d %d\n' % (interval, idx))
+            wf.write('%f %d\n' % (weight, idx))
+
+def last_stats_dump(filename):
+    """Return the scalar stats of the last dump in a stats.txt file."""
+    stats = {}
+    with open(filename) as f:
+        for line in f:
+            if line.startswith('---------- Begin'):
+                stats = {}
+                continue
+            fields = line.split()
+            if len(fields) < 2 or fields[0].startswith('-'):
+                continue
+            try:
+                stats[fields[0]] = float(fields[1])
+            except ValueError:
+                pass
+    return stats
+
+def checkpoint_weights(cptdir):
+    cpts = sorted(d for d in os.listdir(cptdir) if cpt_expr.match(d))
+    return [float(cpt_expr.match(d).group(3)) for d in cpts]
+
+def aggregate(cptdir, run_dirs, report):
+    """Combine the last stats dump of every restored simpoint, weighting
+    each by its simpoint weight. Stats missing from a run are averaged
+    over the runs that have them."""
+    weights = checkpoint_weights(cptdir)
+    if len(weights) != len(run_dirs):
+        sys.exit("found %d simpoint checkpoints but %d runs" %
+                 (len(weights), len(run_dirs)))
+
+    sums = {}
+    total_weight = {}
+    tpi = []
+    for weight, run_dir in zip(weights, run_dirs):
+        stats = last_stats_dump(os.path.join(run_dir, 'stats.txt'))
+        if stats.get('sim_insts'):
+            stats['ticks_per_inst'] = stats['sim_ticks'] / stats['sim_insts']
+            tpi.append((run_dir, weight, stats['ticks_per_inst']))
+        for name, value in stats.items():
+            if math.isnan(value) or math.isinf(value):
+                continue
+            sums[name] = sums.get(name, 0.0) + weight * value
+            total_weight[name] = total_weight.get(name, 0.0) + weight
+
+    with open(report, 'w') as f:
+        f.write('# Weighted stats over %d simpoints (weights sum to %f)\n' %
+                (len(weights), sum(weights)))
+        for run_dir, weight, value in tpi:
+            f.write('# %-40s weight %f ticks/inst %f\n' %
+                    (os.path.basename(run_dir), weight, value))
+        for name in sorted(sums):
+            f.write('%-60s %20.6f\n' % (name, sums[name] / total_weight[name]))
+
+    print("Weighted stats written to", report)
+    if 'ticks_per_inst' in sums:
+        print("Weighted ticks per instruction: %f" %
+              (sums['ticks_per_inst'] / total_weight['ticks_per_inst']))
+
+def gem5_cmd(args, outdir, extra):
+    return [args.gem5, '-d', outdir, args.config] + args.config_args + extra
+
+def run_gem5(cmd_outdir):
+    cmd, outdir = cmd_outdir
+    if not os.path.isdir(outdir):
+        os.makedirs(outdir)
+    print("Running", ' '.join(cmd))
+    with open(os.path.join(outdir, 'simout.log'), 'w') as log:
+        return subprocess.call(cmd, stdout=log, stderr=subprocess.STDOUT)
+
+def do_cluster(args):
+    vectors = read_bbv(args.bbv)
+    if not vectors:
+        sys.exit("no intervals found in %s" % args.bbv)
+    simpoints = cluster(vectors, args.max_k, args.dims, args.seeds,
+                        args.sample_size, args.max_iters, args.seed)
+    write_simpoints(simpoints, args.simpoints, args.weights)
+    print("%d intervals, %d simpoints" % (len(vectors), len(simpoints)))
+
+def do_aggregate(args):
+    runs = sorted(os.path.join(args.outdir, d)
+                  for d in os.listdir(args.outdir) if d.startswith('run.'))
+    aggregate(os.path.join(args.outdir, 'cpt'), runs,
+              os.path.join(args.outdir, 'simpoint_stats.txt'))
+
+def do_run(args):
+    if args.config_args and args.config_args[0] == '--':
+        args.config_args = args.config_args[1:]
+    outdir = args.outdir
+    profile_dir = os.path.join(outdir, 'profile')
+    cptdir = os.path.join(outdir, 'cpt')
+
+    # 1. Basic block vectors from a functional run
+    bbv = os.path.join(profile_dir, 'simpoint.bb.gz')
+    if not (args.resume and os.path.exists(bbv)):
+        if run_gem5((gem5_cmd(args, profile_dir,
+                              ['--cpu-type=AtomicSimpleCPU',
+                               '--simpoint-profile',
+                               '--simpoint-interval=%d' % args.interval]),
+                     profile_dir)):
+            sys.exit("profiling failed, see %s" % profile_dir)
+
+    # 2. Clustering
+    args.bbv = bbv
+    args.simpoints = os.path.join(outdir, 'simpoints')
+    args.weights = os.path.join(outdir, 'weights')
+    if not (args.resume and os.path.exists(args.weights)):
+        do_cluster(args)
+
+    # 3. All checkpoints in one pass
+    if not (args.resume and os.path.isdir(cptdir) and
+            checkpoint_weights(cptdir)):
+        spec = '%s,%s,%d,%d' % (args.simpoints, args.weights,
+                                args.interval, args.warmup)
+        if run_gem5((gem5_cmd(args, cptdir,
+                              ['--cpu-type=AtomicSimpleCPU',
+                               '--take-simpoint-checkpoints=%s' % spec]),
+                     cptdir)):
+            sys.exit("checkpointing failed, see %s" % cptdir)
+
+    # 4. Detailed simulation of every simpoint, in parallel
+    num_cpts = len(checkpoint_weights(cptdir))
+    jobs = []
+    for i in range(1, num_cpts + 1):
+        run_dir = os.path.join(outdir, 'run.%02d' % i)
+        jobs.append((gem5_cmd(args, run_dir,
+                              ['--cpu-type=%s' % args.cpu_type,
+                               '--restore-with-cpu=%s' % args.cpu_type,
+                               '--checkpoint-dir=%s' % cptdir,
+                               '--restore-simpoint-checkpoint',
+                               '--checkpoint-restore=%d' % i]),
+                     run_dir))
+    pool = ThreadPool(args.jobs)
+    failed = [job[1] for job, status in zip(jobs, pool.map(run_gem5, jobs))
+              if status]
+    pool.close()
+    if failed:
+        sys.exit("simpoint runs failed: %s" % ', '.join(failed))
+
+    # 5. Weighted report
+    aggregate(cptdir, [job[1] for job in jobs],
+              os.path.join(outdir, 'simpoint_stats.txt'))
+
+def add_cluster_options(parser):
+    parser.add_argument("--max-k", type=int, default=30,
+                        help="largest number of clusters tried")
+    parser.add_argument("--dims", type=int, default=15,
+                        help="dimensions after random projection")
+    parser.add_argument("--seeds", type=int, default=3,
+                        help="k-means restarts per k")
+    parser.add_argument("--sample-size", type=int, default=2000,
+                        help="intervals used to fit the clusters (0: all)")
+    parser.add_argument("--max-iters", type=int, default=100,
+                        help="k-means iterations limit")
+    parser.add_argument("--seed", type=int, default=1,
+                        help="random seed for projection and seeding")
+
+if __name__ == "__main__":
+    parser = ArgumentParser(description="SimPoint profiling, clustering, "
+                            "checkpointing and weighted simulation")
+    sub = parser.add_subparsers(dest='command')
+
+    p = sub.add_parser('cluster', help="pick simpoints from a BBV profile")
+    p.add_argument("bbv", help="simpoint.bb.gz from --simpoint-profile")
+    p.add_argument("--simpoints", default="simpoints")
+    p.add_argument("--weights", default="weights")
+    add_cluster_options(p)
+    p.set_defaults(func=do_cluster)
+
+    p = sub.add_parser('aggregate',
+                       help="combine the runs of an earlier 'run'")
+    p.add_argument("--outdir", required=True)
+    p.set_defaults(func=do_aggregate)
+
+    p = sub.add_parser('run', help="the whole flow")
+    p.add_argument("--gem5", required=True, help="gem5 binary")
+    p.add_argument("--config", default="configs/example/se.py")
+    p.add_argument("--outdir", required=True)
+    p.add_argument("--interval", type=int, default=10000000,
+                   help="simpoint interval in instructions")
+    p.add_argument("--warmup", type=int, default=1000000,
+                   help="detailed warmup before each simpoint")
+    p.add_argument("--cpu-type", default="DerivO3CPU",
+                   help="cpu used for the simpoint runs")
+    p.add_argument("-j", "--jobs", type=int, default=1,
+                   help="simpoint runs in parallel")
+    p.add_argument("--resume", action="store_true",
+                   help="skip stages whose output already exists")
+    add_cluster_options(p)
+    p.add_argument("config_args", nargs=REMAINDER,
+                   help="arguments for the config script, after '--'")
+    p.set_defaults(func=do_run)
+
+    args = parser.parse_args()
+    args.func(args)
@@ -0,0 +1,125 @@
+# Copyright (c) 2019 Georgia Institute of Technology
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+# Query a running simulation's stats server (see --stats-server). The
+# server answers from a global event, so every snapshot is consistent
+# across event queues, and it never resets the statistics.
+#
+# Examples:
+#   util/stats_client.py m5out/stats.sock 'system.cpu*.ipc'
+#   util/stats_client.py m5out/stats.sock --list 'system.ruby.*'
+#   util/stats_client.py m5out/stats.sock --watch 5 sim_ticks 'system.*.numCycles'
+
+from __future__ import print_function
+
+import socket
+import sys
+import time
+
+from argparse import ArgumentParser
+
+class StatsClient(object):
+    """A connection to a stats server."""
+
+    def __init__(self, path):
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.connect(path)
+        self.stream = self.sock.makefile("r")
+
+    def request(self, line):
+        """Send one request and return the lines of its reply."""
+        self.sock.sendall((line + "\n").encode())
+        lines = []
+        while True:
+            reply = self.stream.readline()
+            if not reply:
+                raise IOError("stats server closed the connection")
+            reply = reply.rstrip("\n")
+            if reply == ".":
+                break
+            lines.append(reply)
+        if lines and lines[-1].startswith("error: "):
+            raise ValueError(lines[-1][len("error: "):])
+        return lines
+
+    def get(self, patterns):
+        return self.request("get " + " ".join(patterns))
+
+    def list(self, patterns):
+        return self.request("list " + " ".join(patterns))
+
+    def tick(self):
+        return int(self.request("tick")[0])
+
+    def close(self):
+        try:
+            self.sock.sendall(b"quit\n")
+        except socket.error:
+            pass
+        self.sock.close()
+
+def main():
+    parser = ArgumentParser(description="Query a running gem5 stats server.")
+    parser.add_argument("socket", help="stats server socket")
+    parser.add_argument("patterns", nargs="*", default=[],
+                        help="glob patterns of stat names [default: *]")
+    parser.add_argument("--list", action="store_true",
+                        help="only list the names of matching stats")
+    parser.add_argument("--watch", type=float, metavar="SECONDS",
+                        help="repeat the query every SECONDS")
+    # Patterns may also follow the options.
+    args, extra = parser.parse_known_args()
+    unknown = [ arg for arg in extra if arg.startswith("-") ]
+    if unknown:
+        parser.error("unrecognized arguments: %s" % " ".join(unknown))
+    patterns = (args.patterns + extra) or ["*"]
+
+    try:
+        client = StatsClient(args.socket)
+    except socket.error as e:
+        sys.exit("%s: %s" % (args.socket, e))
+
+    try:
+        while True:
+            if args.list:
+                lines = client.list(patterns)
+            else:
+                lines = client.get(patterns)
+            print("\n".join(lines))
+            sys.stdout.flush()
+            if args.watch is None:
+                break
+            time.sleep(args.watch)
+    except ValueError as e:
+        sys.exit("error: %s" % e)
+    except (IOError, KeyboardInterrupt) as e:
+        if not isinstance(e, KeyboardInterrupt):
+            sys.exit(str(e))
+    finally:
+        client.close()
+
+if __name__ == "__main__":
+    main()
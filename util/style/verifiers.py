@@ -460,6 +460,100 @@ class BoolCompare(LineVerifier):
                               "comparisons with false/False.\n")
         return line
 
+class EagerTrace(Verifier):
+    """Check for trace arguments built outside of DPRINTF
+
+    Strings built only to be passed to a DPRINTF are built on every
+    call, even when the debug flag is off and the DPRINTF does nothing.
+    Build them in the DPRINTF arguments instead (see Trace::lazy()), or
+    guard the code with DTRACE().
+    """
+
+    languages = set(('C', 'C++'))
+    test_name = 'eagerly built trace argument'
+    opt_name = 'eagertrace'
+
+    decl = re.compile(r'^(\s*)(?:std::)?(?:o?stringstream|string)\s+(\w+)'
+                      r'\s*(?:;|=|\()')
+    trace = re.compile(r'\bD(?:PRINTF[SRN]*|DUMP)\s*\(')
+    guard = re.compile(r'\bDTRACE\s*\(')
+
+    def _trace_lines(self, lines):
+        """Lines covered by the argument lists of trace macros"""
+        covered = set()
+        for num, line in enumerate(lines):
+            m = self.trace.search(line)
+            if not m:
+                continue
+            depth = 0
+            end = num
+            text = line[m.end() - 1:]
+            while True:
+                depth += text.count('(') - text.count(')')
+                if depth <= 0 or end + 1 >= len(lines):
+                    break
+                end += 1
+                text = lines[end]
+            covered.update(range(num, end + 1))
+        return covered
+
+    def _guarded(self, lines, num, indent):
+        # Look for an enclosing 'if (DTRACE(...))' a few lines up
+        for prev in range(num - 1, max(num - 6, -1), -1):
+            line = lines[prev]
+            if not line.strip():
+                continue
+            prev_indent = len(line) - len(line.lstrip())
+            if prev_indent < len(indent) and self.guard.search(line):
+                return True
+        return False
+
+    def _eager(self, lines, traced, num, indent, name):
+        use = re.compile(r'\b%s\b' % name)
+        append = re.compile(r'^\s*%s\s*<<' % name)
+        in_trace = False
+        for later in range(num + 1, len(lines)):
+            line = lines[later]
+            if line.strip() and \
+               len(line) - len(line.lstrip()) < len(indent):
+                break # end of the enclosing block
+            if not use.search(line) or append.search(line):
+                continue
+            if later not in traced:
+                return False
+            in_trace = True
+        return in_trace
+
+    def check(self, filename, regions=all_regions, fobj=None, silent=False):
+        close = False
+        if fobj is None:
+            fobj = self.open(filename, 'r')
+            close = True
+        lines = [ l.rstrip('\n') for l in fobj ]
+        if close:
+            fobj.close()
+
+        traced = self._trace_lines(lines)
+        errors = 0
+        for num, line in enumerate(lines):
+            if num not in regions:
+                continue
+            m = self.decl.match(line)
+            if not m or num in traced:
+                continue
+            indent, name = m.groups()
+            if self._eager(lines, traced, num, indent, name) and \
+               not self._guarded(lines, num, indent):
+                if not silent:
+                    self.ui.write("invalid %s in %s:%d (%s)\n" % \
+                                  (self.test_name, filename, num + 1, name))
+                errors += 1
+        return errors
+
+    def fix(self, filename, regions=all_regions):
+        self.ui.write("Warning: cannot automatically fix trace arguments "
+                      "built outside of DPRINTF in %s.\n" % filename)
+
 def is_verifier(cls):
     """Determine if a class is a Verifier that can be instantiated"""
 